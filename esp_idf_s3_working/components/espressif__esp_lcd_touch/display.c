@@ -3,6 +3,8 @@
  * SPDX-License-Identifier: CC0-1.0
  */
 
+#include "display.h"
+
 #define I2C_MASTER_SCL_IO           9       /*!< GPIO number used for I2C master clock */
 #define I2C_MASTER_SDA_IO           8       /*!< GPIO number used for I2C master data  */
 #define I2C_MASTER_NUM              0       /*!< I2C master i2c port number, the number of i2c peripheral interfaces available will depend on the chip */
@@ -61,8 +63,28 @@ static const char *TAG = "example";
 #define EXAMPLE_LVGL_TASK_STACK_SIZE   (4 * 1024)
 #define EXAMPLE_LVGL_TASK_PRIORITY     2
 
+#define TOUCH_RESET_HOLD_MS            100
+#define TOUCH_RESET_BOOT_MS            200
+#define TOUCH_RESET_POLL_MS            10
+
 static SemaphoreHandle_t lvgl_mux = NULL;
 
+// GT911 bring-up runs as a timer-driven state machine so the reset delays
+// don't stall panel, LVGL and CAN start-up. Only the GPIO step runs in the
+// esp_timer task; the I2C steps and the LVGL registration run from an
+// lv_timer in the LVGL task, which may block and already holds the LVGL lock.
+typedef enum {
+    TOUCH_RESET_EXPANDER_LOW,   // 0x2C written to the IO expander, hold reset
+    TOUCH_RESET_INT_LOW,        // INT (GPIO4) pulled low to select the I2C address
+    TOUCH_RESET_RELEASE,        // 0x2E written, waiting for the GT911 to boot
+    TOUCH_RESET_DONE,
+} touch_reset_state_t;
+
+static esp_timer_handle_t touch_reset_timer = NULL;
+static volatile touch_reset_state_t touch_reset_state = TOUCH_RESET_EXPANDER_LOW;
+static int64_t touch_reset_start_us = 0;
+static volatile int64_t touch_reset_step_us = 0;    // Entry time of the current state
+
 // we use two semaphores to sync the VSYNC event and the LVGL task, to avoid potential tearing effect
 #if CONFIG_EXAMPLE_AVOID_TEAR_EFFECT_WITH_SEM
 SemaphoreHandle_t sem_vsync_end;
@@ -70,6 +92,10 @@ SemaphoreHandle_t sem_gui_ready;
 #endif
 
 extern void example_lvgl_demo_ui(lv_disp_t *disp);
+extern uint32_t ui_gauge_arc_take_invalidated_px(void);
+
+// Cumulative frame counters for the performance HUD (plain increments, read lock-free)
+static display_frame_stats_t frame_stats;
 
 static bool example_on_vsync_event(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *event_data, void *user_data)
 {
@@ -89,13 +115,59 @@ static void example_lvgl_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_
     int offsetx2 = area->x2;
     int offsety1 = area->y1;
     int offsety2 = area->y2;
+    uint32_t start_us = (uint32_t)esp_timer_get_time();
 #if CONFIG_EXAMPLE_AVOID_TEAR_EFFECT_WITH_SEM
     xSemaphoreGive(sem_gui_ready);
     xSemaphoreTake(sem_vsync_end, portMAX_DELAY);
+    frame_stats.vsync_wait_us += (uint32_t)esp_timer_get_time() - start_us;
 #endif
     // pass the draw buffer to the driver
     esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, color_map);
     lv_disp_flush_ready(drv);
+    frame_stats.flush_us += (uint32_t)esp_timer_get_time() - start_us;
+}
+
+void display_get_frame_stats(display_frame_stats_t *out)
+{
+    *out = frame_stats;
+}
+
+// Called by LVGL after every refresh: feeds the HUD counters and, with the
+// perf monitor enabled, logs how many pixels each refresh actually redraws
+// and how much of that the gauge arcs asked for
+static void example_lvgl_monitor_cb(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+    frame_stats.frames++;
+    frame_stats.refresh_ms += time_ms;
+
+#if CONFIG_LV_USE_PERF_MONITOR
+    static uint32_t frames = 0;
+    static uint64_t px_sum = 0;
+    static uint64_t gauge_px_sum = 0;
+    static uint32_t time_sum = 0;
+    static int64_t last_report_us = 0;
+
+    frames++;
+    px_sum += px;
+    // Sector areas invalidated since the last refresh, i.e. rendered by this one
+    gauge_px_sum += ui_gauge_arc_take_invalidated_px();
+    time_sum += time_ms;
+
+    int64_t now = esp_timer_get_time();
+    if (now - last_report_us >= 1000 * 1000) {
+        uint32_t avg_px = px_sum / frames;
+        // Gauge areas can overlap other invalidations, so the share is an upper bound
+        uint32_t gauge_pct = px_sum ? (uint32_t)(gauge_px_sum * 100 / px_sum) : 0;
+        ESP_LOGI(TAG, "Refresh: %lu frames, %lu px/frame (%lu%% of screen), gauges %lu%% of redrawn px, %lu ms/frame",
+                 frames, avg_px, avg_px * 100 / (EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES),
+                 gauge_pct, time_sum / frames);
+        frames = 0;
+        px_sum = 0;
+        gauge_px_sum = 0;
+        time_sum = 0;
+        last_report_us = now;
+    }
+#endif
 }
 
 static void example_increase_lvgl_tick(void *arg)
@@ -195,6 +267,122 @@ static void example_lvgl_touch_cb(lv_indev_drv_t * drv, lv_indev_data_t * data)
         data->state = LV_INDEV_STATE_REL;
     }
 }
+// Called from the LVGL task with the LVGL lock held
+static esp_err_t touch_register(lv_disp_t *disp)
+{
+    esp_lcd_touch_handle_t tp = NULL;
+    esp_lcd_panel_io_handle_t tp_io_handle = NULL;
+
+    esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_GT911_CONFIG();
+
+    ESP_LOGI(TAG, "Initialize touch IO (I2C)");
+    /* Touch IO handle */
+    esp_err_t err = esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)I2C_MASTER_NUM, &tp_io_config, &tp_io_handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    esp_lcd_touch_config_t tp_cfg = {
+        .x_max = EXAMPLE_LCD_V_RES,
+        .y_max = EXAMPLE_LCD_H_RES,
+        .rst_gpio_num = -1,
+        .int_gpio_num = -1,
+        .flags = {
+            .swap_xy = 0,
+            .mirror_x = 0,
+            .mirror_y = 0,
+        },
+    };
+    /* Initialize touch */
+    ESP_LOGI(TAG, "Initialize touch controller GT911");
+    err = esp_lcd_touch_new_i2c_gt911(tp_io_handle, &tp_cfg, &tp);
+    if (err != ESP_OK) {
+        esp_lcd_panel_io_del(tp_io_handle);
+        return err;
+    }
+
+    static lv_indev_drv_t indev_drv;    // Input device driver (Touch)
+    lv_indev_drv_init(&indev_drv);
+    indev_drv.type = LV_INDEV_TYPE_POINTER;
+    indev_drv.disp = disp;
+    indev_drv.read_cb = example_lvgl_touch_cb;
+    indev_drv.user_data = tp;
+    lv_indev_drv_register(&indev_drv);
+    return ESP_OK;
+}
+
+// esp_timer callback: GPIO only, nothing here may block the esp_timer task
+static void touch_reset_step(void *arg)
+{
+    gpio_set_level(GPIO_INPUT_IO_4, 0);
+    touch_reset_step_us = esp_timer_get_time();
+    touch_reset_state = TOUCH_RESET_INT_LOW;
+}
+
+// lv_timer callback (LVGL task): the I2C steps, then registration with LVGL
+static void touch_reset_poll(lv_timer_t *timer)
+{
+    int64_t now = esp_timer_get_time();
+    uint8_t write_buf;
+    esp_err_t err;
+
+    switch (touch_reset_state) {
+    case TOUCH_RESET_INT_LOW:
+        if (now - touch_reset_step_us < TOUCH_RESET_HOLD_MS * 1000) {
+            break;
+        }
+        write_buf = 0x2E;
+        err = i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Touch reset release failed: %s", esp_err_to_name(err));
+        }
+        touch_reset_step_us = now;
+        touch_reset_state = TOUCH_RESET_RELEASE;
+        break;
+
+    case TOUCH_RESET_RELEASE:
+        if (now - touch_reset_step_us < TOUCH_RESET_BOOT_MS * 1000) {
+            break;
+        }
+        err = touch_register((lv_disp_t *)timer->user_data);
+        if (err == ESP_OK) {
+            ESP_LOGI(TAG, "Touch ready %lld ms after reset start", (now - touch_reset_start_us) / 1000);
+        } else {
+            ESP_LOGE(TAG, "Touch init failed, running without touch: %s", esp_err_to_name(err));
+        }
+        touch_reset_state = TOUCH_RESET_DONE;
+        lv_timer_del(timer);
+        break;
+
+    case TOUCH_RESET_EXPANDER_LOW:     // Hold not over yet, the esp_timer moves on
+    case TOUCH_RESET_DONE:
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Start the GT911 reset sequence; touch_reset_poll() completes it and registers touch with LVGL
+ */
+static void touch_reset_start(void)
+{
+    const esp_timer_create_args_t touch_reset_timer_args = {
+        .callback = &touch_reset_step,
+        .name = "touch_reset"
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&touch_reset_timer_args, &touch_reset_timer));
+
+    uint8_t write_buf = 0x01;
+    i2c_master_write_to_device(I2C_MASTER_NUM, 0x24, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+
+    //Reset the touch screen. It is recommended that you reset the touch screen before using it.
+    write_buf = 0x2C;
+    i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+
+    touch_reset_start_us = esp_timer_get_time();
+    touch_reset_state = TOUCH_RESET_EXPANDER_LOW;
+    ESP_ERROR_CHECK(esp_timer_start_once(touch_reset_timer, TOUCH_RESET_HOLD_MS * 1000));
+}
+
 void display(void)
 {
     static lv_disp_draw_buf_t disp_buf; // contains internal graphic buffer(s) called draw buffer(s)
@@ -217,6 +405,12 @@ void display(void)
     ESP_ERROR_CHECK(gpio_config(&bk_gpio_config));
 #endif
 
+    // Kick off the touch reset first so its delays overlap panel and LVGL init
+    ESP_ERROR_CHECK(i2c_master_init());
+    ESP_LOGI(TAG, "I2C initialized successfully");
+    gpio_init();
+    touch_reset_start();
+
     ESP_LOGI(TAG, "Install RGB LCD panel driver");
     esp_lcd_panel_handle_t panel_handle = NULL;
     esp_lcd_rgb_panel_config_t panel_config = {
@@ -282,50 +476,6 @@ void display(void)
     gpio_set_level(EXAMPLE_PIN_NUM_BK_LIGHT, EXAMPLE_LCD_BK_LIGHT_ON_LEVEL);
 #endif
 
-    ESP_ERROR_CHECK(i2c_master_init());
-    ESP_LOGI(TAG, "I2C initialized successfully");
-    gpio_init();
-
-    uint8_t write_buf = 0x01;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x24, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-
-    //Reset the touch screen. It is recommended that you reset the touch screen before using it.
-    write_buf = 0x2C;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    esp_rom_delay_us(100 * 1000);
-
-    gpio_set_level(GPIO_INPUT_IO_4,0);
-    esp_rom_delay_us(100 * 1000);
-
-    write_buf = 0x2E;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    esp_rom_delay_us(200 * 1000);
-
-    esp_lcd_touch_handle_t tp = NULL;
-    esp_lcd_panel_io_handle_t tp_io_handle = NULL;
-
-    ESP_LOGI(TAG, "Initialize I2C");
-
-    esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_GT911_CONFIG();
-
-    ESP_LOGI(TAG, "Initialize touch IO (I2C)");
-    /* Touch IO handle */
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)I2C_MASTER_NUM, &tp_io_config, &tp_io_handle));
-    esp_lcd_touch_config_t tp_cfg = {
-        .x_max = EXAMPLE_LCD_V_RES,
-        .y_max = EXAMPLE_LCD_H_RES,
-        .rst_gpio_num = -1,
-        .int_gpio_num = -1,
-        .flags = {
-            .swap_xy = 0,
-            .mirror_x = 0,
-            .mirror_y = 0,
-        },
-    };
-    /* Initialize touch */
-    ESP_LOGI(TAG, "Initialize touch controller GT911");
-    ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_gt911(tp_io_handle, &tp_cfg, &tp));
-
     ESP_LOGI(TAG, "Initialize LVGL library");
     lv_init();
     void *buf1 = NULL;
@@ -350,6 +500,7 @@ void display(void)
     disp_drv.flush_cb = example_lvgl_flush_cb;
     disp_drv.draw_buf = &disp_buf;
     disp_drv.user_data = panel_handle;
+    disp_drv.monitor_cb = example_lvgl_monitor_cb;
 #if CONFIG_EXAMPLE_DOUBLE_FB
     disp_drv.full_refresh = true; // the full_refresh mode can maintain the synchronization between the two frame buffers
 #endif
@@ -362,21 +513,14 @@ void display(void)
         .name = "lvgl_tick"
     };
 
-    static lv_indev_drv_t indev_drv;    // Input device driver (Touch)
-    lv_indev_drv_init(&indev_drv);
-    indev_drv.type = LV_INDEV_TYPE_POINTER;
-    indev_drv.disp = disp;
-    indev_drv.read_cb = example_lvgl_touch_cb;
-    indev_drv.user_data = tp;
-
-    lv_indev_drv_register(&indev_drv);
-
     esp_timer_handle_t lvgl_tick_timer = NULL;
     ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
     ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, EXAMPLE_LVGL_TICK_PERIOD_MS * 1000));
 
     lvgl_mux = xSemaphoreCreateRecursiveMutex();
     assert(lvgl_mux);
+    // Touch registers itself once its reset sequence has finished
+    lv_timer_create(touch_reset_poll, TOUCH_RESET_POLL_MS, disp);
     ESP_LOGI(TAG, "Create LVGL task");
     xTaskCreate(example_lvgl_port_task, "LVGL", EXAMPLE_LVGL_TASK_STACK_SIZE, NULL, EXAMPLE_LVGL_TASK_PRIORITY, NULL);
 
@@ -5,8 +5,22 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include <stdint.h>
+
+// Cumulative frame counters; diff two reads for per-frame averages
+typedef struct {
+    uint32_t frames;            // LVGL refreshes completed
+    uint32_t refresh_ms;        // Sum of refresh times (render + flush)
+    uint32_t flush_us;          // Sum of time spent in flush_cb, incl. VSYNC wait
+    uint32_t vsync_wait_us;     // Part of flush_us spent waiting for VSYNC
+} display_frame_stats_t;
+
 void display(void);
 
+// Copy the frame counters
+void display_get_frame_stats(display_frame_stats_t *out);
+
 #ifdef __cplusplus
 }
 #endif
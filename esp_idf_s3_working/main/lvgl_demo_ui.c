@@ -3,39 +3,55 @@
  * Animated gauges for ESP32-S3-Touch-LCD-7
  */
 
+#include "sdkconfig.h"
 #include "lvgl.h"
 #include "esp_log.h"
+#include "ui_gauge_arc.h"
+#include "ui_gauge_cache.h"
 #include <math.h>
 
 static const char *TAG = "LVGL_UI";
 
-/* Gauge objects */
-static lv_obj_t *arc_map;
-static lv_obj_t *arc_wastegate;
-static lv_obj_t *arc_tps;
-static lv_obj_t *arc_rpm;
-static lv_obj_t *arc_boost;
-static lv_obj_t *led_tcu;
+/* Gauge configuration, indexed like gauges[] */
+typedef struct {
+    const char *title;
+    const char *unit;
+    uint32_t color;
+    int32_t min_val;
+    int32_t max_val;
+    int x;
+    int y;
+    int32_t anim_from;
+    int32_t anim_to;
+    uint32_t anim_time;
+} gauge_config_t;
 
-static lv_obj_t *label_map_value;
-static lv_obj_t *label_wastegate_value;
-static lv_obj_t *label_tps_value;
-static lv_obj_t *label_rpm_value;
-static lv_obj_t *label_boost_value;
-static lv_obj_t *label_tcu_status;
+enum { GAUGE_MAP, GAUGE_WASTEGATE, GAUGE_TPS, GAUGE_RPM, GAUGE_BOOST, GAUGE_COUNT };
+
+static const gauge_config_t gauge_configs[GAUGE_COUNT] = {
+    [GAUGE_MAP]       = {"MAP Pressure", "kPa", 0x00D4FF, 100, 250, 0, 0, 100, 250, 3000},
+    [GAUGE_WASTEGATE] = {"Wastegate", "%", 0x00FF88, 0, 100, 267, 0, 0, 100, 2500},
+    [GAUGE_TPS]       = {"TPS Position", "%", 0xFFD700, 0, 100, 534, 0, 0, 100, 2000},
+    [GAUGE_RPM]       = {"Engine RPM", "RPM", 0xFF6B35, 0, 7000, 0, 240, 800, 6500, 4000},
+    [GAUGE_BOOST]     = {"Target Boost", "kPa", 0xFFD700, 100, 250, 267, 240, 100, 250, 3500},
+};
 
-/* Animation values */
-static lv_anim_t anim_map;
-static lv_anim_t anim_wastegate;
-static lv_anim_t anim_tps;
-static lv_anim_t anim_rpm;
-static lv_anim_t anim_boost;
+/* Gauge registry: object handles and last rendered value */
+typedef struct {
+    lv_obj_t *arc;
+    lv_obj_t *label_value;
+    int32_t last_value;
+} gauge_t;
+
+static gauge_t gauges[GAUGE_COUNT];
+static lv_anim_t gauge_anims[GAUGE_COUNT];
+
+static lv_obj_t *led_tcu;
+static lv_obj_t *label_tcu_status;
 
 /* Forward declarations */
-static void anim_set_value(void *obj, int32_t value);
-static void create_gauge(lv_obj_t *parent, lv_obj_t **arc, lv_obj_t **label_value, 
-                        const char *title, const char *unit, lv_color_t color,
-                        int32_t min_val, int32_t max_val, int x, int y);
+static void anim_set_value(void *var, int32_t value);
+static void create_gauge(lv_obj_t *parent, gauge_t *gauge, const gauge_config_t *cfg);
 
 void example_lvgl_demo_ui(lv_disp_t *disp)
 {
@@ -45,20 +61,9 @@ void example_lvgl_demo_ui(lv_disp_t *disp)
     ESP_LOGI(TAG, "Creating ECU Dashboard with 6 gauges");
     
     /* Create gauges in 3x2 grid */
-    create_gauge(scr, &arc_map, &label_map_value, "MAP Pressure", "kPa", 
-                 lv_color_hex(0x00D4FF), 100, 250, 0, 0);
-    
-    create_gauge(scr, &arc_wastegate, &label_wastegate_value, "Wastegate", "%", 
-                 lv_color_hex(0x00FF88), 0, 100, 267, 0);
-    
-    create_gauge(scr, &arc_tps, &label_tps_value, "TPS Position", "%", 
-                 lv_color_hex(0xFFD700), 0, 100, 534, 0);
-    
-    create_gauge(scr, &arc_rpm, &label_rpm_value, "Engine RPM", "RPM", 
-                 lv_color_hex(0xFF6B35), 0, 7000, 0, 240);
-    
-    create_gauge(scr, &arc_boost, &label_boost_value, "Target Boost", "kPa", 
-                 lv_color_hex(0xFFD700), 100, 250, 267, 240);
+    for (int i = 0; i < GAUGE_COUNT; i++) {
+        create_gauge(scr, &gauges[i], &gauge_configs[i]);
+    }
     
     /* TCU Status indicator */
     lv_obj_t *tcu_cont = lv_obj_create(scr);
@@ -88,65 +93,30 @@ void example_lvgl_demo_ui(lv_disp_t *disp)
     /* Setup animations */
     ESP_LOGI(TAG, "Starting gauge animations");
     
-    /* MAP animation */
-    lv_anim_init(&anim_map);
-    lv_anim_set_var(&anim_map, arc_map);
-    lv_anim_set_values(&anim_map, 100, 250);
-    lv_anim_set_time(&anim_map, 3000);
-    lv_anim_set_playback_time(&anim_map, 3000);
-    lv_anim_set_repeat_count(&anim_map, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_exec_cb(&anim_map, anim_set_value);
-    lv_anim_start(&anim_map);
-    
-    /* Wastegate animation */
-    lv_anim_init(&anim_wastegate);
-    lv_anim_set_var(&anim_wastegate, arc_wastegate);
-    lv_anim_set_values(&anim_wastegate, 0, 100);
-    lv_anim_set_time(&anim_wastegate, 2500);
-    lv_anim_set_playback_time(&anim_wastegate, 2500);
-    lv_anim_set_repeat_count(&anim_wastegate, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_exec_cb(&anim_wastegate, anim_set_value);
-    lv_anim_start(&anim_wastegate);
-    
-    /* TPS animation */
-    lv_anim_init(&anim_tps);
-    lv_anim_set_var(&anim_tps, arc_tps);
-    lv_anim_set_values(&anim_tps, 0, 100);
-    lv_anim_set_time(&anim_tps, 2000);
-    lv_anim_set_playback_time(&anim_tps, 2000);
-    lv_anim_set_repeat_count(&anim_tps, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_exec_cb(&anim_tps, anim_set_value);
-    lv_anim_start(&anim_tps);
-    
-    /* RPM animation */
-    lv_anim_init(&anim_rpm);
-    lv_anim_set_var(&anim_rpm, arc_rpm);
-    lv_anim_set_values(&anim_rpm, 800, 6500);
-    lv_anim_set_time(&anim_rpm, 4000);
-    lv_anim_set_playback_time(&anim_rpm, 4000);
-    lv_anim_set_repeat_count(&anim_rpm, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_exec_cb(&anim_rpm, anim_set_value);
-    lv_anim_start(&anim_rpm);
-    
-    /* Boost animation */
-    lv_anim_init(&anim_boost);
-    lv_anim_set_var(&anim_boost, arc_boost);
-    lv_anim_set_values(&anim_boost, 100, 250);
-    lv_anim_set_time(&anim_boost, 3500);
-    lv_anim_set_playback_time(&anim_boost, 3500);
-    lv_anim_set_repeat_count(&anim_boost, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_exec_cb(&anim_boost, anim_set_value);
-    lv_anim_start(&anim_boost);
+    for (int i = 0; i < GAUGE_COUNT; i++) {
+        const gauge_config_t *cfg = &gauge_configs[i];
+        lv_anim_t *a = &gauge_anims[i];
+        lv_anim_init(a);
+        lv_anim_set_var(a, &gauges[i]);
+        lv_anim_set_values(a, cfg->anim_from, cfg->anim_to);
+        lv_anim_set_time(a, cfg->anim_time);
+        lv_anim_set_playback_time(a, cfg->anim_time);
+        lv_anim_set_repeat_count(a, LV_ANIM_REPEAT_INFINITE);
+        lv_anim_set_exec_cb(a, anim_set_value);
+        lv_anim_start(a);
+    }
 }
 
-static void create_gauge(lv_obj_t *parent, lv_obj_t **arc, lv_obj_t **label_value, 
-                        const char *title, const char *unit, lv_color_t color,
-                        int32_t min_val, int32_t max_val, int x, int y)
+static void create_gauge(lv_obj_t *parent, gauge_t *gauge, const gauge_config_t *cfg)
 {
+    lv_obj_t **arc = &gauge->arc;
+    lv_obj_t **label_value = &gauge->label_value;
+    lv_color_t color = lv_color_hex(cfg->color);
+
     /* Container */
     lv_obj_t *cont = lv_obj_create(parent);
     lv_obj_set_size(cont, 250, 230);
-    lv_obj_set_pos(cont, x, y);
+    lv_obj_set_pos(cont, cfg->x, cfg->y);
     lv_obj_set_style_bg_color(cont, lv_color_hex(0x2a2a2a), 0);
     lv_obj_set_style_border_color(cont, color, 0);
     lv_obj_set_style_border_width(cont, 2, 0);
@@ -155,24 +125,20 @@ static void create_gauge(lv_obj_t *parent, lv_obj_t **arc, lv_obj_t **label_valu
     
     /* Title */
     lv_obj_t *label_title = lv_label_create(cont);
-    lv_label_set_text(label_title, title);
+    lv_label_set_text_static(label_title, cfg->title);
     lv_obj_set_style_text_color(label_title, lv_color_white(), 0);
     lv_obj_align(label_title, LV_ALIGN_TOP_MID, 0, 10);
     
     /* Arc */
-    *arc = lv_arc_create(cont);
+    *arc = ui_gauge_arc_create(cont);
     lv_obj_set_size(*arc, 160, 160);
-    lv_arc_set_rotation(*arc, 135);
-    lv_arc_set_bg_angles(*arc, 0, 270);
-    lv_arc_set_range(*arc, min_val, max_val);
-    lv_arc_set_value(*arc, min_val);
+    ui_gauge_arc_set_range(*arc, cfg->min_val, cfg->max_val);
+    ui_gauge_arc_set_value(*arc, cfg->min_val);
     lv_obj_set_style_arc_color(*arc, color, LV_PART_INDICATOR);
     lv_obj_set_style_arc_width(*arc, 15, LV_PART_INDICATOR);
     lv_obj_set_style_arc_color(*arc, lv_color_hex(0x4a4a4a), LV_PART_MAIN);
     lv_obj_set_style_arc_width(*arc, 15, LV_PART_MAIN);
     lv_obj_center(*arc);
-    lv_obj_remove_style(*arc, NULL, LV_PART_KNOB);
-    lv_obj_clear_flag(*arc, LV_OBJ_FLAG_CLICKABLE);
     
     /* Value label */
     *label_value = lv_label_create(cont);
@@ -183,27 +149,31 @@ static void create_gauge(lv_obj_t *parent, lv_obj_t **arc, lv_obj_t **label_valu
     
     /* Unit label */
     lv_obj_t *label_unit = lv_label_create(cont);
-    lv_label_set_text(label_unit, unit);
+    lv_label_set_text_static(label_unit, cfg->unit);
     lv_obj_set_style_text_color(label_unit, lv_color_hex(0xcccccc), 0);
     lv_obj_align_to(label_unit, *label_value, LV_ALIGN_OUT_BOTTOM_MID, 0, 5);
     
-    /* Store label reference in arc user data */
-    lv_obj_set_user_data(*arc, *label_value);
+    gauge->last_value = cfg->min_val;
+
+#if CONFIG_ECU_GAUGE_BG_CACHE
+    /* Container, title, unit and background arc are drawn from a cached image */
+    ui_gauge_cache_attach(cont, *arc, *label_value);
+#endif
 }
 
-static void anim_set_value(void *obj, int32_t value)
+static void anim_set_value(void *var, int32_t value)
 {
-    lv_obj_t *arc = (lv_obj_t *)obj;
-    lv_arc_set_value(arc, value);
-    
-    /* Update value label */
-    lv_obj_t *label = (lv_obj_t *)lv_obj_get_user_data(arc);
-    if (label) {
-        lv_label_set_text_fmt(label, "%d", value);
+    gauge_t *gauge = (gauge_t *)var;
+    if (value == gauge->last_value) {
+        return;
     }
+    gauge->last_value = value;
+
+    ui_gauge_arc_set_value(gauge->arc, value);
+    lv_label_set_text_fmt(gauge->label_value, "%d", (int)value);
     
     /* Special handling for RPM gauge - update TCU status */
-    if (arc == arc_rpm) {
+    if (gauge == &gauges[GAUGE_RPM]) {
         if (value > 5500) {
             lv_led_set_color(led_tcu, lv_color_hex(0xFF0000));
             lv_label_set_text(label_tcu_status, "ERROR");
@@ -218,4 +188,4 @@ static void anim_set_value(void *obj, int32_t value)
             lv_obj_set_style_text_color(label_tcu_status, lv_color_hex(0x00FF00), 0);
         }
     }
-}
\ No newline at end of file
+}
@@ -1,77 +1,95 @@
 // ECU Dashboard Screen with 6 animated gauges
 // Based on test project structure
 
+#include "sdkconfig.h"
 #include "../ui.h"
 
 lv_obj_t * ui_Screen1 = NULL;
-lv_obj_t * ui_Arc_MAP = NULL;
-lv_obj_t * ui_Arc_Wastegate = NULL;
-lv_obj_t * ui_Arc_TPS = NULL;
-lv_obj_t * ui_Arc_RPM = NULL;
-lv_obj_t * ui_Arc_Boost = NULL;
 lv_obj_t * ui_LED_TCU = NULL;
-
-lv_obj_t * ui_Label_MAP_Value = NULL;
-lv_obj_t * ui_Label_Wastegate_Value = NULL;
-lv_obj_t * ui_Label_TPS_Value = NULL;
-lv_obj_t * ui_Label_RPM_Value = NULL;
-lv_obj_t * ui_Label_Boost_Value = NULL;
 lv_obj_t * ui_Label_TCU_Status = NULL;
 
-static lv_anim_t anim_map;
-static lv_anim_t anim_wastegate;
-static lv_anim_t anim_tps;
-static lv_anim_t anim_rpm;
-static lv_anim_t anim_boost;
+// Static gauge configuration (flash)
+typedef struct {
+    const char * title;
+    const char * unit;
+    uint32_t color;
+    int32_t min;
+    int32_t max;
+    lv_coord_t x;
+    lv_coord_t y;
+    // Demo sweep until live data drives the gauges
+    int32_t anim_from;
+    int32_t anim_to;
+    uint32_t anim_time;
+} gauge_config_t;
 
-static void anim_value_cb(void * var, int32_t v)
+static const gauge_config_t gauge_configs[UI_SCREEN1_GAUGE_COUNT] = {
+    [UI_SCREEN1_GAUGE_MAP]       = {"MAP Pressure", "kPa", 0x00D4FF, 100, 250, 15, 15, 100, 250, 3000},
+    [UI_SCREEN1_GAUGE_WASTEGATE] = {"Wastegate", "%", 0x00FF88, 0, 100, 275, 15, 0, 100, 2500},
+    [UI_SCREEN1_GAUGE_TPS]       = {"TPS Position", "%", 0xFFD700, 0, 100, 535, 15, 0, 100, 2000},
+    [UI_SCREEN1_GAUGE_RPM]       = {"Engine RPM", "RPM", 0xFF6B35, 0, 7000, 15, 255, 800, 6500, 4000},
+    [UI_SCREEN1_GAUGE_BOOST]     = {"Target Boost", "kPa", 0xFFD700, 100, 250, 275, 255, 100, 250, 3500},
+};
+
+// Gauge registry: one contiguous entry per gauge
+typedef struct {
+    lv_obj_t * arc;
+    lv_obj_t * label;
+    int32_t last_value;
+} ui_screen1_gauge_t;
+
+static ui_screen1_gauge_t gauges[UI_SCREEN1_GAUGE_COUNT];
+static lv_anim_t gauge_anims[UI_SCREEN1_GAUGE_COUNT];
+
+static void update_tcu_status(int32_t rpm)
 {
-    lv_arc_set_value((lv_obj_t *)var, v);
-    
-    if(var == ui_Arc_MAP) {
-        lv_label_set_text_fmt(ui_Label_MAP_Value, "%d", v);
-    }
-    else if(var == ui_Arc_Wastegate) {
-        lv_label_set_text_fmt(ui_Label_Wastegate_Value, "%d", v);
-    }
-    else if(var == ui_Arc_TPS) {
-        lv_label_set_text_fmt(ui_Label_TPS_Value, "%d", v);
+    if(rpm > 5500) {
+        lv_led_set_color(ui_LED_TCU, lv_color_hex(0xFF0000));
+        lv_label_set_text(ui_Label_TCU_Status, "ERROR");
+        lv_obj_set_style_text_color(ui_Label_TCU_Status, lv_color_hex(0xFF0000), 0);
     }
-    else if(var == ui_Arc_RPM) {
-        lv_label_set_text_fmt(ui_Label_RPM_Value, "%d", v);
-        
-        // Update TCU status based on RPM
-        if(v > 5500) {
-            lv_led_set_color(ui_LED_TCU, lv_color_hex(0xFF0000));
-            lv_label_set_text(ui_Label_TCU_Status, "ERROR");
-            lv_obj_set_style_text_color(ui_Label_TCU_Status, lv_color_hex(0xFF0000), 0);
-        }
-        else if(v > 4500) {
-            lv_led_set_color(ui_LED_TCU, lv_color_hex(0xFFAA00));
-            lv_label_set_text(ui_Label_TCU_Status, "WARNING");
-            lv_obj_set_style_text_color(ui_Label_TCU_Status, lv_color_hex(0xFFAA00), 0);
-        }
-        else {
-            lv_led_set_color(ui_LED_TCU, lv_color_hex(0x00FF00));
-            lv_label_set_text(ui_Label_TCU_Status, "OK");
-            lv_obj_set_style_text_color(ui_Label_TCU_Status, lv_color_hex(0x00FF00), 0);
-        }
+    else if(rpm > 4500) {
+        lv_led_set_color(ui_LED_TCU, lv_color_hex(0xFFAA00));
+        lv_label_set_text(ui_Label_TCU_Status, "WARNING");
+        lv_obj_set_style_text_color(ui_Label_TCU_Status, lv_color_hex(0xFFAA00), 0);
     }
-    else if(var == ui_Arc_Boost) {
-        lv_label_set_text_fmt(ui_Label_Boost_Value, "%d", v);
+    else {
+        lv_led_set_color(ui_LED_TCU, lv_color_hex(0x00FF00));
+        lv_label_set_text(ui_Label_TCU_Status, "OK");
+        lv_obj_set_style_text_color(ui_Label_TCU_Status, lv_color_hex(0x00FF00), 0);
     }
 }
 
-static void create_gauge(lv_obj_t * parent, lv_obj_t ** arc, lv_obj_t ** label,
-                        const char * title, const char * unit, lv_color_t color,
-                        int32_t min_val, int32_t max_val, int x, int y)
+void ui_Screen1_set_gauge_value(ui_screen1_gauge_id_t id, int32_t v)
+{
+    ui_screen1_gauge_t * g = &gauges[id];
+    if(g->arc == NULL || v == g->last_value) return;
+    g->last_value = v;
+
+    ui_gauge_arc_set_value(g->arc, v);
+    lv_label_set_text_fmt(g->label, "%d", (int)v);
+
+    // Update TCU status based on RPM
+    if(id == UI_SCREEN1_GAUGE_RPM) update_tcu_status(v);
+}
+
+static void anim_value_cb(void * var, int32_t v)
+{
+    ui_Screen1_set_gauge_value((ui_screen1_gauge_id_t)((ui_screen1_gauge_t *)var - gauges), v);
+}
+
+static void create_gauge(lv_obj_t * parent, ui_screen1_gauge_t * g, const gauge_config_t * cfg)
 {
+    lv_obj_t ** arc = &g->arc;
+    lv_obj_t ** label = &g->label;
+    lv_color_t color = lv_color_hex(cfg->color);
+
     // Container
     lv_obj_t * cont = lv_obj_create(parent);
     lv_obj_set_width(cont, 250);
     lv_obj_set_height(cont, 230);
-    lv_obj_set_x(cont, x);
-    lv_obj_set_y(cont, y);
+    lv_obj_set_x(cont, cfg->x);
+    lv_obj_set_y(cont, cfg->y);
     lv_obj_set_align(cont, LV_ALIGN_TOP_LEFT);
     lv_obj_clear_flag(cont, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_set_style_bg_color(cont, lv_color_hex(0x2a2a2a), 0);
@@ -82,24 +100,20 @@ static void create_gauge(lv_obj_t * parent, lv_obj_t ** arc, lv_obj_t ** label,
     
     // Title
     lv_obj_t * label_title = lv_label_create(cont);
-    lv_label_set_text(label_title, title);
+    lv_label_set_text_static(label_title, cfg->title);
     lv_obj_set_style_text_color(label_title, lv_color_white(), 0);
     lv_obj_align(label_title, LV_ALIGN_TOP_MID, 0, 10);
     
     // Arc
-    *arc = lv_arc_create(cont);
+    *arc = ui_gauge_arc_create(cont);
     lv_obj_set_size(*arc, 160, 160);
-    lv_arc_set_rotation(*arc, 135);
-    lv_arc_set_bg_angles(*arc, 0, 270);
-    lv_arc_set_range(*arc, min_val, max_val);
-    lv_arc_set_value(*arc, min_val);
+    ui_gauge_arc_set_range(*arc, cfg->min, cfg->max);
+    ui_gauge_arc_set_value(*arc, cfg->min);
     lv_obj_set_style_arc_color(*arc, color, LV_PART_INDICATOR);
     lv_obj_set_style_arc_width(*arc, 15, LV_PART_INDICATOR);
     lv_obj_set_style_arc_color(*arc, lv_color_hex(0x4a4a4a), LV_PART_MAIN);
     lv_obj_set_style_arc_width(*arc, 15, LV_PART_MAIN);
     lv_obj_center(*arc);
-    lv_obj_remove_style(*arc, NULL, LV_PART_KNOB);
-    lv_obj_clear_flag(*arc, LV_OBJ_FLAG_CLICKABLE);
     
     // Value label
     *label = lv_label_create(cont);
@@ -110,9 +124,15 @@ static void create_gauge(lv_obj_t * parent, lv_obj_t ** arc, lv_obj_t ** label,
     
     // Unit label
     lv_obj_t * label_unit = lv_label_create(cont);
-    lv_label_set_text(label_unit, unit);
+    lv_label_set_text_static(label_unit, cfg->unit);
     lv_obj_set_style_text_color(label_unit, lv_color_hex(0xcccccc), 0);
     lv_obj_align_to(label_unit, *label, LV_ALIGN_OUT_BOTTOM_MID, 0, 5);
+    g->last_value = cfg->min;
+
+#if CONFIG_ECU_GAUGE_BG_CACHE
+    // Container, title, unit and background arc are drawn from a cached image
+    ui_gauge_cache_attach(cont, *arc, *label);
+#endif
 }
 
 void ui_Screen1_screen_init(void)
@@ -122,20 +142,9 @@ void ui_Screen1_screen_init(void)
     lv_obj_set_style_bg_color(ui_Screen1, lv_color_hex(0x1a1a1a), 0);
     
     // Create gauges in 3x2 grid
-    create_gauge(ui_Screen1, &ui_Arc_MAP, &ui_Label_MAP_Value, 
-                "MAP Pressure", "kPa", lv_color_hex(0x00D4FF), 100, 250, 15, 15);
-    
-    create_gauge(ui_Screen1, &ui_Arc_Wastegate, &ui_Label_Wastegate_Value,
-                "Wastegate", "%", lv_color_hex(0x00FF88), 0, 100, 275, 15);
-    
-    create_gauge(ui_Screen1, &ui_Arc_TPS, &ui_Label_TPS_Value,
-                "TPS Position", "%", lv_color_hex(0xFFD700), 0, 100, 535, 15);
-    
-    create_gauge(ui_Screen1, &ui_Arc_RPM, &ui_Label_RPM_Value,
-                "Engine RPM", "RPM", lv_color_hex(0xFF6B35), 0, 7000, 15, 255);
-    
-    create_gauge(ui_Screen1, &ui_Arc_Boost, &ui_Label_Boost_Value,
-                "Target Boost", "kPa", lv_color_hex(0xFFD700), 100, 250, 275, 255);
+    for(int i = 0; i < UI_SCREEN1_GAUGE_COUNT; i++) {
+        create_gauge(ui_Screen1, &gauges[i], &gauge_configs[i]);
+    }
     
     // TCU Status indicator
     lv_obj_t * tcu_cont = lv_obj_create(ui_Screen1);
@@ -167,54 +176,26 @@ void ui_Screen1_screen_init(void)
     lv_obj_align(ui_Label_TCU_Status, LV_ALIGN_BOTTOM_MID, 0, -20);
     
     // Setup animations
-    lv_anim_init(&anim_map);
-    lv_anim_set_var(&anim_map, ui_Arc_MAP);
-    lv_anim_set_values(&anim_map, 100, 250);
-    lv_anim_set_time(&anim_map, 3000);
-    lv_anim_set_playback_time(&anim_map, 3000);
-    lv_anim_set_repeat_count(&anim_map, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_exec_cb(&anim_map, anim_value_cb);
-    lv_anim_start(&anim_map);
-    
-    lv_anim_init(&anim_wastegate);
-    lv_anim_set_var(&anim_wastegate, ui_Arc_Wastegate);
-    lv_anim_set_values(&anim_wastegate, 0, 100);
-    lv_anim_set_time(&anim_wastegate, 2500);
-    lv_anim_set_playback_time(&anim_wastegate, 2500);
-    lv_anim_set_repeat_count(&anim_wastegate, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_exec_cb(&anim_wastegate, anim_value_cb);
-    lv_anim_start(&anim_wastegate);
-    
-    lv_anim_init(&anim_tps);
-    lv_anim_set_var(&anim_tps, ui_Arc_TPS);
-    lv_anim_set_values(&anim_tps, 0, 100);
-    lv_anim_set_time(&anim_tps, 2000);
-    lv_anim_set_playback_time(&anim_tps, 2000);
-    lv_anim_set_repeat_count(&anim_tps, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_exec_cb(&anim_tps, anim_value_cb);
-    lv_anim_start(&anim_tps);
-    
-    lv_anim_init(&anim_rpm);
-    lv_anim_set_var(&anim_rpm, ui_Arc_RPM);
-    lv_anim_set_values(&anim_rpm, 800, 6500);
-    lv_anim_set_time(&anim_rpm, 4000);
-    lv_anim_set_playback_time(&anim_rpm, 4000);
-    lv_anim_set_repeat_count(&anim_rpm, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_exec_cb(&anim_rpm, anim_value_cb);
-    lv_anim_start(&anim_rpm);
-    
-    lv_anim_init(&anim_boost);
-    lv_anim_set_var(&anim_boost, ui_Arc_Boost);
-    lv_anim_set_values(&anim_boost, 100, 250);
-    lv_anim_set_time(&anim_boost, 3500);
-    lv_anim_set_playback_time(&anim_boost, 3500);
-    lv_anim_set_repeat_count(&anim_boost, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_set_exec_cb(&anim_boost, anim_value_cb);
-    lv_anim_start(&anim_boost);
+    for(int i = 0; i < UI_SCREEN1_GAUGE_COUNT; i++) {
+        const gauge_config_t * cfg = &gauge_configs[i];
+        lv_anim_t * a = &gauge_anims[i];
+        lv_anim_init(a);
+        lv_anim_set_var(a, &gauges[i]);
+        lv_anim_set_values(a, cfg->anim_from, cfg->anim_to);
+        lv_anim_set_time(a, cfg->anim_time);
+        lv_anim_set_playback_time(a, cfg->anim_time);
+        lv_anim_set_repeat_count(a, LV_ANIM_REPEAT_INFINITE);
+        lv_anim_set_exec_cb(a, anim_value_cb);
+        lv_anim_start(a);
+    }
 }
 
 void ui_Screen1_screen_destroy(void)
 {
+    for(int i = 0; i < UI_SCREEN1_GAUGE_COUNT; i++) {
+        lv_anim_del(&gauges[i], anim_value_cb);
+    }
     if(ui_Screen1) lv_obj_del(ui_Screen1);
     ui_Screen1 = NULL;
+    lv_memset_00(gauges, sizeof(gauges));
 }
\ No newline at end of file
@@ -5,15 +5,21 @@
 extern "C" {
 #endif
 
+// Gauges on ui_Screen1
+typedef enum {
+    UI_SCREEN1_GAUGE_MAP = 0,
+    UI_SCREEN1_GAUGE_WASTEGATE,
+    UI_SCREEN1_GAUGE_TPS,
+    UI_SCREEN1_GAUGE_RPM,
+    UI_SCREEN1_GAUGE_BOOST,
+    UI_SCREEN1_GAUGE_COUNT
+} ui_screen1_gauge_id_t;
+
 // SCREEN: ui_Screen1
 extern void ui_Screen1_screen_init(void);
 extern void ui_Screen1_screen_destroy(void);
+extern void ui_Screen1_set_gauge_value(ui_screen1_gauge_id_t id, int32_t v);
 extern lv_obj_t * ui_Screen1;
-extern lv_obj_t * ui_Arc_MAP;
-extern lv_obj_t * ui_Arc_Wastegate;
-extern lv_obj_t * ui_Arc_TPS;
-extern lv_obj_t * ui_Arc_RPM;
-extern lv_obj_t * ui_Arc_Boost;
 extern lv_obj_t * ui_LED_TCU;
 
 #ifdef __cplusplus
@@ -25,6 +25,13 @@ void ui_init(void)
     ui_Screen1_screen_init();
     ui____initial_actions0 = lv_obj_create(NULL);
     lv_disp_load_scr(ui_Screen1);
+#if CONFIG_ECU_GAUGE_BG_CACHE
+    // The gauges were rendered on attach; from now on re-render on theme or resolution changes
+    ui_gauge_cache_watch(ui_Screen1);
+#endif
+#if CONFIG_ECU_PERF_HUD
+    ui_perf_hud_init(ui_Screen1);
+#endif
 }
 
 void ui_destroy(void)
@@ -8,6 +8,9 @@ extern "C" {
 #include "lvgl.h"
 #include "ui_helpers.h"
 #include "ui_events.h"
+#include "ui_gauge_arc.h"
+#include "ui_gauge_cache.h"
+#include "ui_perf_hud.h"
 
 ///////////////////// SCREENS ////////////////////
 #include "screens/ui_Screen1.h"
@@ -0,0 +1,216 @@
+// Dashboard gauge arc with minimal invalidation
+// Only the annular sector between the previous and the new indicator angle is redrawn
+
+#include "ui_gauge_arc.h"
+
+#define MY_CLASS &ui_gauge_arc_class
+
+typedef struct {
+    lv_obj_t obj;
+    int32_t min;
+    int32_t max;
+    int32_t value;
+    uint16_t angle;     // indicator sweep in degrees, 0..UI_GAUGE_ARC_SWEEP
+} ui_gauge_arc_t;
+
+static void ui_gauge_arc_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void ui_gauge_arc_event(const lv_obj_class_t * class_p, lv_event_t * e);
+
+const lv_obj_class_t ui_gauge_arc_class = {
+    .constructor_cb = ui_gauge_arc_constructor,
+    .event_cb = ui_gauge_arc_event,
+    .instance_size = sizeof(ui_gauge_arc_t),
+    .base_class = &lv_obj_class
+};
+
+// cos/sin (Q15) for every degree of the sweep, indexed by sweep angle
+static int16_t sweep_cos[UI_GAUGE_ARC_SWEEP + 1];
+static int16_t sweep_sin[UI_GAUGE_ARC_SWEEP + 1];
+static bool sweep_table_ready = false;
+
+static uint32_t invalidated_px = 0;
+
+static void build_sweep_table(void)
+{
+    for(int i = 0; i <= UI_GAUGE_ARC_SWEEP; i++) {
+        int16_t a = (UI_GAUGE_ARC_ROTATION + i) % 360;
+        sweep_sin[i] = lv_trigo_sin(a);
+        sweep_cos[i] = lv_trigo_cos(a);
+    }
+    sweep_table_ready = true;
+}
+
+static void get_geometry(lv_obj_t * obj, lv_point_t * center, lv_coord_t * radius)
+{
+    lv_coord_t left = lv_obj_get_style_pad_left(obj, LV_PART_MAIN);
+    lv_coord_t right = lv_obj_get_style_pad_right(obj, LV_PART_MAIN);
+    lv_coord_t top = lv_obj_get_style_pad_top(obj, LV_PART_MAIN);
+    lv_coord_t bottom = lv_obj_get_style_pad_bottom(obj, LV_PART_MAIN);
+    lv_coord_t w = lv_obj_get_width(obj) - left - right;
+    lv_coord_t h = lv_obj_get_height(obj) - top - bottom;
+
+    *radius = LV_MIN(w, h) / 2;
+    center->x = obj->coords.x1 + left + w / 2;
+    center->y = obj->coords.y1 + top + h / 2;
+}
+
+static inline void area_add_point(lv_area_t * a, lv_coord_t x, lv_coord_t y)
+{
+    if(x < a->x1) a->x1 = x;
+    if(x > a->x2) a->x2 = x;
+    if(y < a->y1) a->y1 = y;
+    if(y > a->y2) a->y2 = y;
+}
+
+// Bounding box of the annular sector [a0, a1] (sweep degrees)
+static void invalidate_sector(lv_obj_t * obj, uint16_t a0, uint16_t a1)
+{
+    if(a0 == a1) return;
+    if(a0 > a1) {
+        uint16_t t = a0;
+        a0 = a1;
+        a1 = t;
+    }
+
+    lv_point_t c;
+    lv_coord_t r_out;
+    get_geometry(obj, &c, &r_out);
+
+    lv_coord_t w_main = lv_obj_get_style_arc_width(obj, LV_PART_MAIN);
+    lv_coord_t w_indic = lv_obj_get_style_arc_width(obj, LV_PART_INDICATOR);
+    lv_coord_t w = LV_MAX(w_main, w_indic);
+    lv_coord_t r_in = LV_MAX(r_out - w, 0);
+
+    lv_area_t a = { .x1 = LV_COORD_MAX, .y1 = LV_COORD_MAX, .x2 = LV_COORD_MIN, .y2 = LV_COORD_MIN };
+
+    // Both end points on the inner and outer edge
+    uint16_t ends[2] = {a0, a1};
+    for(int i = 0; i < 2; i++) {
+        int32_t cs = sweep_cos[ends[i]];
+        int32_t sn = sweep_sin[ends[i]];
+        area_add_point(&a, c.x + ((r_out * cs) >> LV_TRIGO_SHIFT), c.y + ((r_out * sn) >> LV_TRIGO_SHIFT));
+        area_add_point(&a, c.x + ((r_in * cs) >> LV_TRIGO_SHIFT), c.y + ((r_in * sn) >> LV_TRIGO_SHIFT));
+    }
+
+    // Axis extremes crossed inside the sector (0, 90, 180, 270 degrees absolute)
+    for(int axis = 0; axis < 360; axis += 90) {
+        int sweep = (axis - UI_GAUGE_ARC_ROTATION + 360) % 360;
+        if(sweep < a0 || sweep > a1) continue;
+        area_add_point(&a, c.x + ((r_out * sweep_cos[sweep]) >> LV_TRIGO_SHIFT),
+                       c.y + ((r_out * sweep_sin[sweep]) >> LV_TRIGO_SHIFT));
+    }
+
+    // Rounded caps and anti-aliasing reach half an arc width past the ends
+    lv_coord_t pad = w / 2 + 2;
+    a.x1 -= pad;
+    a.y1 -= pad;
+    a.x2 += pad;
+    a.y2 += pad;
+
+    invalidated_px += lv_area_get_size(&a);
+    lv_obj_invalidate_area(obj, &a);
+}
+
+static uint16_t value_to_angle(const ui_gauge_arc_t * arc, int32_t value)
+{
+    if(arc->max <= arc->min) return 0;
+    return (uint16_t)lv_map(value, arc->min, arc->max, 0, UI_GAUGE_ARC_SWEEP);
+}
+
+static void ui_gauge_arc_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    LV_UNUSED(class_p);
+
+    if(!sweep_table_ready) build_sweep_table();
+
+    ui_gauge_arc_t * arc = (ui_gauge_arc_t *)obj;
+    arc->min = 0;
+    arc->max = 100;
+    arc->value = 0;
+    arc->angle = 0;
+
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+}
+
+static void draw_main(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_target(e);
+    ui_gauge_arc_t * arc = (ui_gauge_arc_t *)obj;
+    lv_draw_ctx_t * draw_ctx = lv_event_get_draw_ctx(e);
+
+    lv_point_t c;
+    lv_coord_t r;
+    get_geometry(obj, &c, &r);
+    if(r <= 0) return;
+
+    lv_draw_arc_dsc_t arc_dsc;
+
+    lv_draw_arc_dsc_init(&arc_dsc);
+    lv_obj_init_draw_arc_dsc(obj, LV_PART_MAIN, &arc_dsc);
+    if(arc_dsc.opa > LV_OPA_MIN) {
+        lv_draw_arc(draw_ctx, &arc_dsc, &c, r, UI_GAUGE_ARC_ROTATION,
+                    (UI_GAUGE_ARC_ROTATION + UI_GAUGE_ARC_SWEEP) % 360);
+    }
+
+    if(arc->angle == 0) return;
+
+    lv_draw_arc_dsc_init(&arc_dsc);
+    lv_obj_init_draw_arc_dsc(obj, LV_PART_INDICATOR, &arc_dsc);
+    if(arc_dsc.opa > LV_OPA_MIN) {
+        lv_draw_arc(draw_ctx, &arc_dsc, &c, r, UI_GAUGE_ARC_ROTATION,
+                    (UI_GAUGE_ARC_ROTATION + arc->angle) % 360);
+    }
+}
+
+static void ui_gauge_arc_event(const lv_obj_class_t * class_p, lv_event_t * e)
+{
+    LV_UNUSED(class_p);
+
+    if(lv_obj_event_base(MY_CLASS, e) != LV_RES_OK) return;
+
+    if(lv_event_get_code(e) == LV_EVENT_DRAW_MAIN) {
+        draw_main(e);
+    }
+}
+
+lv_obj_t * ui_gauge_arc_create(lv_obj_t * parent)
+{
+    lv_obj_t * obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+void ui_gauge_arc_set_range(lv_obj_t * obj, int32_t min, int32_t max)
+{
+    ui_gauge_arc_t * arc = (ui_gauge_arc_t *)obj;
+    arc->min = min;
+    arc->max = max;
+    arc->value = LV_CLAMP(min, arc->value, max);
+    arc->angle = value_to_angle(arc, arc->value);
+    lv_obj_invalidate(obj);
+}
+
+void ui_gauge_arc_set_value(lv_obj_t * obj, int32_t value)
+{
+    ui_gauge_arc_t * arc = (ui_gauge_arc_t *)obj;
+    value = LV_CLAMP(arc->min, value, arc->max);
+    if(value == arc->value) return;
+
+    uint16_t angle = value_to_angle(arc, value);
+    invalidate_sector(obj, arc->angle, angle);
+    arc->value = value;
+    arc->angle = angle;
+}
+
+int32_t ui_gauge_arc_get_value(const lv_obj_t * obj)
+{
+    return ((const ui_gauge_arc_t *)obj)->value;
+}
+
+uint32_t ui_gauge_arc_take_invalidated_px(void)
+{
+    uint32_t px = invalidated_px;
+    invalidated_px = 0;
+    return px;
+}
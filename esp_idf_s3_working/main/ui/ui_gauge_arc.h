@@ -0,0 +1,32 @@
+#ifndef _UI_GAUGE_ARC_H
+#define _UI_GAUGE_ARC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+// 270 degree gauge arc, starting at 135 degrees (bottom left) and sweeping clockwise
+#define UI_GAUGE_ARC_ROTATION 135
+#define UI_GAUGE_ARC_SWEEP    270
+
+// Lightweight replacement for lv_arc used by the dashboard gauges.
+// A value change invalidates only the bounding box of the angular sector
+// between the old and the new value instead of the whole arc.
+// Styles: LV_PART_MAIN arc_* for the background arc, LV_PART_INDICATOR arc_* for the value arc.
+extern const lv_obj_class_t ui_gauge_arc_class;
+
+lv_obj_t * ui_gauge_arc_create(lv_obj_t * parent);
+void ui_gauge_arc_set_range(lv_obj_t * obj, int32_t min, int32_t max);
+void ui_gauge_arc_set_value(lv_obj_t * obj, int32_t value);
+int32_t ui_gauge_arc_get_value(const lv_obj_t * obj);
+
+// Pixels invalidated by gauge arcs since the last call
+uint32_t ui_gauge_arc_take_invalidated_px(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
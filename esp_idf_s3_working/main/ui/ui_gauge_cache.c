@@ -0,0 +1,149 @@
+// Pre-rendered gauge backgrounds
+// The static layers are drawn once with lv_snapshot into PSRAM and shown as an lv_img
+
+#include "ui_gauge_cache.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char * TAG = "UI_GAUGE_CACHE";
+
+// Alpha keeps the rounded container corners blending with the screen background
+#define UI_GAUGE_CACHE_CF LV_IMG_CF_TRUE_COLOR_ALPHA
+
+typedef struct {
+    lv_obj_t * cont;
+    lv_obj_t * arc;
+    lv_obj_t * value_label;
+    lv_obj_t * img;
+    lv_img_dsc_t dsc;
+    uint8_t * buf;
+    uint32_t buf_size;
+} ui_gauge_cache_t;
+
+static ui_gauge_cache_t gauge_cache[UI_GAUGE_CACHE_MAX];
+static bool refresh_pending = false;
+
+// Toggle between drawing the static layers live and drawing only the dynamic ones
+static void set_static_layers_visible(ui_gauge_cache_t * c, bool visible)
+{
+    lv_opa_t opa = visible ? LV_OPA_COVER : LV_OPA_TRANSP;
+
+    lv_obj_set_style_bg_opa(c->cont, opa, 0);
+    lv_obj_set_style_border_opa(c->cont, opa, 0);
+    lv_obj_set_style_arc_opa(c->arc, opa, LV_PART_MAIN);
+
+    uint32_t cnt = lv_obj_get_child_cnt(c->cont);
+    for(uint32_t i = 0; i < cnt; i++) {
+        lv_obj_t * child = lv_obj_get_child(c->cont, i);
+        if(child == c->arc || child == c->value_label) continue;
+        if(visible) lv_obj_clear_flag(child, LV_OBJ_FLAG_HIDDEN);
+        else lv_obj_add_flag(child, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+static void render(ui_gauge_cache_t * c)
+{
+    // Snapshot the static layers only
+    set_static_layers_visible(c, true);
+    lv_obj_set_style_arc_opa(c->arc, LV_OPA_TRANSP, LV_PART_INDICATOR);
+    lv_obj_add_flag(c->value_label, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_update_layout(lv_obj_get_screen(c->cont));
+
+    uint32_t size = lv_snapshot_buf_size_needed(c->cont, UI_GAUGE_CACHE_CF);
+    if(size != c->buf_size) {
+        heap_caps_free(c->buf);
+        c->buf = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+        c->buf_size = c->buf ? size : 0;
+    }
+
+    lv_res_t res = LV_RES_INV;
+    if(c->buf) {
+        res = lv_snapshot_take_to_buf(c->cont, UI_GAUGE_CACHE_CF, &c->dsc, c->buf, c->buf_size);
+    }
+
+    lv_obj_set_style_arc_opa(c->arc, LV_OPA_COVER, LV_PART_INDICATOR);
+    lv_obj_clear_flag(c->value_label, LV_OBJ_FLAG_HIDDEN);
+
+    if(res != LV_RES_OK) {
+        // Fall back to live rendering of the whole gauge
+        ESP_LOGW(TAG, "Snapshot failed (%lu bytes), drawing gauge live", (unsigned long)size);
+        lv_obj_add_flag(c->img, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+
+    set_static_layers_visible(c, false);
+
+    // The snapshot covers the extended draw area (e.g. shadows) around the container
+    lv_coord_t ext = lv_obj_get_ext_draw_size(c->cont);
+    lv_img_cache_invalidate_src(&c->dsc);
+    lv_img_set_src(c->img, &c->dsc);
+    lv_obj_set_pos(c->img, lv_obj_get_x(c->cont) - ext, lv_obj_get_y(c->cont) - ext);
+    lv_obj_clear_flag(c->img, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void cont_delete_cb(lv_event_t * e)
+{
+    ui_gauge_cache_t * c = lv_event_get_user_data(e);
+    heap_caps_free(c->buf);
+    lv_memset_00(c, sizeof(*c));
+}
+
+void ui_gauge_cache_attach(lv_obj_t * cont, lv_obj_t * arc, lv_obj_t * value_label)
+{
+    ui_gauge_cache_t * c = NULL;
+    for(int i = 0; i < UI_GAUGE_CACHE_MAX; i++) {
+        if(gauge_cache[i].cont == NULL) {
+            c = &gauge_cache[i];
+            break;
+        }
+    }
+    if(c == NULL) {
+        ESP_LOGW(TAG, "Cache full, gauge drawn live");
+        return;
+    }
+
+    c->cont = cont;
+    c->arc = arc;
+    c->value_label = value_label;
+
+    // Image sits directly behind the container on the same parent
+    lv_obj_t * parent = lv_obj_get_parent(cont);
+    c->img = lv_img_create(parent);
+    lv_obj_set_align(c->img, LV_ALIGN_TOP_LEFT);
+    lv_obj_clear_flag(c->img, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_move_to_index(c->img, lv_obj_get_index(cont));
+
+    lv_obj_add_event_cb(cont, cont_delete_cb, LV_EVENT_DELETE, c);
+
+    render(c);
+}
+
+void ui_gauge_cache_refresh_all(void)
+{
+    for(int i = 0; i < UI_GAUGE_CACHE_MAX; i++) {
+        if(gauge_cache[i].cont) render(&gauge_cache[i]);
+    }
+}
+
+static void refresh_async_cb(void * arg)
+{
+    LV_UNUSED(arg);
+    refresh_pending = false;
+    ui_gauge_cache_refresh_all();
+}
+
+// Deferred to the next lv_timer_handler() run: the theme has restyled all
+// children by then, and several events in a row cost one re-render
+static void screen_change_cb(lv_event_t * e)
+{
+    if(lv_event_get_target(e) != lv_event_get_current_target(e)) return;
+    if(refresh_pending) return;
+    refresh_pending = lv_async_call(refresh_async_cb, NULL) == LV_RES_OK;
+}
+
+void ui_gauge_cache_watch(lv_obj_t * screen)
+{
+    lv_obj_add_event_cb(screen, screen_change_cb, LV_EVENT_SIZE_CHANGED, NULL);
+    lv_obj_add_event_cb(screen, screen_change_cb, LV_EVENT_STYLE_CHANGED, NULL);
+    lv_obj_add_event_cb(screen, screen_change_cb, LV_EVENT_SCREEN_LOADED, NULL);
+}
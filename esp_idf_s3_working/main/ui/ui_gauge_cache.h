@@ -0,0 +1,28 @@
+#ifndef _UI_GAUGE_CACHE_H
+#define _UI_GAUGE_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+#define UI_GAUGE_CACHE_MAX 8
+
+// Render the static layers of a gauge (container, title, unit, background arc)
+// into a PSRAM image drawn behind it. Afterwards only the indicator arc and the
+// value label are rasterized when the gauge changes.
+void ui_gauge_cache_attach(lv_obj_t * cont, lv_obj_t * arc, lv_obj_t * value_label);
+
+// Re-render all cached gauges, call after a layout or style change
+void ui_gauge_cache_refresh_all(void);
+
+// Re-render automatically when the screen is resized (resolution change),
+// restyled (theme change) or loaded again
+void ui_gauge_cache_watch(lv_obj_t * screen);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
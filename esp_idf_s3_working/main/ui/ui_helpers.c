@@ -30,9 +30,9 @@ void _ui_screen_change(lv_obj_t ** target, lv_scr_load_anim_t fademode, int spd,
 
 void _ui_screen_delete(lv_obj_t ** target)
 {
-    if(*target == NULL) {
+    if(*target != NULL) {
         lv_obj_del(*target);
-        target = NULL;
+        *target = NULL;
     }
 }
 
@@ -0,0 +1,241 @@
+// Performance HUD
+// A label on the top layer, refreshed at 2 Hz from counters that already exist:
+// FreeRTOS run-time stats, heap_caps and the display frame counters
+
+#include <stdio.h>
+#include <string.h>
+#include "ui_perf_hud.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "../../components/espressif__esp_lcd_touch/display.h"
+
+static const char * TAG = "UI_PERF_HUD";
+
+#define UI_PERF_HUD_TASK_STATS (CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS)
+
+static lv_obj_t * hud_label;
+static lv_timer_t * hud_timer;
+
+// Previous samples, diffed on every tick
+static int64_t prev_us;
+static display_frame_stats_t prev_frames;
+
+#if UI_PERF_HUD_TASK_STATS
+// 32-bit on IDF v4.4, configurable on v5
+#ifdef configRUN_TIME_COUNTER_TYPE
+typedef configRUN_TIME_COUNTER_TYPE hud_runtime_t;
+#else
+typedef uint32_t hud_runtime_t;
+#endif
+
+typedef struct {
+    TaskHandle_t handle;
+    hud_runtime_t runtime;
+} task_sample_t;
+
+static TaskStatus_t task_status[UI_PERF_HUD_MAX_TASKS];
+static task_sample_t prev_tasks[UI_PERF_HUD_MAX_TASKS];
+static UBaseType_t prev_task_cnt;
+static hud_runtime_t prev_total_runtime;
+#endif
+
+// Advance pos by an snprintf() result, clamped to the buffer
+static size_t hud_append(char * buf, size_t len, size_t pos, int n)
+{
+    LV_UNUSED(buf);
+    if(n < 0 || len == 0) return pos;
+    pos += (size_t)n;
+    return pos < len ? pos : len - 1;
+}
+
+#if UI_PERF_HUD_TASK_STATS
+static hud_runtime_t prev_runtime_of(TaskHandle_t handle)
+{
+    for(UBaseType_t i = 0; i < prev_task_cnt; i++) {
+        if(prev_tasks[i].handle == handle) return prev_tasks[i].runtime;
+    }
+    return 0;
+}
+
+// Per-task CPU in percent of one core over the last period; idle tasks become per-core load
+static size_t format_tasks(char * buf, size_t len, size_t pos)
+{
+    hud_runtime_t total_runtime;
+    UBaseType_t cnt = uxTaskGetSystemState(task_status, UI_PERF_HUD_MAX_TASKS, &total_runtime);
+    if(cnt == 0) {
+        if(len == 0) return pos;
+        return hud_append(buf, len, pos, snprintf(buf + pos, len - pos, "tasks: > %d\n", UI_PERF_HUD_MAX_TASKS));
+    }
+
+    uint32_t elapsed = (uint32_t)(total_runtime - prev_total_runtime);
+    uint32_t deltas[UI_PERF_HUD_MAX_TASKS];
+    bool have_prev = prev_total_runtime != 0 && elapsed != 0;
+
+    for(UBaseType_t i = 0; i < cnt; i++) {
+        deltas[i] = (uint32_t)(task_status[i].ulRunTimeCounter - prev_runtime_of(task_status[i].xHandle));
+    }
+
+    if(have_prev) {
+        pos = hud_append(buf, len, pos, snprintf(buf + pos, len - pos, "CPU"));
+        for(UBaseType_t i = 0; i < cnt; i++) {
+            if(strncmp(task_status[i].pcTaskName, "IDLE", 4) != 0) continue;
+            uint32_t idle = (uint32_t)((uint64_t)deltas[i] * 100 / elapsed);
+            pos = hud_append(buf, len, pos, snprintf(buf + pos, len - pos, "  %s %lu%%",
+                                                     task_status[i].pcTaskName + 4,
+                                                     (unsigned long)(idle > 100 ? 0 : 100 - idle)));
+        }
+        pos = hud_append(buf, len, pos, snprintf(buf + pos, len - pos, "\n"));
+
+        // Partial selection sort, only the busiest few are shown
+        for(int shown = 0; shown < UI_PERF_HUD_TOP_TASKS; shown++) {
+            int best = -1;
+            for(UBaseType_t i = 0; i < cnt; i++) {
+                if(deltas[i] == 0 || strncmp(task_status[i].pcTaskName, "IDLE", 4) == 0) continue;
+                if(best < 0 || deltas[i] > deltas[best]) best = (int)i;
+            }
+            if(best < 0) break;
+            uint32_t permille = (uint32_t)((uint64_t)deltas[best] * 1000 / elapsed);
+            pos = hud_append(buf, len, pos, snprintf(buf + pos, len - pos, "  %-12s %2lu.%lu%%\n",
+                                                     task_status[best].pcTaskName,
+                                                     (unsigned long)(permille / 10), (unsigned long)(permille % 10)));
+            deltas[best] = 0;
+        }
+    }
+
+    for(UBaseType_t i = 0; i < cnt; i++) {
+        prev_tasks[i].handle = task_status[i].xHandle;
+        prev_tasks[i].runtime = task_status[i].ulRunTimeCounter;
+    }
+    prev_task_cnt = cnt;
+    prev_total_runtime = total_runtime;
+    return pos;
+}
+#endif
+
+static void hud_timer_cb(lv_timer_t * timer)
+{
+    LV_UNUSED(timer);
+    char buf[512];
+    size_t len = sizeof(buf);
+    size_t pos = 0;
+
+    int64_t now_us = esp_timer_get_time();
+    uint32_t elapsed_ms = (uint32_t)((now_us - prev_us) / 1000);
+    if(elapsed_ms == 0) elapsed_ms = 1;
+    buf[0] = '\0';
+
+#if UI_PERF_HUD_TASK_STATS
+    pos = format_tasks(buf, len, pos);
+#endif
+
+    pos = hud_append(buf, len, pos, snprintf(buf + pos, len - pos, "Heap int %uk (blk %uk)  PSRAM %uk\n",
+                                             (unsigned)(heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024),
+                                             (unsigned)(heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL) / 1024),
+                                             (unsigned)(heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024)));
+
+    display_frame_stats_t frames;
+    display_get_frame_stats(&frames);
+    uint32_t d_frames = frames.frames - prev_frames.frames;
+    if(d_frames) {
+        uint32_t refresh_us = (frames.refresh_ms - prev_frames.refresh_ms) * 1000 / d_frames;
+        uint32_t flush_us = (frames.flush_us - prev_frames.flush_us) / d_frames;
+        uint32_t vsync_us = (frames.vsync_wait_us - prev_frames.vsync_wait_us) / d_frames;
+        uint32_t render_us = refresh_us > flush_us ? refresh_us - flush_us : 0;
+        pos = hud_append(buf, len, pos, snprintf(buf + pos, len - pos,
+                                                 "LVGL %lu fps  render %lu.%lu  flush %lu.%lu (vsync %lu.%lu) ms\n",
+                                                 (unsigned long)(d_frames * 1000 / elapsed_ms),
+                                                 (unsigned long)(render_us / 1000), (unsigned long)(render_us % 1000 / 100),
+                                                 (unsigned long)(flush_us / 1000), (unsigned long)(flush_us % 1000 / 100),
+                                                 (unsigned long)(vsync_us / 1000), (unsigned long)(vsync_us % 1000 / 100)));
+    }
+    else {
+        pos = hud_append(buf, len, pos, snprintf(buf + pos, len - pos, "LVGL idle\n"));
+    }
+    prev_frames = frames;
+
+    // Drop a trailing newline so the label keeps a tight box
+    if(pos > 0 && buf[pos - 1] == '\n') buf[pos - 1] = '\0';
+    prev_us = now_us;
+    lv_label_set_text(hud_label, buf);
+}
+
+static void hud_toggle_event_cb(lv_event_t * e)
+{
+    // Registered on every clickable object; act once even if the event bubbles
+    if(lv_event_get_code(e) == LV_EVENT_LONG_PRESSED && lv_event_get_target(e) == lv_event_get_current_target(e)) {
+        ui_perf_hud_toggle();
+    }
+}
+
+// LONG_PRESSED does not bubble, and the gauge and TCU containers cover the
+// screen, so the toggle goes on every clickable object below toggle_obj
+static void hud_attach_toggle(lv_obj_t * obj)
+{
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_CLICKABLE)) {
+        lv_obj_add_event_cb(obj, hud_toggle_event_cb, LV_EVENT_LONG_PRESSED, NULL);
+    }
+    uint32_t cnt = lv_obj_get_child_cnt(obj);
+    for(uint32_t i = 0; i < cnt; i++) {
+        hud_attach_toggle(lv_obj_get_child(obj, i));
+    }
+}
+
+void ui_perf_hud_init(lv_obj_t * toggle_obj)
+{
+    if(hud_label) return;
+
+    hud_label = lv_label_create(lv_layer_top());
+    lv_obj_align(hud_label, LV_ALIGN_TOP_LEFT, 8, 8);
+    lv_obj_set_style_text_font(hud_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(hud_label, lv_color_hex(0x00FF80), 0);
+    lv_obj_set_style_bg_color(hud_label, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(hud_label, LV_OPA_70, 0);
+    lv_obj_set_style_pad_all(hud_label, 6, 0);
+    lv_obj_set_style_radius(hud_label, 4, 0);
+    lv_obj_clear_flag(hud_label, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(hud_label, LV_OBJ_FLAG_HIDDEN);
+
+    hud_timer = lv_timer_create(hud_timer_cb, UI_PERF_HUD_PERIOD_MS, NULL);
+    lv_timer_pause(hud_timer);
+
+    if(toggle_obj) {
+        hud_attach_toggle(toggle_obj);
+    }
+
+#if !UI_PERF_HUD_TASK_STATS
+    ESP_LOGW(TAG, "FreeRTOS run-time stats disabled, per-task CPU not shown");
+#endif
+}
+
+void ui_perf_hud_set_visible(bool visible)
+{
+    if(!hud_label) return;
+
+    if(visible) {
+        // Prime the baselines so the first update covers one period, not the time hidden
+        prev_us = esp_timer_get_time();
+        display_get_frame_stats(&prev_frames);
+#if UI_PERF_HUD_TASK_STATS
+        prev_total_runtime = 0;
+        format_tasks(NULL, 0, 0);   // Baseline only, prints nothing
+#endif
+        lv_label_set_text(hud_label, "...");
+        lv_obj_clear_flag(hud_label, LV_OBJ_FLAG_HIDDEN);
+        lv_timer_reset(hud_timer);
+        lv_timer_resume(hud_timer);
+    }
+    else {
+        lv_timer_pause(hud_timer);
+        lv_obj_add_flag(hud_label, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+void ui_perf_hud_toggle(void)
+{
+    if(!hud_label) return;
+    ui_perf_hud_set_visible(lv_obj_has_flag(hud_label, LV_OBJ_FLAG_HIDDEN));
+}
+
@@ -0,0 +1,29 @@
+#ifndef _UI_PERF_HUD_H
+#define _UI_PERF_HUD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+#define UI_PERF_HUD_PERIOD_MS   500     // 2 Hz
+#define UI_PERF_HUD_TOP_TASKS   5
+#define UI_PERF_HUD_MAX_TASKS   32
+
+// Diagnostics overlay on the top layer: per-task CPU, internal/PSRAM heap,
+// LVGL render vs flush time. CAN frames/s, drops, WebSocket clients and
+// TX bytes/s are not shown: this app builds no CAN or WiFi code to count them.
+// Hidden at start; a long press anywhere on toggle_obj (usually the screen)
+// or its clickable children, as they exist at init, shows or hides it.
+// While hidden its timer is paused and nothing is sampled.
+void ui_perf_hud_init(lv_obj_t * toggle_obj);
+
+void ui_perf_hud_set_visible(bool visible);
+void ui_perf_hud_toggle(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
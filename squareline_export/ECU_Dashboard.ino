@@ -34,11 +34,27 @@
 #include <SPI.h>
 #include <driver/twai.h>  // ESP32 built-in CAN (TWAI) driver
 #include <WiFi.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "ecu_can_filter.h"
+#include "ecu_latency.h"
+#include "ecu_can_supervisor.h"
+#include "ecu_can_spec.h"      // Frame layouts shared with the firmware decoder
+#include "ecu_can_bus.h"
+#include "ecu_can_tx.h"        // Non-blocking TX queue, sent by its own task
+#include "ecu_sim.h"           // Seeded engine/turbo model sending spec frames
+#include "ecu_telemetry.h"     // Binary serial records, decoded by host/ecu_tlm_decode.c
+#include "ecu_decimate.h"      // History chart reduction, PIE kernel on ESP32-S3
 
 // Hardware Configuration
 #define TFT_WIDTH  800
 #define TFT_HEIGHT 480
 #define TFT_BL_PIN 32
+// 1 = DMA flush: one draw buffer is sent while LVGL renders into the other;
+// 0 = blocking pushColors (baseline for the FPS comparison)
+#define TFT_DMA_FLUSH 1
 
 // CAN Bus Configuration using ESP32 TWAI (CAN)
 #define CAN_TX_PIN   21  // GPIO21 -> TJA1051 CTX
@@ -46,10 +62,26 @@
 #define CAN_SPEED    TWAI_TIMING_CONFIG_500KBPS()  // 500 кбит/с
 #define CAN_SPEED_1M TWAI_TIMING_CONFIG_1MBPS()    // 1 Мбит/с (если нужно)
 
-// CAN Message IDs
-#define TCU_CAN_ID     0x440
-#define ECU_CAN_ID     0x380  
-#define BOOST_CAN_ID   0x200
+// CAN Message IDs (layouts in ecu_can_spec.h)
+#define TCU_CAN_ID     ECU_CAN_ID_TCU
+#define ECU_CAN_ID     ECU_CAN_ID_ENGINE
+#define BOOST_CAN_ID   ECU_CAN_ID_BOOST_CONTROL
+
+// IDs handled by processCANMessage(); the acceptance filter is derived from this list
+const uint32_t decodedCanIds[] = {TCU_CAN_ID, ECU_CAN_ID, BOOST_CAN_ID};
+
+// 1 = hardware acceptance filter, 0 = accept all (baseline for comparing RX load)
+#define CAN_HW_FILTER    1
+// Binary serial telemetry at boot (Serial '0'-'3' at runtime): ECU_TLM_LEVEL_FRAMES
+// records every received frame without printf; OFF keeps Serial plain text
+#define SERIAL_TLM_LEVEL ECU_TLM_LEVEL_OFF
+#define CAN_STATS_INTERVAL 5000  // ms between RX statistics reports
+// 1 = feed simulated ECU/TCU frames (ecu_sim.c) into the RX path while the bus has
+// carried no decoded frame for CAN_SIM_IDLE_MS; live traffic always wins. Same seed,
+// same traffic
+#define CAN_SIMULATOR    1
+#define CAN_SIM_SEED     1
+#define CAN_SIM_IDLE_MS  1000   // Silence before the simulator takes over
 
 // Display and LVGL
 TFT_eSPI tft = TFT_eSPI();
@@ -63,16 +95,77 @@ struct ECUData {
   uint16_t targetBoost;      // kPa (100-250)
   bool     tcuProtection;    // TCU protection active
   bool     tcuLimpMode;      // TCU limp mode
-  uint8_t  torqueRequest;    // % (0-100)
+  uint8_t  torqueRequest;    // % of ECU_TORQUE_FULL_SCALE_NM (0-100)
 };
 
 ECUData ecuData = {150, 45, 68, 3500, 180, false, false, 75};
 
-// Timing
-unsigned long lastCanUpdate = 0;
-unsigned long lastDisplayUpdate = 0;
-const unsigned long CAN_UPDATE_INTERVAL = 50;    // 20Hz
-const unsigned long DISPLAY_UPDATE_INTERVAL = 50; // 20Hz
+// Written by the CAN task, copied by the UI task
+portMUX_TYPE ecuDataLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Timing: LVGL time comes from a hardware timer, not from counting loop
+// iterations, and CAN, gauge updates and rendering run as separate tasks
+// on fixed periods, so a slow frame no longer slows animations or
+// staleness timeouts down
+#define LVGL_TICK_MS             2      // esp_timer period feeding lv_tick_inc()
+#define CAN_TASK_PERIOD_MS       5      // RX queue holds 10 frames: 50ms at 200 frames/s
+#define UI_TASK_PERIOD_MS        50     // Gauge updates, 20Hz
+#define LVGL_TASK_MAX_DELAY_MS   30     // Upper bound between lv_timer_handler() calls
+#define LVGL_TASK_MIN_DELAY_MS   1
+#define TIMING_STATS_INTERVAL    10000  // ms between loop-time and tick-drift reports
+
+#define CAN_TASK_PRIORITY        5
+#define LVGL_TASK_PRIORITY       3
+#define UI_TASK_PRIORITY         2
+#define CAN_TASK_CORE            0      // Away from rendering
+#define UI_CORE                  1      // LVGL and gauge updates share a core
+#define CAN_TASK_STACK           4096
+#define LVGL_TASK_STACK          8192
+#define UI_TASK_STACK            4096
+
+// LVGL is not thread-safe: every lv_* call outside the LVGL task takes this
+SemaphoreHandle_t lvglMutex = NULL;
+esp_timer_handle_t lvglTickTimer = NULL;
+
+// Per-task loop time, reset every TIMING_STATS_INTERVAL
+struct TaskTiming {
+  const char* name;
+  uint32_t runs;
+  uint32_t busyUs;
+  uint32_t maxUs;
+  uint32_t overruns;             // Runs that took longer than the task period
+};
+
+TaskTiming canTiming = {"can"};
+TaskTiming uiTiming = {"ui"};
+TaskTiming lvglTiming = {"lvgl"};
+portMUX_TYPE timingLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Display flush statistics: refreshes reaching the panel, time flush_cb blocked LVGL
+bool tftDma = false;
+uint32_t displayFrames = 0;
+uint32_t flushAreas = 0;
+uint32_t flushBusyUs = 0;
+
+// CAN RX statistics (reset every CAN_STATS_INTERVAL)
+ecu_can_filter_t canFilter;
+uint32_t canRxAccepted = 0;      // Frames with a decoder
+uint32_t canRxDropped = 0;       // Frames dropped by the software filter
+uint32_t canRxPeakQueued = 0;    // Highest RX queue occupancy seen
+uint32_t canRxBusyUs = 0;        // Time spent draining and decoding
+
+// Simulated traffic, queued on an in-memory bus like the TWAI RX queue
+ecu_sim_t canSim;
+ecu_can_bus_t canSimBus;
+ecu_can_standin_t canSimStandin;
+volatile bool canSimOverboost = false;  // Serial 'o', applied by the CAN task that owns canSim
+uint32_t canLiveRxMs = 0;               // millis() of the last decoded bus frame
+bool canLiveSeen = false;
+
+// Telemetry task output; whole records per call, so text reports only appear between them
+void serialTelemetryWrite(const uint8_t* data, size_t len, void* ctx) {
+  Serial.write(data, len);
+}
 
 // WiFi Credentials (optional for logging)
 const char* ssid = "YOUR_WIFI_SSID";
@@ -82,6 +175,18 @@ void setup() {
   Serial.begin(115200);
   Serial.println("ECU Dashboard Starting...");
   
+  // Frame layouts must match the example frames of CAN_PROTOCOL_SPECIFICATION.md
+  static char specReport[256];
+  int specFailures = ecu_can_spec_check(specReport, sizeof(specReport));
+  if (specFailures) {
+    Serial.printf("CAN spec check: %d failures\n%s", specFailures, specReport);
+  }
+  
+  ecu_tlm_init(SERIAL_TLM_LEVEL);
+  if (ecu_tlm_start(serialTelemetryWrite, NULL) != ESP_OK) {
+    Serial.println("Telemetry task start failed");
+  }
+  
   // Initialize display
   initDisplay();
   
@@ -100,29 +205,151 @@ void setup() {
   // Initial data update
   updateDisplayValues();
   
+  // From here on LVGL is only touched under lvglMutex
+  startTasks();
+  
   Serial.println("ECU Dashboard Ready!");
 }
 
+// CAN, gauge updates and rendering run in their own tasks; the Arduino
+// loop only handles serial commands and the timing report
 void loop() {
-  unsigned long currentTime = millis();
+  // Serial commands: 'l' dumps the latency histograms, 'r' clears them,
+  // 's' prints the CAN controller, TX queue and telemetry status, 'b' simulates a bus-off,
+  // 'o' an overboost in the simulated traffic, '0'-'3' set the telemetry level,
+  // 'd' checks the decimation kernel against the scalar reference and times both
+  if (Serial.available()) {
+    handleSerialCommand(Serial.read());
+  }
   
-  // Read CAN messages
-  if (currentTime - lastCanUpdate >= CAN_UPDATE_INTERVAL) {
+  reportTimingStats();
+  delay(10);
+}
+
+// esp_timer callback: LVGL time advances with real time whatever the load
+void lvglTickCallback(void* arg) {
+  lv_tick_inc(LVGL_TICK_MS);
+}
+
+void recordTaskTiming(TaskTiming* t, uint32_t busyUs, uint32_t periodMs) {
+  portENTER_CRITICAL(&timingLock);
+  t->runs++;
+  t->busyUs += busyUs;
+  if (busyUs > t->maxUs) t->maxUs = busyUs;
+  if (busyUs > periodMs * 1000u) t->overruns++;
+  portEXIT_CRITICAL(&timingLock);
+}
+
+// Drain the RX queue on a fixed period; vTaskDelayUntil does not add the
+// time spent decoding to the period
+void canTask(void* arg) {
+  TickType_t lastWake = xTaskGetTickCount();
+  for (;;) {
+    uint32_t start = micros();
     readCANMessages();
-    lastCanUpdate = currentTime;
+    recordTaskTiming(&canTiming, micros() - start, CAN_TASK_PERIOD_MS);
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(CAN_TASK_PERIOD_MS));
   }
-  
-  // Update display
-  if (currentTime - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
+}
+
+void uiTask(void* arg) {
+  TickType_t lastWake = xTaskGetTickCount();
+  for (;;) {
+    uint32_t start = micros();
+    xSemaphoreTake(lvglMutex, portMAX_DELAY);
     updateDisplayValues();
-    lastDisplayUpdate = currentTime;
+    xSemaphoreGive(lvglMutex);
+    recordTaskTiming(&uiTiming, micros() - start, UI_TASK_PERIOD_MS);
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(UI_TASK_PERIOD_MS));
+  }
+}
+
+// Run LVGL timers and rendering, then sleep until the next LVGL timer is due
+void lvglTask(void* arg) {
+  for (;;) {
+    uint32_t start = micros();
+    xSemaphoreTake(lvglMutex, portMAX_DELAY);
+    uint32_t waitMs = lv_timer_handler();
+    xSemaphoreGive(lvglMutex);
+    recordTaskTiming(&lvglTiming, micros() - start, LVGL_TASK_MAX_DELAY_MS);
+    
+    if (waitMs > LVGL_TASK_MAX_DELAY_MS) waitMs = LVGL_TASK_MAX_DELAY_MS;
+    if (waitMs < LVGL_TASK_MIN_DELAY_MS) waitMs = LVGL_TASK_MIN_DELAY_MS;
+    vTaskDelay(pdMS_TO_TICKS(waitMs));
+  }
+}
+
+void startTasks() {
+  lvglMutex = xSemaphoreCreateMutex();
+  
+  const esp_timer_create_args_t tickArgs = {
+    .callback = lvglTickCallback,
+    .arg = NULL,
+    .dispatch_method = ESP_TIMER_TASK,
+    .name = "lv_tick",
+  };
+  if (esp_timer_create(&tickArgs, &lvglTickTimer) != ESP_OK ||
+      esp_timer_start_periodic(lvglTickTimer, LVGL_TICK_MS * 1000) != ESP_OK) {
+    Serial.println("LVGL tick timer start failed");
   }
   
-  // LVGL tick and task handler
-  lv_tick_inc(5);
-  lv_task_handler();
+  if (xTaskCreatePinnedToCore(canTask, "can_rx", CAN_TASK_STACK, NULL, CAN_TASK_PRIORITY, NULL, CAN_TASK_CORE) != pdPASS ||
+      xTaskCreatePinnedToCore(lvglTask, "lvgl", LVGL_TASK_STACK, NULL, LVGL_TASK_PRIORITY, NULL, UI_CORE) != pdPASS ||
+      xTaskCreatePinnedToCore(uiTask, "ui_update", UI_TASK_STACK, NULL, UI_TASK_PRIORITY, NULL, UI_CORE) != pdPASS) {
+    Serial.println("Task creation failed");
+  }
+}
+
+// Print per-task loop times and how far LVGL time is from hardware time
+void reportTimingStats() {
+  static int64_t startUs = 0;
+  static uint32_t startTick = 0;
+  static int64_t lastReportUs = 0;
+  static int32_t lastDriftMs = 0;
+  int64_t nowUs = esp_timer_get_time();
+  
+  if (startUs == 0) {
+    startUs = nowUs;
+    startTick = lv_tick_get();
+    lastReportUs = nowUs;
+    return;
+  }
+  if (nowUs - lastReportUs < TIMING_STATS_INTERVAL * 1000LL) return;
+  
+  TaskTiming t[3];
+  portENTER_CRITICAL(&timingLock);
+  t[0] = canTiming;
+  t[1] = uiTiming;
+  t[2] = lvglTiming;
+  canTiming.runs = canTiming.busyUs = canTiming.maxUs = canTiming.overruns = 0;
+  uiTiming.runs = uiTiming.busyUs = uiTiming.maxUs = uiTiming.overruns = 0;
+  lvglTiming.runs = lvglTiming.busyUs = lvglTiming.maxUs = lvglTiming.overruns = 0;
+  uint32_t frames = displayFrames;
+  uint32_t areas = flushAreas;
+  uint32_t flushUs = flushBusyUs;
+  displayFrames = flushAreas = flushBusyUs = 0;
+  portEXIT_CRITICAL(&timingLock);
+  
+  // Drift: LVGL ms elapsed minus hardware ms elapsed, since the tasks started
+  int32_t driftMs = (int32_t)(lv_tick_get() - startTick) - (int32_t)((nowUs - startUs) / 1000);
+  float elapsedUs = (float)(nowUs - lastReportUs);
+  
+  Serial.printf("Timing: tick drift %+ld ms (%+ld this interval), uptime %lu s\n",
+               (long)driftMs, (long)(driftMs - lastDriftMs), (unsigned long)((nowUs - startUs) / 1000000));
+  for (int i = 0; i < 3; i++) {
+    Serial.printf("  %-5s runs=%lu avg=%luus max=%luus overruns=%lu cpu=%.1f%%\n",
+                 t[i].name, (unsigned long)t[i].runs,
+                 (unsigned long)(t[i].runs ? t[i].busyUs / t[i].runs : 0),
+                 (unsigned long)t[i].maxUs, (unsigned long)t[i].overruns,
+                 t[i].busyUs * 100.0f / elapsedUs);
+  }
+  // Compare TFT_DMA_FLUSH 0/1 builds: fps should rise and flush cpu drop
+  Serial.printf("  flush %s fps=%.1f areas=%lu avg=%luus cpu=%.1f%%\n",
+               tftDma ? "dma" : "blocking", frames * 1000000.0f / elapsedUs, (unsigned long)areas,
+               (unsigned long)(areas ? flushUs / areas : 0), flushUs * 100.0f / elapsedUs);
   
-  delay(5);
+  lastDriftMs = driftMs;
+  lastReportUs = nowUs;
 }
 
 void initDisplay() {
@@ -133,6 +360,13 @@ void initDisplay() {
   tft.setRotation(3); // Landscape mode
   tft.fillScreen(TFT_BLACK);
   
+#if TFT_DMA_FLUSH
+  // LVGL renders RGB565 little-endian; pushImageDMA swaps in the draw buffer
+  tft.setSwapBytes(true);
+  tftDma = tft.initDMA();
+  Serial.println(tftDma ? "TFT DMA flush enabled" : "TFT DMA unavailable, blocking flush");
+#endif
+  
   // Backlight control
   pinMode(TFT_BL_PIN, OUTPUT);
   digitalWrite(TFT_BL_PIN, HIGH);
@@ -145,7 +379,8 @@ void initLVGL() {
   
   lv_init();
   
-  // Display buffer allocation
+  // Display buffer allocation: two buffers so one renders while the other
+  // is sent; static arrays are in internal RAM, which SPI DMA can read
   static lv_color_t buf1[TFT_WIDTH * 60];
   static lv_color_t buf2[TFT_WIDTH * 60];
   static lv_disp_draw_buf_t draw_buf;
@@ -173,13 +408,42 @@ void initLVGL() {
 void displayFlush(lv_disp_drv_t * disp, const lv_area_t * area, lv_color_t * color_p) {
   uint32_t w = (area->x2 - area->x1 + 1);
   uint32_t h = (area->y2 - area->y1 + 1);
+  uint32_t start = micros();
+  
+  // First area of a refresh: rendering of the traced change has started reaching the panel
+  ecu_latency_mark(ECU_LAT_RENDER, start);
+  
+  if (tftDma) {
+    // pushImageDMA first waits for the previous transfer, which was sent
+    // from the other draw buffer, then queues this one and returns. Once
+    // LVGL has been told this buffer is free it renders into the other
+    // one, whose transfer is already complete. That wait is the transfer
+    // complete signal: TFT_eSPI has no DMA callback, and the two buffers
+    // make it safe to report ready as soon as the transfer is queued.
+    // The SPI bus stays claimed between transfers.
+    if (tft.getStartCount() == 0) {
+      tft.startWrite();
+    }
+    tft.pushImageDMA(area->x1, area->y1, w, h, (uint16_t*)&color_p->full);
+  } else {
+    tft.startWrite();
+    tft.setAddrWindow(area->x1, area->y1, w, h);
+    tft.pushColors((uint16_t*)&color_p->full, w * h, true);
+    tft.endWrite();
+  }
   
-  tft.startWrite();
-  tft.setAddrWindow(area->x1, area->y1, w, h);
-  tft.pushColors((uint16_t*)&color_p->full, w * h, true);
-  tft.endWrite();
-  
+  // SPI panel, no VSYNC stage; the trace ends with the last area (queued, with DMA)
+  bool last = lv_disp_flush_is_last(disp);
   lv_disp_flush_ready(disp);
+  if (last) {
+    ecu_latency_mark(ECU_LAT_FLUSH, micros());
+  }
+  
+  portENTER_CRITICAL(&timingLock);
+  flushAreas++;
+  flushBusyUs += micros() - start;
+  if (last) displayFrames++;
+  portEXIT_CRITICAL(&timingLock);
 }
 
 void initCAN() {
@@ -193,20 +457,30 @@ void initCAN() {
   // Configure TWAI timing for 500kbps (or 1Mbps)
   twai_timing_config_t t_config = CAN_SPEED;
   
-  // Configure TWAI filter to accept all messages (no filtering)
+  // Configure TWAI filter from the decoded IDs; fall back to accept-all
+  // (software filtering in processCANMessage) if the set cannot be covered
   twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
-  
-  // Install TWAI driver
-  esp_err_t result = twai_driver_install(&g_config, &t_config, &f_config);
-  if (result == ESP_OK) {
-    Serial.println("TJA1051 CAN Bus initialized successfully");
+  ecu_can_filter_compute(decodedCanIds, sizeof(decodedCanIds) / sizeof(decodedCanIds[0]), &canFilter);
+#if CAN_HW_FILTER
+  if (canFilter.hardware) {
+    f_config.acceptance_code = canFilter.acceptance_code;
+    f_config.acceptance_mask = canFilter.acceptance_mask;
+    f_config.single_filter = canFilter.single_filter;
+    Serial.printf("CAN filter: %s, code=0x%08lX mask=0x%08lX, %u IDs pass (%u without decoder)\n",
+                 canFilter.single_filter ? "single" : "dual",
+                 (unsigned long)canFilter.acceptance_code, (unsigned long)canFilter.acceptance_mask,
+                 canFilter.accepted_ids, canFilter.extra_ids);
   } else {
-    Serial.printf("TJA1051 CAN Bus initialization failed: %s\n", esp_err_to_name(result));
-    return;
+    Serial.println("CAN filter: ID set not coverable, software filtering only");
   }
-  
-  // Start TWAI driver
-  result = twai_start();
+#else
+  canFilter.hardware = false;
+  Serial.println("CAN filter: disabled, accepting all IDs");
+#endif
+  
+  // Install and start the TWAI driver; the supervisor task keeps it on the bus
+  // (bus-off recovery with backoff, reinstall if recovery stalls)
+  esp_err_t result = ecu_can_supervisor_start(&g_config, &t_config, &f_config, NULL);
   if (result == ESP_OK) {
     Serial.println("TJA1051 CAN Bus started");
   } else {
@@ -214,6 +488,13 @@ void initCAN() {
     return;
   }
   
+  // Commands go out from the TX task; the loop and the UI only queue them
+  ecu_can_tx_init();
+  result = ecu_can_tx_start(ecu_can_bus_twai());
+  if (result != ESP_OK) {
+    Serial.printf("CAN TX task start failed: %s\n", esp_err_to_name(result));
+  }
+  
   Serial.println("TJA1051 CAN Bus ready - listening on 500kbps");
 }
 
@@ -239,150 +520,288 @@ void initWiFi() {
 
 void readCANMessages() {
   twai_message_t rx_msg;
+  twai_status_info_t status_info;
+  unsigned long start = micros();
   
-  // Check for received CAN messages (non-blocking)
-  esp_err_t result = twai_receive(&rx_msg, 0);
-  if (result == ESP_OK) {
-    // Process received CAN message
-    processCANMessage(rx_msg.identifier, rx_msg.data_length_code, rx_msg.data);
-    
-    Serial.printf("CAN RX: ID=0x%03lX, DLC=%d, Data=", rx_msg.identifier, rx_msg.data_length_code);
-    for (int i = 0; i < rx_msg.data_length_code; i++) {
-      Serial.printf("%02X ", rx_msg.data[i]);
+  // Bus off or driver being reinstalled: nothing to read, the UI shows stale values
+  bool busUp = ecu_can_supervisor_driver_lock(0);
+  
+  if (busUp && twai_get_status_info(&status_info) == ESP_OK && status_info.msgs_to_rx > canRxPeakQueued) {
+    canRxPeakQueued = status_info.msgs_to_rx;
+  }
+  
+  // Drain the RX queue (non-blocking); one frame per call cannot keep up with 200 frames/s
+  while (busUp && twai_receive(&rx_msg, 0) == ESP_OK) {
+    uint32_t rxUs = micros();
+    if (processCANMessage(rx_msg.identifier, rx_msg.data_length_code, rx_msg.data, rxUs)) {
+      canRxAccepted++;
+      canLiveRxMs = millis();
+      canLiveSeen = true;
+    } else {
+      canRxDropped++;
     }
-    Serial.println();
+    logCANFrame(rx_msg.identifier, rx_msg.data_length_code, rx_msg.data,
+                rx_msg.extd ? ECU_CAN_FRAME_EXTENDED : 0, rxUs);
+  }
+  if (busUp) {
+    ecu_can_supervisor_driver_unlock();
   }
   
-  // Send simulated data if no real CAN data (for testing)
-  static unsigned long lastSimUpdate = 0;
-  if (millis() - lastSimUpdate > 1000) {
+  canRxBusyUs += micros() - start;
+  reportCANStats();
+  
+#if CAN_SIMULATOR
+  // Simulated ECU/TCU traffic through the same decoder (for testing without a car),
+  // only while the real bus is silent so it never overwrites live values
+  if (!canLiveSeen || millis() - canLiveRxMs > CAN_SIM_IDLE_MS) {
     simulateECUData();
-    lastSimUpdate = millis();
   }
+#endif
+}
+
+// Frame record for the telemetry task; a cheap level check when it is below FRAMES
+void logCANFrame(uint32_t id, uint8_t len, const uint8_t* data, uint8_t flags, uint32_t rxUs) {
+  if (ecu_tlm_get_level() < ECU_TLM_LEVEL_FRAMES) return;
+  
+  ecu_can_frame_t frame;
+  ecu_can_frame_set(&frame, id, data, len, flags);
+  ecu_tlm_frame(&frame, rxUs);
+}
+
+// Report RX queue occupancy and CAN CPU load; compare CAN_HW_FILTER 0/1 builds
+void reportCANStats() {
+  static unsigned long lastReport = 0;
+  unsigned long now = millis();
+  if (now - lastReport < CAN_STATS_INTERVAL) return;
+  
+  twai_status_info_t status_info;
+  if (twai_get_status_info(&status_info) == ESP_OK) {
+    float elapsedUs = (float)(now - lastReport) * 1000.0f;
+    Serial.printf("CAN RX: accepted=%lu dropped=%lu queue=%lu peak=%lu/10 missed=%lu overrun=%lu cpu=%.2f%%\n",
+                 (unsigned long)canRxAccepted, (unsigned long)canRxDropped,
+                 (unsigned long)status_info.msgs_to_rx, (unsigned long)canRxPeakQueued,
+                 (unsigned long)status_info.rx_missed_count, (unsigned long)status_info.rx_overrun_count,
+                 canRxBusyUs * 100.0f / elapsedUs);
+  }
+  
+  canRxAccepted = 0;
+  canRxDropped = 0;
+  canRxPeakQueued = 0;
+  canRxBusyUs = 0;
+  lastReport = now;
 }
 
-void processCANMessage(long unsigned int id, unsigned char len, unsigned char* data) {
+void handleSerialCommand(int cmd) {
+  static char dump[640];
+  ecu_can_sup_status_t sup;
+  ecu_can_tx_stats_t tx;
+  ecu_tlm_stats_t tlm;
+  
+  switch (cmd) {
+    case 'b':
+      ecu_can_supervisor_simulate_bus_off();
+      Serial.println("Simulated bus-off");
+      ecu_tlm_text("Simulated bus-off");
+      break;
+#if CAN_SIMULATOR
+    case 'o':
+      canSimOverboost = true;
+      Serial.println("Simulated overboost");
+      ecu_tlm_text("Simulated overboost");
+      break;
+#endif
+    case 's':
+      ecu_can_supervisor_get(&sup, ecu_can_supervisor_now_ms());
+      ecu_can_supervisor_format_text(&sup, dump, sizeof(dump));
+      Serial.println(dump);
+      ecu_can_tx_get_stats(&tx);
+      ecu_can_tx_format_text(&tx, dump, sizeof(dump));
+      Serial.println(dump);
+#if CAN_SIMULATOR
+      ecu_sim_format_text(&canSim, dump, sizeof(dump));
+      Serial.println(dump);
+#endif
+      ecu_tlm_get_stats(&tlm);
+      ecu_tlm_format_text(&tlm, dump, sizeof(dump));
+      Serial.println(dump);
+      break;
+    case 'l':
+      ecu_latency_format_text(dump, sizeof(dump));
+      Serial.print(dump);
+      break;
+    case 'r':
+      ecu_latency_reset();
+      Serial.println("Latency histograms cleared");
+      break;
+    case 'd':
+      runDecimateBenchmark();
+      break;
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+      ecu_tlm_set_level((ecu_tlm_level_t)(cmd - '0'));
+      Serial.printf("Telemetry level %d\n", cmd - '0');
+      break;
+  }
+}
+
+// PIE versus scalar decimation: chart-sized and odd bucket counts, so the
+// unaligned head/tail and short-block fallbacks are checked as well
+void runDecimateBenchmark() {
+  static const uint16_t cases[][2] = {{4096, 240}, {4096, 7}, {1000, 33}, {256, 1}};
+  ecu_decimate_bench_t result;
+  char line[160];
+  
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    ecu_decimate_benchmark(cases[i][0], cases[i][1], 50, &result);
+    ecu_decimate_bench_format_text(&result, line, sizeof(line));
+    Serial.println(line);
+  }
+}
+
+// Decode one frame; returns false if the ID has no decoder (software filter).
+// rxUs is the receive time, used to trace MAP changes through to the display.
+bool processCANMessage(long unsigned int id, unsigned char len, unsigned char* data, uint32_t rxUs) {
+  // Only this task writes ecuData: decode into a copy, publish it under the lock
+  ECUData next = ecuData;
+  bool mapChanged = false;
+  
   switch (id) {
     case TCU_CAN_ID: // TCU Data
-      if (len >= 4) {
-        ecuData.torqueRequest = data[0];
-        ecuData.tcuProtection = (data[1] & 0x01) != 0;
-        ecuData.tcuLimpMode = (data[1] & 0x02) != 0;
-        Serial.printf("TCU: Torque=%d%%, Protection=%d, Limp=%d\n", 
-                     ecuData.torqueRequest, ecuData.tcuProtection, ecuData.tcuLimpMode);
+      if (len >= ECU_CAN_DLC_TCU) {
+        next.torqueRequest = ecu_can_sig_get(ECU_SIG_TORQUE_REQUEST, data) * 100 / ECU_TORQUE_FULL_SCALE_NM;
+        next.tcuProtection = ecu_can_sig_get(ECU_SIG_TCU_PROTECTION, data) != 0;
+        next.tcuLimpMode = ecu_can_sig_get(ECU_SIG_TCU_LIMP, data) != 0;
       }
       break;
       
     case ECU_CAN_ID: // ECU Data
-      if (len >= 6) {
-        ecuData.engineRpm = (data[1] << 8) | data[0];
-        ecuData.mapPressure = (data[3] << 8) | data[2];
-        ecuData.tpsPosition = data[4];
-        Serial.printf("ECU: RPM=%d, MAP=%dkPa, TPS=%d%%\n", 
-                     ecuData.engineRpm, ecuData.mapPressure, ecuData.tpsPosition);
+      if (len >= ECU_CAN_DLC_ENGINE) {
+        next.engineRpm = ecu_can_sig_get(ECU_SIG_ENGINE_RPM, data);
+        next.mapPressure = (ecu_can_sig_get_tenths(ECU_SIG_MAP_PRESSURE, data) + 5) / 10;
+        next.tpsPosition = ecu_can_sig_get(ECU_SIG_TPS_POSITION, data);
+        mapChanged = next.mapPressure != ecuData.mapPressure;
       }
       break;
       
     case BOOST_CAN_ID: // Boost Control
-      if (len >= 4) {
-        ecuData.wastegatePos = data[0];
-        ecuData.targetBoost = (data[2] << 8) | data[1];
-        Serial.printf("Boost: Wastegate=%d%%, Target=%dkPa\n", 
-                     ecuData.wastegatePos, ecuData.targetBoost);
+      if (len >= ECU_CAN_DLC_BOOST_CONTROL) {
+        next.wastegatePos = ecu_can_sig_get(ECU_SIG_WASTEGATE_POSITION, data);
+        next.targetBoost = (ecu_can_sig_get_tenths(ECU_SIG_TARGET_BOOST, data) + 5) / 10;
       }
       break;
+      
+    default:
+      return false;
+  }
+  
+  portENTER_CRITICAL(&ecuDataLock);
+  ecuData = next;
+  portEXIT_CRITICAL(&ecuDataLock);
+  
+  if (mapChanged && ecu_latency_begin(rxUs)) {
+    ecu_latency_mark(ECU_LAT_DECODE, micros());
   }
+  return true;
 }
 
+// Simulated ECU traffic, encoded with the spec layouts and decoded by processCANMessage()
 void simulateECUData() {
-  // Simulate realistic ECU data for testing
-  static float rpmBase = 1000;
-  static bool rpmUp = true;
-  
-  // Simulate RPM sweep
-  if (rpmUp) {
-    rpmBase += 50;
-    if (rpmBase > 6000) rpmUp = false;
-  } else {
-    rpmBase -= 50;
-    if (rpmBase < 1000) rpmUp = true;
+  static bool started = false;
+  ecu_can_frame_t frame;
+  uint32_t now = millis();
+  
+  if (!started) {
+    ecu_can_standin_init(&canSimBus, &canSimStandin, false);
+    ecu_sim_init(&canSim, CAN_SIM_SEED, now);
+    started = true;
   }
-  
-  ecuData.engineRpm = rpmBase + random(-100, 100);
-  ecuData.mapPressure = map(ecuData.engineRpm, 1000, 6000, 100, 230) + random(-5, 5);
-  ecuData.tpsPosition = map(ecuData.engineRpm, 1000, 6000, 10, 90) + random(-10, 10);
-  ecuData.wastegatePos = map(ecuData.mapPressure, 100, 230, 0, 80) + random(-5, 5);
-  ecuData.targetBoost = ecuData.mapPressure + random(-10, 10);
-  
-  // Simulate TCU protection at high RPM
-  if (ecuData.engineRpm > 5500) {
-    ecuData.tcuProtection = true;
-  } else if (ecuData.engineRpm < 5000) {
-    ecuData.tcuProtection = false;
+  if (canSimOverboost) {
+    canSimOverboost = false;
+    ecu_sim_trigger_overboost(&canSim);
   }
   
-  // Simulate limp mode at very high RPM
-  ecuData.tcuLimpMode = (ecuData.engineRpm > 6200);
-  
-  // Constrain values
-  ecuData.mapPressure = constrain(ecuData.mapPressure, 100, 250);
-  ecuData.tpsPosition = constrain(ecuData.tpsPosition, 0, 100);
-  ecuData.wastegatePos = constrain(ecuData.wastegatePos, 0, 100);
-  ecuData.targetBoost = constrain(ecuData.targetBoost, 100, 250);
-  ecuData.engineRpm = constrain(ecuData.engineRpm, 0, 7000);
+  // The model waits while its bus is full, so drain and continue until it caught up
+  do {
+    ecu_sim_run(&canSim, &canSimBus, now);
+    while (ecu_can_bus_receive(&canSimBus, &frame, 0)) {
+      uint32_t rxUs = micros();
+      if (processCANMessage(frame.id, frame.len, frame.data, rxUs)) {
+        canRxAccepted++;
+      } else {
+        canRxDropped++;
+      }
+      ecu_tlm_frame(&frame, rxUs);
+    }
+  } while (canSim.now_ms != now);
 }
 
+// Called with lvglMutex held (UI task, or setup() before the tasks start)
 void updateDisplayValues() {
+  ECUData d;
+  portENTER_CRITICAL(&ecuDataLock);
+  d = ecuData;
+  portEXIT_CRITICAL(&ecuDataLock);
+  ecu_latency_mark(ECU_LAT_PUBLISH, micros());
+  
   // Update MAP Pressure gauge
-  ui_update_map_pressure(ecuData.mapPressure);
+  ui_update_map_pressure(d.mapPressure);
   
   // Update Wastegate gauge
-  ui_update_wastegate_position(ecuData.wastegatePos);
+  ui_update_wastegate_position(d.wastegatePos);
   
   // Update TPS gauge
-  ui_update_tps_position(ecuData.tpsPosition);
+  ui_update_tps_position(d.tpsPosition);
   
   // Update RPM gauge (with warning colors)
-  ui_update_engine_rpm(ecuData.engineRpm);
+  ui_update_engine_rpm(d.engineRpm);
   
   // Update Target Boost gauge
-  ui_update_target_boost(ecuData.targetBoost);
+  ui_update_target_boost(d.targetBoost);
   
   // Update TCU Status
-  ui_update_tcu_status(ecuData.tcuProtection, ecuData.tcuLimpMode);
+  ui_update_tcu_status(d.tcuProtection, d.tcuLimpMode);
+  ecu_latency_mark(ECU_LAT_UI_UPDATE, micros());
   
-  // Update connection status - check TWAI driver status
-  twai_status_info_t status_info;
-  esp_err_t status_result = twai_get_status_info(&status_info);
-  bool canConnected = (status_result == ESP_OK && status_info.state == TWAI_STATE_RUNNING);
+  // Update connection status from the supervisor; ghost the gauges while the bus is down
+  bool canConnected = ecu_can_supervisor_bus_usable();
   ui_update_connection_status(canConnected);
+  ui_gauges_set_stale(!canConnected);
+  
+  // Decoded values: a binary snapshot per update with telemetry on, else a text line every 2s
+  if (ecu_tlm_get_level() >= ECU_TLM_LEVEL_SNAPSHOT) {
+    ecu_data_fx_t fx = {};
+    fx.map_pressure = d.mapPressure * 10;
+    fx.target_boost = d.targetBoost * 10;
+    fx.engine_rpm = d.engineRpm;
+    fx.torque_request = (uint32_t)d.torqueRequest * ECU_TORQUE_FULL_SCALE_NM / 100;
+    fx.wastegate_position = d.wastegatePos;
+    fx.tps_position = d.tpsPosition;
+    fx.flags = (d.tcuProtection ? ECU_FX_FLAG_TCU_PROTECTION : 0) | (d.tcuLimpMode ? ECU_FX_FLAG_TCU_LIMP : 0);
+    ecu_tlm_snapshot(&fx, canConnected ? 0 : (1u << ECU_CH_COUNT) - 1, millis());
+    return;
+  }
   
-  // Debug output
   static unsigned long lastDebug = 0;
   if (millis() - lastDebug > 2000) {
     Serial.printf("Data: MAP=%dkPa, WG=%d%%, TPS=%d%%, RPM=%d, Target=%dkPa\n",
-                 ecuData.mapPressure, ecuData.wastegatePos, ecuData.tpsPosition,
-                 ecuData.engineRpm, ecuData.targetBoost);
+                 d.mapPressure, d.wastegatePos, d.tpsPosition,
+                 d.engineRpm, d.targetBoost);
     lastDebug = millis();
   }
 }
 
-void sendCANMessage(uint16_t id, uint8_t* data, uint8_t len) {
-  twai_message_t tx_msg;
-  tx_msg.identifier = id;
-  tx_msg.data_length_code = len;
-  tx_msg.flags = TWAI_MSG_FLAG_NONE;  // Standard frame
-  
-  for (int i = 0; i < len && i < 8; i++) {
-    tx_msg.data[i] = data[i];
-  }
-  
-  esp_err_t result = twai_transmit(&tx_msg, pdMS_TO_TICKS(1000));
-  if (result == ESP_OK) {
-    Serial.printf("CAN TX: ID=0x%03X sent successfully\n", id);
-  } else {
-    Serial.printf("CAN TX failed: %s\n", esp_err_to_name(result));
+// Queue a command frame; never blocks, the TX task puts it on the bus
+bool sendCANMessage(uint16_t id, uint8_t* data, uint8_t len, ecu_can_tx_class_t cls) {
+  ecu_can_frame_t frame;
+  ecu_can_frame_set(&frame, id, data, len > 8 ? 8 : len, 0);  // Standard frame
+  
+  if (!ecu_can_tx_submit(&frame, cls)) {
+    Serial.printf("CAN TX queue full, ID=0x%03X dropped\n", id);
+    return false;
   }
+  return true;
 }
 
 // Touch input handler (optional)
@@ -0,0 +1,456 @@
+/**
+ * Headless render benchmark for the ECU Dashboard UI
+ * Runs the SquareLine UI (ui_screens.c, ui_events.c, gauges, history,
+ * diagnostics) against LVGL 8.3 with an in-memory 800x480 RGB565 display
+ * that uses the same two 60-line draw buffers as ECU_Dashboard.ino. ECU
+ * data comes from the seeded ecu_sim model or a candump log, through the
+ * real decode path. Time is simulated in 5 ms loop ticks, so a run is
+ * repeatable: only the measured CPU time varies between machines.
+ *
+ * Per refresh it records the lv_timer_handler() time (UI timers, layout,
+ * render, flush copy) and the rendered area; at the end it prints
+ * percentiles, the mean invalidated area and the LVGL heap high-water mark.
+ * With -g it exits with status 1 if p99 exceeds the budget, so it can gate
+ * UI performance changes.
+ *
+ * Build (from squareline_export/, with an LVGL v8.3 checkout in $LVGL_DIR;
+ * do not add host/ to the include path, its lvgl.h is a tick-only shim):
+ *   cc -std=gnu99 -O2 -DLV_CONF_INCLUDE_SIMPLE -I . -I "$LVGL_DIR" -o ui_bench \
+ *      bench/ui_bench.c ui_screens.c ui_events.c ui_gauges.c ui_history.c \
+ *      ui_diagnostics.c ecu_can_integration.c ecu_can_bus.c ecu_can_spec.c \
+ *      ecu_can_filter.c ecu_can_supervisor.c ecu_can_tx.c ecu_isotp.c ecu_sim.c \
+ *      ecu_history.c ecu_stats.c ecu_bus_stats.c ecu_latency.c ecu_decimate.c \
+ *      $(find "$LVGL_DIR/src" -name '*.c') -lm
+ *
+ * ui_complete.c is the single-file variant of ui_screens.c (same symbols);
+ * swap it in to compare the two layouts.
+ *
+ * Run:
+ *   ./ui_bench -t 60                      60 simulated seconds, seed 1
+ *   ./ui_bench -l drive.log -c frames.csv replay a candump -l log, per-frame CSV
+ *   ./ui_bench -S diag -p png -n 100      diagnostics screen, PNG every 100th frame
+ *   ./ui_bench -g 8000                    fail if p99 frame time exceeds 8 ms
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "ui.h"
+#include "ecu_can_integration.h"
+
+#define BENCH_HOR_RES           800
+#define BENCH_VER_RES           480
+#define BENCH_BUF_LINES         60      // Draw buffer height, as in ECU_Dashboard.ino
+#define BENCH_TICK_MS           5u      // loop() period on the device
+#define BENCH_PUBLISH_MS        50u     // main_integration_example.c UPDATE_PERIOD_MS
+#define BENCH_DATA_TIMEOUT_MS   500u
+#define BENCH_MAX_FRAMES        (1 << 20)
+#define BENCH_LOG_LINE          256
+
+typedef struct {
+    uint32_t time_ms;            // Simulated time of the refresh
+    uint32_t handler_us;         // lv_timer_handler() wall time
+    uint32_t px;                 // Pixels rendered
+} bench_frame_t;
+
+static lv_color_t framebuffer[BENCH_HOR_RES * BENCH_VER_RES];
+static lv_color_t draw_buf1[BENCH_HOR_RES * BENCH_BUF_LINES];
+static lv_color_t draw_buf2[BENCH_HOR_RES * BENCH_BUF_LINES];
+
+static bench_frame_t* frames;
+static uint32_t frame_count = 0;
+static bool refreshed = false;
+static uint32_t refreshed_px = 0;
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+// Copy the rendered area into the framebuffer, as the panel would
+static void bench_flush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p)
+{
+    lv_coord_t w = lv_area_get_width(area);
+
+    for (lv_coord_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&framebuffer[y * BENCH_HOR_RES + area->x1], color_p, (size_t)w * sizeof(lv_color_t));
+        color_p += w;
+    }
+    lv_disp_flush_ready(drv);
+}
+
+// Called by LVGL after every refresh with the number of rendered pixels
+static void bench_monitor(lv_disp_drv_t* drv, uint32_t time, uint32_t px)
+{
+    (void)drv;
+    (void)time;
+    refreshed = true;
+    refreshed_px += px;
+}
+
+// PNG without zlib: RGB8, filter 0, deflate "stored" blocks
+static uint32_t crc_table[256];
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t* p, size_t len)
+{
+    if (crc_table[1] == 0) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            crc_table[n] = c;
+        }
+    }
+    crc = ~crc;
+    while (len--) crc = crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void put_be32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void png_chunk(FILE* f, const char* type, const uint8_t* data, size_t len)
+{
+    uint8_t hdr[8];
+    uint8_t crc[4];
+
+    put_be32(hdr, (uint32_t)len);
+    memcpy(hdr + 4, type, 4);
+    fwrite(hdr, 1, 8, f);
+    if (len) fwrite(data, 1, len, f);
+    put_be32(crc, crc32_update(crc32_update(0, hdr + 4, 4), data, len));
+    fwrite(crc, 1, 4, f);
+}
+
+static bool write_png(const char* path)
+{
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    const size_t row_len = 1 + BENCH_HOR_RES * 3;
+    const size_t raw_len = row_len * BENCH_VER_RES;
+    const size_t blocks = (raw_len + 65534) / 65535;
+    uint8_t* raw = malloc(raw_len);
+    uint8_t* z = malloc(2 + raw_len + blocks * 5 + 4);
+    FILE* f = fopen(path, "wb");
+
+    if (raw == NULL || z == NULL || f == NULL) {
+        free(raw);
+        free(z);
+        if (f) fclose(f);
+        return false;
+    }
+
+    for (int y = 0; y < BENCH_VER_RES; y++) {
+        uint8_t* row = raw + (size_t)y * row_len;
+        row[0] = 0;
+        for (int x = 0; x < BENCH_HOR_RES; x++) {
+            lv_color32_t c;
+            c.full = lv_color_to32(framebuffer[y * BENCH_HOR_RES + x]);
+            row[1 + 3 * x] = c.ch.red;
+            row[2 + 3 * x] = c.ch.green;
+            row[3 + 3 * x] = c.ch.blue;
+        }
+    }
+
+    size_t zlen = 0;
+    uint32_t a = 1, b = 0;
+    z[zlen++] = 0x78;
+    z[zlen++] = 0x01;
+    for (size_t off = 0; off < raw_len; off += 65535) {
+        uint16_t n = (uint16_t)(raw_len - off < 65535 ? raw_len - off : 65535);
+        z[zlen++] = off + n >= raw_len ? 1 : 0;
+        z[zlen++] = (uint8_t)n;
+        z[zlen++] = (uint8_t)(n >> 8);
+        z[zlen++] = (uint8_t)~n;
+        z[zlen++] = (uint8_t)(~n >> 8);
+        memcpy(z + zlen, raw + off, n);
+        zlen += n;
+    }
+    for (size_t i = 0; i < raw_len; i++) {
+        a = (a + raw[i]) % 65521u;
+        b = (b + a) % 65521u;
+    }
+    put_be32(z + zlen, (b << 16) | a);
+    zlen += 4;
+
+    uint8_t ihdr[13];
+    put_be32(ihdr, BENCH_HOR_RES);
+    put_be32(ihdr + 4, BENCH_VER_RES);
+    ihdr[8] = 8;        // Bit depth
+    ihdr[9] = 2;        // RGB
+    ihdr[10] = 0;
+    ihdr[11] = 0;
+    ihdr[12] = 0;
+
+    fwrite(signature, 1, sizeof(signature), f);
+    png_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    png_chunk(f, "IDAT", z, zlen);
+    png_chunk(f, "IEND", NULL, 0);
+    bool ok = fclose(f) == 0;
+    free(raw);
+    free(z);
+    return ok;
+}
+
+// candump -l line: "(1436509052.249713) vcan0 380#0102030405060708"
+static bool parse_candump(const char* line, double* ts, uint32_t* id, uint8_t* data, uint8_t* len)
+{
+    char payload[BENCH_LOG_LINE];
+    unsigned int can_id;
+
+    if (sscanf(line, " (%lf) %*s %x#%255s", ts, &can_id, payload) != 3) {
+        // Remote frames and frames without data
+        if (sscanf(line, " (%lf) %*s %x#", ts, &can_id) != 2) return false;
+        payload[0] = '\0';
+    }
+    if (payload[0] == '#' || payload[0] == 'R') return false;   // CAN FD and remote frames
+
+    size_t hex = strlen(payload);
+    if (hex % 2 || hex / 2 > ECU_CAN_CLASSIC_MAX_LEN) return false;
+    for (size_t i = 0; i < hex / 2; i++) {
+        unsigned int byte;
+        if (sscanf(payload + 2 * i, "%2x", &byte) != 1) return false;
+        data[i] = (uint8_t)byte;
+    }
+    *id = can_id & 0x1FFFFFFFu;
+    *len = (uint8_t)(hex / 2);
+    return true;
+}
+
+static int compare_u32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t percentile(const uint32_t* sorted, size_t count, uint8_t percent)
+{
+    if (count == 0) return 0;
+    size_t rank = (count * percent + 99) / 100;
+    return sorted[rank ? rank - 1 : 0];
+}
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [-t SECONDS] [-s SEED] [-l CANDUMP] [-S main|settings|diag]\n"
+            "          [-c CSV] [-p DIR] [-n EVERY] [-g P99_US]\n"
+            "  -t SECONDS simulated run time (default 30; a log runs to its end)\n"
+            "  -s SEED    ecu_sim seed (default %u)\n"
+            "  -l FILE    replay a candump -l log instead of the simulator\n"
+            "  -S SCREEN  screen to benchmark (default main)\n"
+            "  -c FILE    per-frame CSV: frame,time_ms,handler_us,px\n"
+            "  -p DIR     dump PNG frames into DIR\n"
+            "  -n EVERY   with -p, every EVERY-th frame (default 1)\n"
+            "  -g P99_US  exit 1 if the p99 frame time exceeds P99_US\n",
+            prog, ECU_SIM_SEED);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t duration_s = 30;
+    uint32_t seed = ECU_SIM_SEED;
+    const char* log_path = NULL;
+    const char* screen = "main";
+    const char* csv_path = NULL;
+    const char* png_dir = NULL;
+    uint32_t png_every = 1;
+    uint32_t gate_us = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:s:l:S:c:p:n:g:h")) != -1) {
+        switch (opt) {
+            case 't': duration_s = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'l': log_path = optarg; break;
+            case 'S': screen = optarg; break;
+            case 'c': csv_path = optarg; break;
+            case 'p': png_dir = optarg; break;
+            case 'n': png_every = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'g': gate_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (png_every == 0 || (strcmp(screen, "main") && strcmp(screen, "settings") && strcmp(screen, "diag"))) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE* log = NULL;
+    if (log_path && (log = fopen(log_path, "r")) == NULL) {
+        fprintf(stderr, "%s: %s\n", log_path, strerror(errno));
+        return 1;
+    }
+    FILE* csv = NULL;
+    if (csv_path) {
+        if ((csv = fopen(csv_path, "w")) == NULL) {
+            fprintf(stderr, "%s: %s\n", csv_path, strerror(errno));
+            return 1;
+        }
+        fprintf(csv, "frame,time_ms,handler_us,px\n");
+    }
+    frames = malloc(BENCH_MAX_FRAMES * sizeof(bench_frame_t));
+    if (frames == NULL) return 1;
+
+    // Display: same resolution and draw buffers as the device
+    lv_init();
+    static lv_disp_draw_buf_t draw_buf;
+    lv_disp_draw_buf_init(&draw_buf, draw_buf1, draw_buf2, BENCH_HOR_RES * BENCH_BUF_LINES);
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = BENCH_HOR_RES;
+    disp_drv.ver_res = BENCH_VER_RES;
+    disp_drv.flush_cb = bench_flush;
+    disp_drv.monitor_cb = bench_monitor;
+    disp_drv.draw_buf = &draw_buf;
+    lv_disp_drv_register(&disp_drv);
+
+    // Application, as in main_integration_example.c
+    can_interface_init();
+    ui_init();
+    ui_events_init();
+    if (strcmp(screen, "settings") == 0) {
+        ui_screen_load_lazy(&ui_SettingsScreen, ui_SettingsScreen_screen_init, LV_SCR_LOAD_ANIM_NONE, 0);
+    } else if (strcmp(screen, "diag") == 0) {
+        ui_screen_load_lazy(&ui_DiagnosticsScreen, ui_DiagnosticsScreen_screen_init, LV_SCR_LOAD_ANIM_NONE, 0);
+    }
+
+    static ecu_sim_t sim;
+    static ecu_can_standin_t standin;
+    ecu_can_bus_t bus;
+    if (log == NULL) {
+        ecu_can_standin_init(&bus, &standin, false);
+        ecu_sim_init(&sim, seed, lv_tick_get());
+    }
+
+    // Log replay state: the next frame, held until its time comes
+    char line[BENCH_LOG_LINE];
+    double log_start = -1.0;
+    double log_ts = 0.0;
+    uint32_t log_id = 0;
+    uint8_t log_data[ECU_CAN_CLASSIC_MAX_LEN];
+    uint8_t log_len = 0;
+    bool log_pending = false;
+    bool log_done = false;
+
+    uint32_t elapsed_ms = 0;
+    uint32_t next_publish_ms = 0;
+    uint64_t cpu_us = 0;
+    char png_path[512];
+
+    while (log ? !log_done : elapsed_ms < duration_s * 1000u) {
+        lv_tick_inc(BENCH_TICK_MS);
+        elapsed_ms += BENCH_TICK_MS;
+        uint32_t now = lv_tick_get();
+
+        // Feed the ECU traffic due by now through the decoders
+        if (log) {
+            for (;;) {
+                if (!log_pending) {
+                    if (fgets(line, sizeof(line), log) == NULL) {
+                        log_done = true;
+                        break;
+                    }
+                    log_pending = parse_candump(line, &log_ts, &log_id, log_data, &log_len);
+                    if (!log_pending) continue;
+                    if (log_start < 0.0) log_start = log_ts;
+                }
+                if ((log_ts - log_start) * 1000.0 > (double)elapsed_ms) break;
+                can_message_handler(log_id, log_data, log_len);
+                log_pending = false;
+            }
+        } else {
+            do {
+                ecu_sim_run(&sim, &bus, now);
+            } while (can_bus_poll(&bus, ECU_CAN_STANDIN_DEPTH) && sim.now_ms != now);
+        }
+        can_interface_task();
+
+        if ((int32_t)(elapsed_ms - next_publish_ms) >= 0) {
+            next_publish_ms = elapsed_ms + BENCH_PUBLISH_MS;
+            if (ecu_data_is_fresh(BENCH_DATA_TIMEOUT_MS)) {
+                ui_set_ecu_data_fx(ecu_get_current_data_fx());
+                ui_set_connection_status(true, "Connected");
+                ui_set_stale_channels(ecu_stale_channels());
+            } else {
+                ui_set_connection_status(false, "No Data");
+                ui_set_stale_channels((1u << ECU_CH_COUNT) - 1u);
+            }
+        }
+
+        refreshed = false;
+        refreshed_px = 0;
+        uint64_t t0 = now_us();
+        lv_timer_handler();
+        uint32_t handler_us = (uint32_t)(now_us() - t0);
+        cpu_us += handler_us;
+        if (!refreshed) continue;
+
+        if (frame_count < BENCH_MAX_FRAMES) {
+            frames[frame_count].time_ms = elapsed_ms;
+            frames[frame_count].handler_us = handler_us;
+            frames[frame_count].px = refreshed_px;
+        }
+        if (csv) fprintf(csv, "%u,%u,%u,%u\n", frame_count, elapsed_ms, handler_us, refreshed_px);
+        if (png_dir && frame_count % png_every == 0) {
+            snprintf(png_path, sizeof(png_path), "%s/frame_%06u.png", png_dir, frame_count);
+            if (!write_png(png_path)) {
+                fprintf(stderr, "%s: %s\n", png_path, strerror(errno));
+                png_dir = NULL;
+            }
+        }
+        frame_count++;
+    }
+
+    // Summary
+    uint32_t n = frame_count < BENCH_MAX_FRAMES ? frame_count : BENCH_MAX_FRAMES;
+    uint32_t* handler = malloc((n ? n : 1) * sizeof(uint32_t));
+    uint64_t px_total = 0;
+    uint32_t full_frames = 0;
+    if (handler == NULL) return 1;
+    for (uint32_t i = 0; i < n; i++) {
+        handler[i] = frames[i].handler_us;
+        px_total += frames[i].px;
+        if (frames[i].px >= BENCH_HOR_RES * BENCH_VER_RES) full_frames++;
+    }
+    qsort(handler, n, sizeof(uint32_t), compare_u32);
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    uint32_t p99 = percentile(handler, n, 99);
+
+    printf("screen %s, %s, %u.%03u s simulated, %u frames (%u full screen)\n",
+           screen, log ? log_path : "simulator", elapsed_ms / 1000, elapsed_ms % 1000, frame_count, full_frames);
+    printf("frame time us: p50 %u p90 %u p99 %u max %u; CPU %.1f%% of simulated time\n",
+           percentile(handler, n, 50), percentile(handler, n, 90), p99, n ? handler[n - 1] : 0,
+           elapsed_ms ? (double)cpu_us / (elapsed_ms * 10.0) : 0.0);
+    printf("rendered area: mean %llu px/frame (%.1f%% of screen)\n",
+           (unsigned long long)(n ? px_total / n : 0),
+           n ? 100.0 * (double)px_total / n / (BENCH_HOR_RES * BENCH_VER_RES) : 0.0);
+    printf("LVGL heap: %u used, %u high-water of %u bytes, %u%% fragmented\n",
+           (unsigned)(mon.total_size - mon.free_size), (unsigned)mon.max_used,
+           (unsigned)mon.total_size, (unsigned)mon.frag_pct);
+
+    if (csv) fclose(csv);
+    if (log) fclose(log);
+    free(handler);
+    free(frames);
+
+    if (gate_us && p99 > gate_us) {
+        printf("FAIL: p99 %u us exceeds %u us\n", p99, gate_us);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,301 @@
+/**
+ * CAN bus instrumentation for the ECU Dashboard
+ * The RX path is the only writer: it accumulates one window and publishes
+ * it under a sequence counter; readers copy the published window
+ */
+
+#include "ecu_bus_stats.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "esp_timer.h"
+#else
+#include <time.h>
+#endif
+
+typedef struct {
+    uint32_t can_id;
+    uint32_t period_us;          // 0 = no expected rate
+    uint16_t expected_hz;
+    bool seen;
+    volatile uint32_t last_us;
+    uint32_t frames;
+    uint32_t missed;
+    // Current window
+    uint32_t win_frames;
+    uint32_t win_intervals;
+    uint32_t win_interval_sum;
+    uint32_t win_interval_min;
+    uint32_t win_interval_max;
+    uint32_t win_jitter;
+} id_state_t;
+
+static id_state_t id_states[ECU_BUS_STATS_MAX_IDS];
+static uint8_t id_count = 0;
+static uint32_t bus_bitrate = ECU_BUS_STATS_BITRATE;
+
+static bool window_open = false;
+static uint32_t window_start_us = 0;
+static uint32_t window_frames = 0;
+static uint32_t window_other = 0;
+static uint32_t window_bits = 0;
+
+static volatile uint32_t published_seq = 0;
+static volatile uint32_t published_us = 0;
+static ecu_bus_snapshot_t published;
+static volatile uint32_t error_counts[ECU_BUS_STATS_ERROR_KINDS];
+
+// Worst-case bits on the wire incl. stuffing and interframe space. Payloads
+// over 8 bytes are CAN FD: wider CRC, stuff count and FDF/BRS/ESI, counted at
+// the nominal bit rate (an upper bound when the data phase is switched)
+static uint32_t frame_bits(uint8_t len, bool extended)
+{
+    uint32_t data_bits = (uint32_t)len * 8u;
+    uint32_t stuffed = (extended ? 54u : 34u) + data_bits;
+    if (len > 8) stuffed += 12u;
+    return stuffed + 13u + (stuffed - 1u) / 4u;
+}
+
+static id_state_t* find_id(uint32_t can_id)
+{
+    for (uint8_t i = 0; i < id_count; i++) {
+        if (id_states[i].can_id == can_id) return &id_states[i];
+    }
+    return NULL;
+}
+
+// Expected frames missing from an interval of the given length
+static uint32_t missed_in(uint32_t interval_us, uint32_t period_us)
+{
+    if (period_us == 0 || interval_us <= period_us + period_us / 2) return 0;
+    return (interval_us + period_us / 2) / period_us - 1u;
+}
+
+static uint16_t per_second(uint32_t count, uint32_t elapsed_us)
+{
+    uint64_t rate = ((uint64_t)count * 1000000u + elapsed_us / 2) / elapsed_us;
+    return rate > UINT16_MAX ? UINT16_MAX : (uint16_t)rate;
+}
+
+// Close the current window and publish it
+static void publish_window(uint32_t now_us)
+{
+    uint32_t elapsed = now_us - window_start_us;
+
+    published_seq++;
+    __sync_synchronize();
+
+    published.id_count = id_count;
+    published.frames_per_sec = per_second(window_frames, elapsed);
+    published.other_per_sec = per_second(window_other, elapsed);
+    uint64_t load = ((uint64_t)window_bits * 1000000u / elapsed) * 1000u / bus_bitrate;
+    published.load_permille = load > 1000u ? 1000u : (uint16_t)load;
+
+    for (uint8_t i = 0; i < id_count; i++) {
+        id_state_t* st = &id_states[i];
+        ecu_bus_id_stats_t* out = &published.ids[i];
+        out->can_id = st->can_id;
+        out->expected_hz = st->expected_hz;
+        out->frames_per_sec = per_second(st->win_frames, elapsed);
+        out->interval_min_us = st->win_intervals ? st->win_interval_min : 0;
+        out->interval_avg_us = st->win_intervals ? st->win_interval_sum / st->win_intervals : 0;
+        out->interval_max_us = st->win_interval_max;
+        out->jitter_us = st->win_jitter;
+        out->missed_deadlines = st->missed;
+        out->frames = st->frames;
+
+        st->win_frames = 0;
+        st->win_intervals = 0;
+        st->win_interval_sum = 0;
+        st->win_interval_min = UINT32_MAX;
+        st->win_interval_max = 0;
+        st->win_jitter = 0;
+    }
+    published_us = now_us;
+
+    __sync_synchronize();
+    published_seq++;
+
+    window_start_us = now_us;
+    window_frames = 0;
+    window_other = 0;
+    window_bits = 0;
+}
+
+void ecu_bus_stats_init(uint32_t bitrate)
+{
+    memset(id_states, 0, sizeof(id_states));
+    memset(&published, 0, sizeof(published));
+    id_count = 0;
+    bus_bitrate = bitrate ? bitrate : ECU_BUS_STATS_BITRATE;
+    window_open = false;
+    window_frames = 0;
+    window_other = 0;
+    window_bits = 0;
+    published_us = 0;
+    for (int i = 0; i < ECU_BUS_STATS_ERROR_KINDS; i++) {
+        error_counts[i] = 0;
+    }
+}
+
+bool ecu_bus_stats_register(uint32_t can_id, uint16_t expected_hz)
+{
+    if (find_id(can_id) != NULL) return true;
+    if (id_count >= ECU_BUS_STATS_MAX_IDS) return false;
+
+    id_state_t* st = &id_states[id_count];
+    memset(st, 0, sizeof(*st));
+    st->can_id = can_id;
+    st->expected_hz = expected_hz;
+    st->period_us = expected_hz ? 1000000u / expected_hz : 0;
+    st->win_interval_min = UINT32_MAX;
+    id_count++;
+    return true;
+}
+
+void ecu_bus_stats_record(uint32_t can_id, uint8_t len, bool extended, uint32_t now_us)
+{
+    if (!window_open) {
+        window_open = true;
+        window_start_us = now_us;
+    } else if (now_us - window_start_us >= ECU_BUS_STATS_WINDOW_US) {
+        publish_window(now_us);
+    }
+
+    window_frames++;
+    window_bits += frame_bits(len, extended);
+
+    id_state_t* st = find_id(can_id);
+    if (st == NULL) {
+        window_other++;
+        return;
+    }
+
+    if (st->seen) {
+        uint32_t interval = now_us - st->last_us;
+        st->win_intervals++;
+        st->win_interval_sum += interval;
+        if (interval < st->win_interval_min) st->win_interval_min = interval;
+        if (interval > st->win_interval_max) st->win_interval_max = interval;
+        if (st->period_us) {
+            uint32_t deviation = interval > st->period_us ? interval - st->period_us : st->period_us - interval;
+            if (deviation > st->win_jitter) st->win_jitter = deviation;
+        }
+        st->missed += missed_in(interval, st->period_us);
+    }
+
+    st->seen = true;
+    st->last_us = now_us;
+    st->frames++;
+    st->win_frames++;
+}
+
+void ecu_bus_stats_record_error(uint32_t error_code)
+{
+    if (error_code < ECU_BUS_STATS_ERROR_KINDS) {
+        error_counts[error_code]++;
+    }
+}
+
+void ecu_bus_stats_get(ecu_bus_snapshot_t* out, uint32_t now_us)
+{
+    uint32_t seq;
+    uint32_t at;
+
+    do {
+        seq = published_seq;
+        __sync_synchronize();
+        *out = published;
+        at = published_us;
+        __sync_synchronize();
+    } while ((seq & 1u) || seq != published_seq);
+
+    // The writer only publishes on traffic; a silent bus leaves the last window behind
+    out->stale = (at == 0) || (now_us - at >= 2u * ECU_BUS_STATS_WINDOW_US);
+    if (out->stale) {
+        out->frames_per_sec = 0;
+        out->other_per_sec = 0;
+        out->load_permille = 0;
+    }
+
+    for (uint8_t i = 0; i < out->id_count; i++) {
+        const id_state_t* st = &id_states[i];
+        if (out->stale) out->ids[i].frames_per_sec = 0;
+        // Live counters: gaps closed since the last publish plus the one still open
+        out->ids[i].missed_deadlines = st->missed;
+        if (st->seen) {
+            out->ids[i].missed_deadlines += missed_in(now_us - st->last_us, st->period_us);
+        }
+    }
+
+    for (int i = 0; i < ECU_BUS_STATS_ERROR_KINDS; i++) {
+        out->errors[i] = error_counts[i];
+    }
+}
+
+// Append formatted text; false once the buffer is full
+static bool json_append(char* buf, size_t len, size_t* pos, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + *pos, len - *pos, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= len - *pos) return false;
+    *pos += (size_t)n;
+    return true;
+}
+
+size_t ecu_bus_stats_format_json(const ecu_bus_snapshot_t* snap, char* buf, size_t len)
+{
+    size_t pos = 0;
+    bool ok;
+
+    if (len == 0) return 0;
+
+    ok = json_append(buf, len, &pos,
+                     "{\"type\":\"bus\",\"fps\":%u,\"other_fps\":%u,\"load\":%u.%u,\"stale\":%s,"
+                     "\"errors\":{\"bus_off\":%lu,\"passive\":%lu,\"timeout\":%lu,\"overrun\":%lu},\"ids\":[",
+                     snap->frames_per_sec, snap->other_per_sec,
+                     snap->load_permille / 10u, snap->load_permille % 10u,
+                     snap->stale ? "true" : "false",
+                     (unsigned long)snap->errors[1], (unsigned long)snap->errors[2],
+                     (unsigned long)snap->errors[3], (unsigned long)snap->errors[4]);
+
+    for (uint8_t i = 0; ok && i < snap->id_count; i++) {
+        const ecu_bus_id_stats_t* id = &snap->ids[i];
+        ok = json_append(buf, len, &pos,
+                         "%s{\"id\":%lu,\"hz\":%u,\"expected_hz\":%u,\"min_us\":%lu,\"avg_us\":%lu,"
+                         "\"max_us\":%lu,\"jitter_us\":%lu,\"missed\":%lu}",
+                         i ? "," : "", (unsigned long)id->can_id, id->frames_per_sec, id->expected_hz,
+                         (unsigned long)id->interval_min_us, (unsigned long)id->interval_avg_us,
+                         (unsigned long)id->interval_max_us, (unsigned long)id->jitter_us,
+                         (unsigned long)id->missed_deadlines);
+    }
+
+    if (ok) ok = json_append(buf, len, &pos, "]}");
+    if (!ok) {
+        buf[0] = '\0';
+        return 0;
+    }
+    return pos;
+}
+
+size_t ecu_bus_stats_json(char* buf, size_t len)
+{
+    ecu_bus_snapshot_t snap;
+    ecu_bus_stats_get(&snap, ecu_bus_stats_now_us());
+    return ecu_bus_stats_format_json(&snap, buf, len);
+}
+
+uint32_t ecu_bus_stats_now_us(void)
+{
+#if defined(ESP_PLATFORM)
+    return (uint32_t)esp_timer_get_time();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+#endif
+}
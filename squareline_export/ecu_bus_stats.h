@@ -0,0 +1,113 @@
+/**
+ * CAN bus instrumentation for the ECU Dashboard
+ * Per-ID frame rate, inter-arrival jitter and missed deadlines against the
+ * rates in CAN_PROTOCOL_SPECIFICATION.md, plus an estimated bus load
+ */
+
+#ifndef ECU_BUS_STATS_H
+#define ECU_BUS_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECU_BUS_STATS_MAX_IDS       8
+#define ECU_BUS_STATS_WINDOW_US     1000000u   // Rates are published once per second
+#define ECU_BUS_STATS_BITRATE       500000u    // TWAI_TIMING_CONFIG_500KBPS
+#define ECU_BUS_STATS_ERROR_KINDS   5          // Indexed by CAN_ERROR_* code
+
+// One registered ID, values from the last complete window
+typedef struct {
+    uint32_t can_id;
+    uint16_t expected_hz;        // Rate from the protocol specification
+    uint16_t frames_per_sec;     // Measured rate
+    uint32_t interval_min_us;    // Inter-arrival time, min/avg/max
+    uint32_t interval_avg_us;
+    uint32_t interval_max_us;
+    uint32_t jitter_us;          // Largest deviation from the expected period
+    uint32_t missed_deadlines;   // Expected frames that never arrived, since init
+    uint32_t frames;             // Frames since init
+} ecu_bus_id_stats_t;
+
+// Whole-bus snapshot
+typedef struct {
+    ecu_bus_id_stats_t ids[ECU_BUS_STATS_MAX_IDS];
+    uint8_t id_count;
+    bool stale;                  // No frame for two windows, rates are zero
+    uint16_t frames_per_sec;     // All frames seen by the RX path
+    uint16_t other_per_sec;      // Frames with no registered ID
+    uint16_t load_permille;      // Estimated bus load, 0.1 %
+    uint32_t errors[ECU_BUS_STATS_ERROR_KINDS];
+} ecu_bus_snapshot_t;
+
+/**
+ * Clear all counters and registrations
+ * @param bitrate Nominal bus bitrate used for the load estimate
+ */
+void ecu_bus_stats_init(uint32_t bitrate);
+
+/**
+ * Register an ID and its expected rate
+ * @param can_id CAN ID
+ * @param expected_hz Expected frame rate, 0 if aperiodic
+ * @return false if the table is full
+ */
+bool ecu_bus_stats_register(uint32_t can_id, uint16_t expected_hz);
+
+/**
+ * Account one received frame. Single writer: call from the RX path only.
+ * Only frames that pass the acceptance filter are seen, so the load is a
+ * lower bound while a hardware filter is active.
+ * @param can_id CAN ID
+ * @param len Payload bytes (0-8, up to 64 for CAN FD)
+ * @param extended 29-bit identifier
+ * @param now_us Receive timestamp (ecu_bus_stats_now_us)
+ */
+void ecu_bus_stats_record(uint32_t can_id, uint8_t len, bool extended, uint32_t now_us);
+
+/**
+ * Count a controller error
+ * @param error_code CAN_ERROR_* code
+ */
+void ecu_bus_stats_record_error(uint32_t error_code);
+
+/**
+ * Read a consistent snapshot. Deadlines missed since the last frame of a
+ * silent ID are included, so a dead node shows up without new traffic.
+ * @param out Snapshot
+ * @param now_us Current time (ecu_bus_stats_now_us)
+ */
+void ecu_bus_stats_get(ecu_bus_snapshot_t* out, uint32_t now_us);
+
+/**
+ * Format a snapshot as a compact JSON object (WebSocket diagnostics)
+ * @param snap Snapshot
+ * @param buf Output buffer
+ * @param len Buffer size
+ * @return Characters written, excluding the terminator
+ */
+size_t ecu_bus_stats_format_json(const ecu_bus_snapshot_t* snap, char* buf, size_t len);
+
+/**
+ * Snapshot the bus now and format it as JSON; served as the "bus"
+ * diagnostics source of the host WebSocket server (host/ecu_host.c)
+ * @param buf Output buffer
+ * @param len Buffer size
+ * @return Characters written, excluding the terminator
+ */
+size_t ecu_bus_stats_json(char* buf, size_t len);
+
+/**
+ * @return Microsecond timestamp used by the RX path
+ */
+uint32_t ecu_bus_stats_now_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_BUS_STATS_H
@@ -0,0 +1,217 @@
+/**
+ * CAN transport interface for the ECU Dashboard
+ * Stand-in bus and, on ESP32, the TWAI adapter; SocketCAN on Linux hosts
+ */
+
+#include "ecu_can_bus.h"
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "driver/twai.h"
+#include "freertos/FreeRTOS.h"
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#endif
+
+#define STANDIN_MASK    (ECU_CAN_STANDIN_DEPTH - 1u)
+
+static bool standin_send(void* ctx, const ecu_can_frame_t* frame, uint32_t timeout_ms)
+{
+    ecu_can_standin_t* s = (ecu_can_standin_t*)ctx;
+    uint32_t head = s->head;
+    (void)timeout_ms;
+
+    if (head - s->tail >= ECU_CAN_STANDIN_DEPTH) {
+        s->dropped++;
+        return false;
+    }
+    ecu_can_frame_t* slot = &s->frames[head & STANDIN_MASK];
+    slot->id = frame->id;
+    slot->len = frame->len;
+    slot->flags = frame->flags;
+    memcpy(slot->data, frame->data, frame->len);
+    __sync_synchronize();
+    s->head = head + 1;
+    s->sent++;
+    return true;
+}
+
+static bool standin_receive(void* ctx, ecu_can_frame_t* frame, uint32_t timeout_ms)
+{
+    ecu_can_standin_t* s = (ecu_can_standin_t*)ctx;
+    uint32_t tail = s->tail;
+    (void)timeout_ms;
+
+    if (tail == s->head) return false;
+    __sync_synchronize();
+    const ecu_can_frame_t* slot = &s->frames[tail & STANDIN_MASK];
+    frame->id = slot->id;
+    frame->len = slot->len;
+    frame->flags = slot->flags;
+    memcpy(frame->data, slot->data, slot->len);
+    __sync_synchronize();
+    s->tail = tail + 1;
+    return true;
+}
+
+void ecu_can_standin_init(ecu_can_bus_t* bus, ecu_can_standin_t* standin, bool fd)
+{
+    memset(standin, 0, sizeof(*standin));
+    bus->send = standin_send;
+    bus->receive = standin_receive;
+    bus->max_len = fd ? ECU_CAN_FD_MAX_LEN : ECU_CAN_CLASSIC_MAX_LEN;
+    bus->name = fd ? "standin-fd" : "standin";
+    bus->ctx = standin;
+}
+
+#if defined(ESP_PLATFORM)
+static bool twai_bus_send(void* ctx, const ecu_can_frame_t* frame, uint32_t timeout_ms)
+{
+    twai_message_t msg = {0};
+    (void)ctx;
+
+    if (frame->flags & ECU_CAN_FRAME_FD) return false;
+    msg.identifier = frame->id;
+    msg.data_length_code = frame->len;
+    msg.extd = (frame->flags & ECU_CAN_FRAME_EXTENDED) ? 1 : 0;
+    msg.rtr = (frame->flags & ECU_CAN_FRAME_RTR) ? 1 : 0;
+    memcpy(msg.data, frame->data, frame->len);
+    return twai_transmit(&msg, pdMS_TO_TICKS(timeout_ms)) == ESP_OK;
+}
+
+static bool twai_bus_receive(void* ctx, ecu_can_frame_t* frame, uint32_t timeout_ms)
+{
+    twai_message_t msg;
+    (void)ctx;
+
+    if (twai_receive(&msg, pdMS_TO_TICKS(timeout_ms)) != ESP_OK) return false;
+    frame->id = msg.identifier;
+    frame->len = ecu_can_dlc_to_len(msg.data_length_code, false);
+    frame->flags = (msg.extd ? ECU_CAN_FRAME_EXTENDED : 0) | (msg.rtr ? ECU_CAN_FRAME_RTR : 0);
+    memcpy(frame->data, msg.data, frame->len);
+    return true;
+}
+
+static const ecu_can_bus_t twai_bus = {
+    .send = twai_bus_send,
+    .receive = twai_bus_receive,
+    .max_len = ECU_CAN_CLASSIC_MAX_LEN,
+    .name = "twai",
+    .ctx = NULL,
+};
+
+const ecu_can_bus_t* ecu_can_bus_twai(void)
+{
+    return &twai_bus;
+}
+#endif
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+static bool socketcan_wait(int fd, short events, uint32_t timeout_ms)
+{
+    struct pollfd pfd = { .fd = fd, .events = events, .revents = 0 };
+    return poll(&pfd, 1, (int)timeout_ms) > 0 && (pfd.revents & events);
+}
+
+static bool socketcan_send(void* ctx, const ecu_can_frame_t* frame, uint32_t timeout_ms)
+{
+    ecu_can_socketcan_t* sc = (ecu_can_socketcan_t*)ctx;
+    struct canfd_frame cf;
+    size_t mtu = CAN_MTU;
+
+    memset(&cf, 0, sizeof(cf));
+    cf.can_id = frame->id;
+    if (frame->flags & ECU_CAN_FRAME_EXTENDED) cf.can_id |= CAN_EFF_FLAG;
+    if (frame->flags & ECU_CAN_FRAME_RTR) cf.can_id |= CAN_RTR_FLAG;
+    if (frame->flags & ECU_CAN_FRAME_FD) {
+        if (!sc->fd_frames) return false;
+        mtu = CANFD_MTU;
+        if (frame->flags & ECU_CAN_FRAME_BRS) cf.flags |= CANFD_BRS;
+    }
+    cf.len = frame->len;
+    memcpy(cf.data, frame->data, frame->len);
+
+    for (;;) {
+        ssize_t n = write(sc->fd, &cf, mtu);
+        if (n == (ssize_t)mtu) {
+            sc->tx_frames++;
+            return true;
+        }
+        // Queue full (ENOBUFS on CAN, EAGAIN when non-blocking): wait for room once
+        if (timeout_ms == 0 || !socketcan_wait(sc->fd, POLLOUT, timeout_ms)) return false;
+        timeout_ms = 0;
+    }
+}
+
+static bool socketcan_receive(void* ctx, ecu_can_frame_t* frame, uint32_t timeout_ms)
+{
+    ecu_can_socketcan_t* sc = (ecu_can_socketcan_t*)ctx;
+    struct canfd_frame cf;
+
+    ssize_t n = read(sc->fd, &cf, sizeof(cf));
+    if (n < 0 && timeout_ms && socketcan_wait(sc->fd, POLLIN, timeout_ms)) {
+        n = read(sc->fd, &cf, sizeof(cf));
+    }
+    if (n != CAN_MTU && n != CANFD_MTU) return false;
+
+    bool extended = (cf.can_id & CAN_EFF_FLAG) != 0;
+    frame->id = cf.can_id & (extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+    frame->len = cf.len > ECU_CAN_FD_MAX_LEN ? ECU_CAN_FD_MAX_LEN : cf.len;
+    frame->flags = (extended ? ECU_CAN_FRAME_EXTENDED : 0) |
+                   ((cf.can_id & CAN_RTR_FLAG) ? ECU_CAN_FRAME_RTR : 0) |
+                   (n == CANFD_MTU ? ECU_CAN_FRAME_FD : 0) |
+                   (n == CANFD_MTU && (cf.flags & CANFD_BRS) ? ECU_CAN_FRAME_BRS : 0);
+    memcpy(frame->data, cf.data, frame->len);
+    sc->rx_frames++;
+    return true;
+}
+
+bool ecu_can_socketcan_open(ecu_can_bus_t* bus, ecu_can_socketcan_t* sc, const char* ifname, bool fd)
+{
+    struct sockaddr_can addr;
+    struct ifreq ifr;
+    int enable = 1;
+
+    memset(sc, 0, sizeof(*sc));
+    sc->fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (sc->fd < 0) return false;
+
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    if (ioctl(sc->fd, SIOCGIFINDEX, &ifr) < 0 ||
+        (fd && setsockopt(sc->fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable)) < 0)) {
+        ecu_can_socketcan_close(sc);
+        return false;
+    }
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (bind(sc->fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        ecu_can_socketcan_close(sc);
+        return false;
+    }
+    // Timeouts are handled with poll(); a zero timeout must not block
+    fcntl(sc->fd, F_SETFL, fcntl(sc->fd, F_GETFL) | O_NONBLOCK);
+    sc->fd_frames = fd;
+
+    bus->send = socketcan_send;
+    bus->receive = socketcan_receive;
+    bus->max_len = fd ? ECU_CAN_FD_MAX_LEN : ECU_CAN_CLASSIC_MAX_LEN;
+    bus->name = "socketcan";
+    bus->ctx = sc;
+    return true;
+}
+
+void ecu_can_socketcan_close(ecu_can_socketcan_t* sc)
+{
+    if (sc->fd >= 0) close(sc->fd);
+    sc->fd = -1;
+}
+#endif
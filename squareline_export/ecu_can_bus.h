@@ -0,0 +1,119 @@
+/**
+ * CAN transport interface for the ECU Dashboard
+ * The decoder only sees ecu_can_frame_t; a bus moves frames to and from a
+ * controller. TWAI (classic CAN) is the default on ESP32; the stand-in bus
+ * is an in-memory FD-capable bus for host builds and bench tests, and
+ * SocketCAN (e.g. vcan0 fed by cangen) runs the pipeline on a Linux host.
+ */
+
+#ifndef ECU_CAN_BUS_H
+#define ECU_CAN_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ecu_can_frame.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECU_CAN_STANDIN_DEPTH   32      // Frames buffered by the stand-in bus (power of two)
+
+typedef struct {
+    /**
+     * Queue a frame for transmission
+     * @return false if the frame is too long for the bus or the queue stayed full
+     */
+    bool (*send)(void* ctx, const ecu_can_frame_t* frame, uint32_t timeout_ms);
+    /**
+     * Take one received frame
+     * @return false if none arrived within timeout_ms
+     */
+    bool (*receive)(void* ctx, ecu_can_frame_t* frame, uint32_t timeout_ms);
+    uint8_t max_len;             // ECU_CAN_CLASSIC_MAX_LEN or ECU_CAN_FD_MAX_LEN
+    const char* name;
+    void* ctx;
+} ecu_can_bus_t;
+
+// In-memory bus: every frame sent is received once, in order.
+// Single producer, single consumer; never blocks (timeouts are ignored).
+typedef struct {
+    ecu_can_frame_t frames[ECU_CAN_STANDIN_DEPTH];
+    volatile uint32_t head;      // Next write, advanced by the sender
+    volatile uint32_t tail;      // Next read, advanced by the receiver
+    uint32_t sent;
+    uint32_t dropped;            // Sends refused because the queue was full
+} ecu_can_standin_t;
+
+/**
+ * Send a frame
+ * @param bus Transport
+ * @param frame Frame, len must not exceed bus->max_len
+ * @param timeout_ms Wait for queue space
+ * @return true if queued
+ */
+static inline bool ecu_can_bus_send(const ecu_can_bus_t* bus, const ecu_can_frame_t* frame, uint32_t timeout_ms)
+{
+    if (frame->len > bus->max_len) return false;
+    return bus->send(bus->ctx, frame, timeout_ms);
+}
+
+/**
+ * Receive a frame
+ * @param bus Transport
+ * @param frame Received frame
+ * @param timeout_ms Wait for a frame
+ * @return true if a frame was received
+ */
+static inline bool ecu_can_bus_receive(const ecu_can_bus_t* bus, ecu_can_frame_t* frame, uint32_t timeout_ms)
+{
+    return bus->receive(bus->ctx, frame, timeout_ms);
+}
+
+/**
+ * Set up a stand-in bus
+ * @param bus Transport to fill
+ * @param standin Backing storage, owned by the caller
+ * @param fd true to accept 64-byte payloads, false to behave like classic CAN
+ */
+void ecu_can_standin_init(ecu_can_bus_t* bus, ecu_can_standin_t* standin, bool fd);
+
+#if defined(ESP_PLATFORM)
+/**
+ * TWAI transport (classic CAN, driver installed by ecu_can_supervisor_start)
+ * @return Shared transport instance
+ */
+const ecu_can_bus_t* ecu_can_bus_twai(void);
+#endif
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+typedef struct {
+    int fd;                      // Raw CAN socket, also usable in poll()
+    bool fd_frames;              // CAN_RAW_FD_FRAMES enabled
+    uint32_t rx_frames;
+    uint32_t tx_frames;
+} ecu_can_socketcan_t;
+
+/**
+ * Open a SocketCAN transport (Linux host builds)
+ * @param bus Transport to fill
+ * @param sc Socket state, owned by the caller
+ * @param ifname Interface, e.g. "vcan0" or "can0"
+ * @param fd true to send and receive CAN FD frames (the interface MTU must allow it)
+ * @return false if the interface could not be opened, errno is set
+ */
+bool ecu_can_socketcan_open(ecu_can_bus_t* bus, ecu_can_socketcan_t* sc, const char* ifname, bool fd);
+
+/**
+ * Close a SocketCAN transport
+ * @param sc Socket state
+ */
+void ecu_can_socketcan_close(ecu_can_socketcan_t* sc);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_CAN_BUS_H
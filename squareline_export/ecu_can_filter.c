@@ -0,0 +1,119 @@
+/**
+ * CAN acceptance filter calculation for the ECU Dashboard
+ * Register layout follows the SJA1000 as exposed by the ESP32 TWAI driver:
+ * single filter mode compares ID[10:0] in bits 31..21, dual filter mode
+ * compares filter 1 ID in bits 31..21 and filter 2 ID in bits 15..5
+ */
+
+#include "ecu_can_filter.h"
+#include <string.h>
+
+#define STD_ID_MAX              0x7FFu
+
+// Single mode: RTR, unused and both data bytes are don't care
+#define SINGLE_DONT_CARE        0x001FFFFFu
+// Dual mode: RTR/data nibbles of filter 1 (bits 20..16, 3..0) and RTR of filter 2 (bit 4)
+#define DUAL_DONT_CARE          0x001F001Fu
+
+// Number of set bits in an 11-bit mask
+static uint16_t mask_bits(uint32_t mask)
+{
+    uint16_t bits = 0;
+    while (mask) {
+        bits += (uint16_t)(mask & 1u);
+        mask >>= 1;
+    }
+    return bits;
+}
+
+// Smallest code/mask pair covering the selected IDs; returns IDs it accepts
+static uint16_t cover(const uint32_t* ids, size_t count, uint32_t select,
+                      uint32_t* code_out, uint32_t* mask_out)
+{
+    uint32_t code = 0;
+    uint32_t mask = 0;
+    bool first = true;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!(select & (1u << i))) continue;
+        if (first) {
+            code = ids[i];
+            first = false;
+        } else {
+            mask |= code ^ ids[i];
+        }
+    }
+
+    *code_out = code & ~mask;
+    *mask_out = mask;
+    return first ? 0 : (uint16_t)(1u << mask_bits(mask));
+}
+
+bool ecu_can_filter_compute(const uint32_t* ids, size_t count, ecu_can_filter_t* out)
+{
+    uint32_t unique[ECU_CAN_FILTER_MAX_IDS];
+    size_t n = 0;
+
+    memset(out, 0, sizeof(*out));
+    out->acceptance_mask = 0xFFFFFFFFu;
+    out->single_filter = true;
+    out->accepted_ids = STD_ID_MAX + 1;
+
+    // Duplicates would only inflate the search
+    for (size_t i = 0; i < count; i++) {
+        if (ids[i] > STD_ID_MAX) return false;
+        bool seen = false;
+        for (size_t j = 0; j < n; j++) {
+            if (unique[j] == ids[i]) seen = true;
+        }
+        if (seen) continue;
+        if (n == ECU_CAN_FILTER_MAX_IDS) return false;
+        unique[n++] = ids[i];
+    }
+    if (n == 0) return false;
+
+    uint32_t all = (1u << n) - 1u;
+    uint32_t code, mask;
+    uint16_t best = cover(unique, n, all, &code, &mask);
+
+    out->acceptance_code = code << 21;
+    out->acceptance_mask = (mask << 21) | SINGLE_DONT_CARE;
+
+    // Dual mode: try every split into two groups, skipping mirrored halves
+    if (best > n) {
+        for (uint32_t select = 1; select < all; select++) {
+            if (select & 1u) continue;
+            uint32_t code1, mask1, code2, mask2;
+            uint16_t accepted = cover(unique, n, select, &code1, &mask1);
+            accepted += cover(unique, n, all & ~select, &code2, &mask2);
+            if (accepted < best) {
+                best = accepted;
+                out->single_filter = false;
+                out->acceptance_code = (code1 << 21) | (code2 << 5);
+                out->acceptance_mask = (mask1 << 21) | (mask2 << 5) | DUAL_DONT_CARE;
+            }
+        }
+    }
+
+    out->hardware = true;
+    out->accepted_ids = best;
+    out->extra_ids = (uint16_t)(best - n);
+    return true;
+}
+
+bool ecu_can_filter_accepts(const ecu_can_filter_t* filter, uint32_t id)
+{
+    if (!filter->hardware) return true;
+    if (id > STD_ID_MAX) return false;
+
+    uint32_t diff;
+    if (filter->single_filter) {
+        diff = ((id << 21) ^ filter->acceptance_code) & ~filter->acceptance_mask;
+        return (diff & 0xFFE00000u) == 0;
+    }
+
+    diff = ((id << 21) ^ filter->acceptance_code) & ~filter->acceptance_mask;
+    if ((diff & 0xFFE00000u) == 0) return true;
+    diff = ((id << 5) ^ filter->acceptance_code) & ~filter->acceptance_mask;
+    return (diff & 0x0000FFE0u) == 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * CAN acceptance filter calculation for the ECU Dashboard
+ * Derives the tightest SJA1000/TWAI acceptance code and mask (single or dual
+ * filter mode) that passes every standard ID with a registered decoder
+ */
+
+#ifndef ECU_CAN_FILTER_H
+#define ECU_CAN_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of decoded IDs considered for the dual filter search
+#define ECU_CAN_FILTER_MAX_IDS  12
+
+// Filter result, field layout matches twai_filter_config_t
+typedef struct {
+    uint32_t acceptance_code;
+    uint32_t acceptance_mask;    // 1 = don't care
+    bool single_filter;          // true: single filter mode, false: dual filter mode
+    bool hardware;               // false: accept all, filter in software only
+    uint16_t accepted_ids;       // Standard IDs the hardware lets through
+    uint16_t extra_ids;          // Accepted IDs that have no decoder (still dropped in software)
+} ecu_can_filter_t;
+
+/**
+ * Compute the acceptance filter for a set of standard (11-bit) IDs.
+ * Falls back to accept-all (hardware = false) if the set is empty, too large
+ * or contains extended IDs.
+ * @param ids Decoded CAN IDs
+ * @param count Number of IDs
+ * @param out Filter configuration
+ * @return true if a hardware filter was found
+ */
+bool ecu_can_filter_compute(const uint32_t* ids, size_t count, ecu_can_filter_t* out);
+
+/**
+ * Check whether a standard ID passes a computed filter (software model of the hardware)
+ * @param filter Filter configuration
+ * @param id Standard CAN ID
+ * @return true if the controller would accept the frame
+ */
+bool ecu_can_filter_accepts(const ecu_can_filter_t* filter, uint32_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_CAN_FILTER_H
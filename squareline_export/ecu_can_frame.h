@@ -0,0 +1,88 @@
+/**
+ * CAN frame abstraction for the ECU Dashboard
+ * One frame type for classic CAN (0-8 bytes) and CAN FD (up to 64 bytes);
+ * transports convert to and from it at the driver boundary
+ */
+
+#ifndef ECU_CAN_FRAME_H
+#define ECU_CAN_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECU_CAN_CLASSIC_MAX_LEN     8
+#define ECU_CAN_FD_MAX_LEN          64
+
+#define ECU_CAN_FRAME_EXTENDED      (1u << 0)  // 29-bit identifier
+#define ECU_CAN_FRAME_FD            (1u << 1)  // FD format (FDF)
+#define ECU_CAN_FRAME_BRS           (1u << 2)  // FD bit rate switch
+#define ECU_CAN_FRAME_RTR           (1u << 3)  // Remote request (classic only)
+
+typedef struct {
+    uint32_t id;
+    uint8_t len;                 // Payload bytes, one of the valid FD lengths if ECU_CAN_FRAME_FD
+    uint8_t flags;               // ECU_CAN_FRAME_*
+    uint8_t data[ECU_CAN_FD_MAX_LEN];
+} ecu_can_frame_t;
+
+/**
+ * Payload length of a data length code
+ * @param dlc 0-15
+ * @param fd FD frame (codes 9-15 map to 12..64 bytes, otherwise to 8)
+ * @return Payload bytes
+ */
+static inline uint8_t ecu_can_dlc_to_len(uint8_t dlc, bool fd)
+{
+    static const uint8_t fd_lengths[7] = {12, 16, 20, 24, 32, 48, 64};
+    if (dlc <= 8) return dlc;
+    if (!fd) return 8;
+    return dlc > 15 ? 64 : fd_lengths[dlc - 9];
+}
+
+/**
+ * Smallest data length code that holds a payload
+ * @param len Payload bytes, 0-64
+ * @return DLC 0-15 (payloads between FD sizes are padded up)
+ */
+static inline uint8_t ecu_can_len_to_dlc(uint8_t len)
+{
+    if (len <= 8) return len;
+    if (len <= 24) return (uint8_t)(9 + (len - 9) / 4);
+    if (len <= 32) return 13;
+    if (len <= 48) return 14;
+    return 15;
+}
+
+/**
+ * Fill a frame; FD format is chosen when the payload does not fit a classic
+ * frame, the length is padded to the next valid FD size with zeros
+ * @param frame Frame to fill
+ * @param id CAN ID
+ * @param data Payload
+ * @param len Payload bytes, clamped to 64
+ * @param flags ECU_CAN_FRAME_* (FD is added as needed)
+ */
+static inline void ecu_can_frame_set(ecu_can_frame_t* frame, uint32_t id, const uint8_t* data,
+                                     uint8_t len, uint8_t flags)
+{
+    if (len > ECU_CAN_FD_MAX_LEN) len = ECU_CAN_FD_MAX_LEN;
+    if (len > ECU_CAN_CLASSIC_MAX_LEN) flags |= ECU_CAN_FRAME_FD;
+
+    uint8_t padded = (flags & ECU_CAN_FRAME_FD) ? ecu_can_dlc_to_len(ecu_can_len_to_dlc(len), true) : len;
+    frame->id = id;
+    frame->flags = flags;
+    frame->len = padded;
+    memcpy(frame->data, data, len);
+    memset(frame->data + len, 0, padded - len);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_CAN_FRAME_H
@@ -5,176 +5,470 @@
 
 #include "ecu_can_integration.h"
 #include "ecu_data_structures.h"
+#include "ecu_history.h"
+#include "ecu_stats.h"
+#include "ecu_can_filter.h"
+#include "ecu_bus_stats.h"
+#include "ecu_latency.h"
+#include "ecu_can_supervisor.h"
+#include "ecu_can_spec.h"
 #include <string.h>
 
-// CAN message IDs
-#define CAN_TCU_DATA_ID         0x440
-#define CAN_ECU_DATA_ID         0x380
-#define CAN_BOOST_CONTROL_ID    0x200
-
-// TCU data structure (from CAN ID 0x440)
-typedef struct {
-    uint8_t torque_request;      // Byte 3: Torque request (0-255 -> 0-100%)
-    uint8_t protection_flags;    // Byte 1: Protection status flags
-    uint8_t limp_mode_status;    // Byte 5: Limp mode status (bits 4-7)
-    uint8_t gear_position;       // Byte 0: Current gear
-    uint16_t input_speed;        // Bytes 6-7: Input shaft speed
-} tcu_can_data_t;
-
-// ECU data structure (from CAN ID 0x380)
-typedef struct {
-    uint16_t engine_rpm;         // Bytes 0-1: Engine RPM
-    uint16_t map_pressure;       // Bytes 2-3: MAP pressure (scaled)
-    uint8_t tps_position;        // Byte 4: TPS position
-    uint8_t coolant_temp;        // Byte 5: Coolant temperature
-    uint16_t boost_target;       // Bytes 6-7: Target boost pressure
-} ecu_can_data_t;
-
-// Boost control data (from CAN ID 0x200)
-typedef struct {
-    uint8_t wastegate_position;  // Byte 0: Wastegate position (0-255 -> 0-100%)
-    uint8_t boost_control_mode;  // Byte 1: Control mode
-    uint16_t measured_boost;     // Bytes 2-3: Measured boost pressure
-    uint16_t target_boost;       // Bytes 4-5: Target boost pressure
-    uint8_t pid_output;          // Byte 6: PID controller output
-    uint8_t safety_flags;        // Byte 7: Safety and protection flags
-} boost_control_can_data_t;
-
 // Global variables
-static ecu_data_t current_ecu_data = {0};
+static ecu_data_fx_t current_fx = {0};      // Written by the decoder, raw CAN units
+static ecu_data_t current_ecu_data = {0};   // Float view, refreshed on read
 static uint32_t last_update_time = 0;
 static bool data_valid = false;
 
-// Helper function to extract bit range from CAN data
-static uint32_t get_bit_range(const uint8_t* data, uint8_t bit_index, uint8_t bit_width)
-{
-    uint8_t byte_index = bit_index >> 3;
-    uint8_t shift = bit_index - (byte_index << 3);
-    uint32_t value = data[byte_index];
-    
-    if (shift + bit_width > 8) {
-        value |= (data[byte_index + 1] << 8);
-    }
-    if (shift + bit_width > 16) {
-        value |= (data[byte_index + 2] << 16);
-    }
-    
-    uint32_t mask = (1U << bit_width) - 1;
-    return (value >> shift) & mask;
-}
-
 // Parse TCU CAN message (ID 0x440)
-static void parse_tcu_data(const uint8_t* data, uint8_t length)
+static bool parse_tcu_data(const uint8_t* data, uint8_t length)
 {
-    if (length < 6) return;
-    
-    // Extract torque request (Byte 3, scaled 0-255 -> 0-100%)
-    uint8_t raw_torque = data[3];
-    if (raw_torque == 255) {
-        // Invalid data
-        current_ecu_data.torque_request = 0;
-    } else {
-        current_ecu_data.torque_request = (float)raw_torque * 0.39f; // Scale factor from Lua script
-    }
+    if (length < ECU_CAN_DLC_TCU) return false;
     
-    // Extract protection status (Byte 1, bit 1)
-    uint8_t protection_status = get_bit_range(data, 9, 1);
-    current_ecu_data.tcu_protection_active = (protection_status == 1);
+    // Torque request (bytes 0-1, 1 Nm/bit), kept raw
+    current_fx.torque_request = (uint16_t)ecu_can_sig_get(ECU_SIG_TORQUE_REQUEST, data);
     
-    // Extract limp mode status (Byte 5, bits 4-7)
-    uint8_t limp_mode_status = get_bit_range(data, 40, 4);
-    current_ecu_data.tcu_limp_mode = (limp_mode_status != 5 && limp_mode_status != 6 && 
-                                      limp_mode_status != 7 && limp_mode_status > 0);
+    // Protection flags (byte 2): any of overheat/overspeed/low pressure/clutch slip, limp mode
+    current_fx.flags = (ecu_can_sig_get(ECU_SIG_TCU_PROTECTION, data) ? ECU_FX_FLAG_TCU_PROTECTION : 0) |
+                       (ecu_can_sig_get(ECU_SIG_TCU_LIMP, data) ? ECU_FX_FLAG_TCU_LIMP : 0);
+    return true;
 }
 
 // Parse ECU CAN message (ID 0x380)
-static void parse_ecu_data(const uint8_t* data, uint8_t length)
+static bool parse_ecu_data(const uint8_t* data, uint8_t length)
 {
-    if (length < 8) return;
+    if (length < ECU_CAN_DLC_ENGINE) return false;
     
-    // Extract engine RPM (Bytes 0-1, little endian)
-    current_ecu_data.engine_rpm = (float)((data[1] << 8) | data[0]);
+    // Engine RPM (bytes 0-1, 1 RPM/bit)
+    current_fx.engine_rpm = (uint16_t)ecu_can_sig_get(ECU_SIG_ENGINE_RPM, data);
     
-    // Extract MAP pressure (Bytes 2-3, scaled to kPa)
-    uint16_t raw_map = (data[3] << 8) | data[2];
-    current_ecu_data.map_pressure = (float)raw_map * 0.1f; // Scale factor for kPa
+    // MAP pressure (bytes 2-3, 0.1 kPa/bit)
+    current_fx.map_pressure = (uint16_t)ecu_can_sig_get(ECU_SIG_MAP_PRESSURE, data);
     
-    // Extract TPS position (Byte 4, scaled 0-255 -> 0-100%)
-    current_ecu_data.tps_position = (float)data[4] * 0.392f; // Scale factor
+    // TPS position (byte 4, 1 %/bit)
+    current_fx.tps_position = (uint8_t)ecu_can_sig_get(ECU_SIG_TPS_POSITION, data);
+    return true;
 }
 
 // Parse boost control CAN message (ID 0x200)
-static void parse_boost_control_data(const uint8_t* data, uint8_t length)
+static bool parse_boost_control_data(const uint8_t* data, uint8_t length)
 {
-    if (length < 8) return;
+    if (length < ECU_CAN_DLC_BOOST_CONTROL) return false;
     
-    // Extract wastegate position (Byte 0, scaled 0-255 -> 0-100%)
-    current_ecu_data.wastegate_position = (float)data[0] * 0.392f;
+    // Wastegate position (byte 0, 1 %/bit)
+    current_fx.wastegate_position = (uint8_t)ecu_can_sig_get(ECU_SIG_WASTEGATE_POSITION, data);
     
-    // Extract target boost (Bytes 4-5, scaled to kPa)
-    uint16_t raw_target = (data[5] << 8) | data[4];
-    current_ecu_data.target_boost = (float)raw_target * 0.1f;
+    // Target boost (bytes 1-2, 0.1 kPa/bit)
+    current_fx.target_boost = (uint16_t)ecu_can_sig_get(ECU_SIG_TARGET_BOOST, data);
+    return true;
 }
 
-// Main CAN message handler
-void can_message_handler(uint32_t can_id, const uint8_t* data, uint8_t length)
+// Decode handlers: parse one frame and feed the statistics/history it carries;
+// false if the frame was too short, its channels are then not refreshed
+static bool decode_tcu_frame(const uint8_t* data, uint8_t length, uint32_t now)
 {
-    switch (can_id) {
-        case CAN_TCU_DATA_ID:
-            parse_tcu_data(data, length);
-            break;
-            
-        case CAN_ECU_DATA_ID:
-            parse_ecu_data(data, length);
-            break;
-            
-        case CAN_BOOST_CONTROL_ID:
-            parse_boost_control_data(data, length);
+    if (!parse_tcu_data(data, length)) return false;
+    ecu_stats_update(ECU_CH_TORQUE_REQUEST, ecu_fx_get_tenths(&current_fx, ECU_CH_TORQUE_REQUEST), now);
+    return true;
+}
+
+static bool decode_ecu_frame(const uint8_t* data, uint8_t length, uint32_t now)
+{
+    if (!parse_ecu_data(data, length)) return false;
+    ecu_stats_update(ECU_CH_ENGINE_RPM, ecu_fx_get_tenths(&current_fx, ECU_CH_ENGINE_RPM), now);
+    ecu_stats_update(ECU_CH_MAP_PRESSURE, ecu_fx_get_tenths(&current_fx, ECU_CH_MAP_PRESSURE), now);
+    ecu_stats_update(ECU_CH_TPS_POSITION, ecu_fx_get_tenths(&current_fx, ECU_CH_TPS_POSITION), now);
+    return true;
+}
+
+static bool decode_boost_control_frame(const uint8_t* data, uint8_t length, uint32_t now)
+{
+    if (!parse_boost_control_data(data, length)) return false;
+    ecu_stats_update(ECU_CH_WASTEGATE_POSITION, ecu_fx_get_tenths(&current_fx, ECU_CH_WASTEGATE_POSITION), now);
+    ecu_stats_update(ECU_CH_TARGET_BOOST, ecu_fx_get_tenths(&current_fx, ECU_CH_TARGET_BOOST), now);
+    // 50Hz boost frame is the history timebase
+    ecu_history_push(&current_fx);
+    return true;
+}
+
+// Multiplexed temperature pages (0x381): page 0 coolant/oil, pages 1-2 EGT
+static ecu_engine_temps_t engine_temps;
+static volatile uint32_t engine_temps_seq = 0;
+
+static const ecu_can_sig_id_t egt_signals[ECU_CYLINDERS] = {
+    ECU_SIG_EGT_CYL1, ECU_SIG_EGT_CYL2, ECU_SIG_EGT_CYL3,
+    ECU_SIG_EGT_CYL4, ECU_SIG_EGT_CYL5, ECU_SIG_EGT_CYL6,
+};
+
+static bool decode_engine_temps_frame(const uint8_t* data, uint8_t length, uint32_t now)
+{
+    (void)now;
+    if (length < ECU_CAN_DLC_ENGINE_TEMPS) return false;
+
+    engine_temps_seq++;
+    __sync_synchronize();
+    if (ecu_can_sig_present(ECU_SIG_COOLANT_TEMP, data)) {
+        engine_temps.coolant = (int16_t)ecu_can_sig_get_tenths(ECU_SIG_COOLANT_TEMP, data);
+        engine_temps.oil = (int16_t)ecu_can_sig_get_tenths(ECU_SIG_OIL_TEMP, data);
+        engine_temps.valid |= ECU_TEMPS_VALID_COOLANT | ECU_TEMPS_VALID_OIL;
+    }
+    for (int cyl = 0; cyl < ECU_CYLINDERS; cyl++) {
+        if (!ecu_can_sig_present(egt_signals[cyl], data)) continue;
+        engine_temps.egt[cyl] = (int16_t)ecu_can_sig_get_tenths(egt_signals[cyl], data);
+        engine_temps.valid |= (uint8_t)(ECU_TEMPS_VALID_EGT1 << cyl);
+    }
+    __sync_synchronize();
+    engine_temps_seq++;
+    return true;
+}
+
+// DTC list over ISO-TP (0x3A0): count, then per DTC code (big-endian, as in
+// UDS) and status. Reassembly buffer is preallocated, nothing allocates here.
+static ecu_isotp_rx_t dtc_rx;
+static const ecu_can_bus_t* tx_bus = NULL;
+static ecu_dtc_t dtcs[ECU_DTC_MAX];
+static size_t dtc_count = 0;
+static volatile uint32_t dtc_seq = 0;
+
+static void deliver_dtcs(void* ctx, const uint8_t* data, uint16_t len)
+{
+    (void)ctx;
+    if (len < 1 || len < 1u + 3u * data[0]) return;
+
+    size_t count = data[0];
+    dtc_seq++;
+    __sync_synchronize();
+    for (size_t i = 0; i < count && i < ECU_DTC_MAX; i++) {
+        const uint8_t* entry = data + 1 + 3 * i;
+        dtcs[i].code = (uint16_t)((entry[0] << 8) | entry[1]);
+        dtcs[i].status = entry[2];
+    }
+    dtc_count = count;
+    __sync_synchronize();
+    dtc_seq++;
+}
+
+static bool send_isotp_frame(void* ctx, uint32_t can_id, const uint8_t* data, uint8_t len)
+{
+    ecu_can_frame_t frame;
+    (void)ctx;
+    if (tx_bus == NULL) return false;
+    ecu_can_frame_set(&frame, can_id, data, len, 0);
+    return ecu_can_bus_send(tx_bus, &frame, 0);
+}
+
+static bool decode_dtc_frame(const uint8_t* data, uint8_t length, uint32_t now)
+{
+    ecu_isotp_rx_frame(&dtc_rx, data, length, now);
+    return true;
+}
+
+#define CH(ch)  (1u << (ch))
+
+// Registered decoders; the hardware acceptance filter, the bus
+// instrumentation and the staleness timeouts are derived from this table
+typedef struct {
+    uint32_t can_id;
+    uint16_t expected_hz;        // Rate from ecu_can_spec.h
+    uint32_t channels;           // ECU_CH_* bits carried by the frame
+    bool (*decode)(const uint8_t* data, uint8_t length, uint32_t now);
+} can_decoder_t;
+
+static const can_decoder_t can_decoders[] = {
+    { CAN_TCU_DATA_ID,      ECU_CAN_HZ_TCU,           CH(ECU_CH_TORQUE_REQUEST), decode_tcu_frame },
+    { CAN_ECU_DATA_ID,      ECU_CAN_HZ_ENGINE,
+      CH(ECU_CH_ENGINE_RPM) | CH(ECU_CH_MAP_PRESSURE) | CH(ECU_CH_TPS_POSITION), decode_ecu_frame },
+    { CAN_BOOST_CONTROL_ID, ECU_CAN_HZ_BOOST_CONTROL,
+      CH(ECU_CH_WASTEGATE_POSITION) | CH(ECU_CH_TARGET_BOOST), decode_boost_control_frame },
+    { CAN_ENGINE_TEMPS_ID,  ECU_CAN_HZ_ENGINE_TEMPS,  0, decode_engine_temps_frame },
+    { CAN_DTC_ID,           0,                        0, decode_dtc_frame },
+};
+
+#define CAN_DECODER_COUNT   (sizeof(can_decoders) / sizeof(can_decoders[0]))
+
+// Per-message freshness: one timestamp per decoder, written in O(1) per frame
+typedef struct {
+    uint32_t last_rx;            // lv_tick_get() of the last decoded frame
+    uint32_t timeout_ms;         // Stale once older than this
+    bool seen;
+} can_message_age_t;
+
+static can_message_age_t message_ages[CAN_DECODER_COUNT];
+static int8_t channel_source[ECU_CH_COUNT];     // Decoder index per channel, -1 if none
+
+static ecu_can_filter_t acceptance_filter;
+static uint32_t rejected_frames = 0;
+
+// Default timeout: CAN_STALE_PERIODS frame periods, at least CAN_STALE_MIN_MS
+static uint32_t default_stale_timeout(uint16_t expected_hz)
+{
+    if (expected_hz == 0) return CAN_STALE_APERIODIC_MS;
+    uint32_t timeout = CAN_STALE_PERIODS * 1000u / expected_hz;
+    return timeout < CAN_STALE_MIN_MS ? CAN_STALE_MIN_MS : timeout;
+}
+
+static bool message_is_fresh(size_t index, uint32_t now)
+{
+    const can_message_age_t* age = &message_ages[index];
+    return age->seen && (now - age->last_rx) <= age->timeout_ms;
+}
+
+// Decode one frame; the decoder checks the length against the message DLC
+// once, signal extraction itself is bounds-checked when the tables are built
+static void handle_frame(uint32_t can_id, const uint8_t* data, uint8_t length, bool extended)
+{
+    const can_decoder_t* decoder = NULL;
+    size_t index = 0;
+    
+    // Rate/jitter/bus-load accounting sees every frame the filter lets through
+    uint32_t rx_us = ecu_bus_stats_now_us();
+    ecu_bus_stats_record(can_id, length, extended, rx_us);
+    
+    for (size_t i = 0; i < CAN_DECODER_COUNT; i++) {
+        if (can_decoders[i].can_id == can_id) {
+            decoder = &can_decoders[i];
+            index = i;
             break;
-            
-        default:
-            // Unknown CAN ID
-            return;
+        }
+    }
+    
+    if (decoder == NULL) {
+        // No decoder: the hardware filter let it through, drop in software
+        rejected_frames++;
+        return;
+    }
+    
+    uint32_t now = lv_tick_get();
+    uint16_t map_before = current_fx.map_pressure;
+    if (!decoder->decode(data, length, now)) {
+        // Too short: nothing was decoded, freshness and validity stay as they were
+        return;
+    }
+    message_ages[index].last_rx = now;
+    message_ages[index].seen = true;
+    
+    // Trace a MAP change through to the display
+    if (current_fx.map_pressure != map_before && ecu_latency_begin(rx_us)) {
+        ecu_latency_mark(ECU_LAT_DECODE, ecu_bus_stats_now_us());
     }
     
     // Update timestamp and validity
-    last_update_time = lv_tick_get();
-    current_ecu_data.timestamp = last_update_time;
+    last_update_time = now;
+    current_fx.timestamp = last_update_time;
     data_valid = true;
 }
 
+// Main CAN message handler
+void can_message_handler(uint32_t can_id, const uint8_t* data, uint8_t length)
+{
+    if (length > ECU_CAN_FD_MAX_LEN) length = ECU_CAN_FD_MAX_LEN;
+    handle_frame(can_id, data, length, can_id > 0x7FF);
+}
+
+// Frame handler for transports that deliver ecu_can_frame_t
+void can_frame_handler(const ecu_can_frame_t* frame)
+{
+    if (frame->flags & ECU_CAN_FRAME_RTR) return;
+    handle_frame(frame->id, frame->data, frame->len, (frame->flags & ECU_CAN_FRAME_EXTENDED) != 0);
+}
+
+// Drain a transport into the decoder
+uint16_t can_bus_poll(const ecu_can_bus_t* bus, uint16_t max_frames)
+{
+    ecu_can_frame_t frame;
+    uint16_t count = 0;
+    
+    while (count < max_frames && ecu_can_bus_receive(bus, &frame, 0)) {
+        can_frame_handler(&frame);
+        count++;
+    }
+    return count;
+}
+
+// Copy the IDs that have a registered decoder
+size_t can_get_decoder_ids(uint32_t* ids, size_t max_ids)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < CAN_DECODER_COUNT && count < max_ids; i++) {
+        ids[count++] = can_decoders[i].can_id;
+    }
+    return count;
+}
+
+// Acceptance filter computed at init
+const ecu_can_filter_t* can_get_acceptance_filter(void)
+{
+    return &acceptance_filter;
+}
+
+// Frames that reached the handler without a decoder
+uint32_t can_get_rejected_frames(void)
+{
+    return rejected_frames;
+}
+
+// Override the staleness timeout of one message
+bool can_set_stale_timeout(uint32_t can_id, uint32_t timeout_ms)
+{
+    for (size_t i = 0; i < CAN_DECODER_COUNT; i++) {
+        if (can_decoders[i].can_id == can_id) {
+            message_ages[i].timeout_ms = timeout_ms ? timeout_ms : default_stale_timeout(can_decoders[i].expected_hz);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Check one message against its own timeout
+bool can_message_is_fresh(uint32_t can_id)
+{
+    uint32_t now = lv_tick_get();
+    for (size_t i = 0; i < CAN_DECODER_COUNT; i++) {
+        if (can_decoders[i].can_id == can_id) return message_is_fresh(i, now);
+    }
+    return false;
+}
+
+// Check the message that carries a channel
+bool ecu_channel_is_fresh(ecu_channel_t channel)
+{
+    if (channel >= ECU_CH_COUNT || channel_source[channel] < 0) return false;
+    return message_is_fresh((size_t)channel_source[channel], lv_tick_get());
+}
+
+// Channels whose message timed out (or never arrived)
+uint32_t ecu_stale_channels(void)
+{
+    uint32_t now = lv_tick_get();
+    uint32_t stale = 0;
+
+    for (size_t i = 0; i < CAN_DECODER_COUNT; i++) {
+        if (!message_is_fresh(i, now)) stale |= can_decoders[i].channels;
+    }
+    // Channels without a decoder never become fresh
+    for (int ch = 0; ch < ECU_CH_COUNT; ch++) {
+        if (channel_source[ch] < 0) stale |= CH(ch);
+    }
+    return stale;
+}
+
 // Initialize CAN interface
 void can_interface_init(void)
 {
     // Initialize CAN hardware (implementation depends on MCU)
-    // This is a placeholder for actual CAN initialization
+    // On ESP32 ecu_can_supervisor_start() installs the TWAI driver and keeps
+    // it on the bus; pass can_controller_alert_handler to count its errors
+    
+    // Derive the acceptance filter from the registered decoders; the driver
+    // applies can_get_acceptance_filter() (accept-all if it could not be covered)
+    uint32_t ids[ECU_CAN_FILTER_MAX_IDS];
+    size_t id_count = can_get_decoder_ids(ids, ECU_CAN_FILTER_MAX_IDS);
+    ecu_can_filter_compute(ids, id_count, &acceptance_filter);
+    rejected_frames = 0;
     
-    // Set up CAN filters for our message IDs
-    // can_set_filter(CAN_TCU_DATA_ID, 0x7FF);
-    // can_set_filter(CAN_ECU_DATA_ID, 0x7FF);
-    // can_set_filter(CAN_BOOST_CONTROL_ID, 0x7FF);
+    ecu_bus_stats_init(ECU_BUS_STATS_BITRATE);
+    for (int ch = 0; ch < ECU_CH_COUNT; ch++) {
+        channel_source[ch] = -1;
+    }
+    for (size_t i = 0; i < CAN_DECODER_COUNT; i++) {
+        ecu_bus_stats_register(can_decoders[i].can_id, can_decoders[i].expected_hz);
+        message_ages[i].seen = false;
+        message_ages[i].timeout_ms = default_stale_timeout(can_decoders[i].expected_hz);
+        for (int ch = 0; ch < ECU_CH_COUNT; ch++) {
+            if (can_decoders[i].channels & CH(ch)) channel_source[ch] = (int8_t)i;
+        }
+    }
     
     // Enable CAN interrupts
     // can_enable_interrupts();
     
-    // Initialize data structure
-    memset(&current_ecu_data, 0, sizeof(current_ecu_data));
-    current_ecu_data.map_pressure = 100.0f;      // Default atmospheric
-    current_ecu_data.wastegate_position = 50.0f;  // Default mid-position
-    current_ecu_data.engine_rpm = 800.0f;         // Default idle RPM
-    current_ecu_data.target_boost = 120.0f;       // Default target
+    // Initialize data structure (raw CAN units)
+    memset(&current_fx, 0, sizeof(current_fx));
+    current_fx.map_pressure = 1000;              // Default atmospheric, 100.0 kPa
+    current_fx.wastegate_position = 50;          // Default mid-position, 50%
+    current_fx.engine_rpm = 800;                 // Default idle RPM
+    current_fx.target_boost = 1200;              // Default target, 120.0 kPa
+    
+    memset(&engine_temps, 0, sizeof(engine_temps));
+    dtc_count = 0;
+    ecu_isotp_rx_init(&dtc_rx, CAN_DTC_ID, CAN_DTC_FC_ID, deliver_dtcs, send_isotp_frame, NULL);
+    ecu_can_tx_init();
+    
+    ecu_history_reset();
+    ecu_stats_init();
+    ecu_latency_reset();
     
     data_valid = false;
     last_update_time = 0;
 }
 
-// Get current ECU data
+// Transport for flow control and other frames the dashboard sends
+void can_set_tx_bus(const ecu_can_bus_t* bus)
+{
+    tx_bus = bus;
+}
+
+// Consistent copy of the 0x381 temperatures
+void ecu_get_engine_temps(ecu_engine_temps_t* out)
+{
+    uint32_t seq;
+    do {
+        seq = engine_temps_seq;
+        __sync_synchronize();
+        *out = engine_temps;
+        __sync_synchronize();
+    } while ((seq & 1u) || seq != engine_temps_seq);
+}
+
+// Consistent copy of the last DTC list
+size_t ecu_get_dtcs(ecu_dtc_t* out, size_t max)
+{
+    uint32_t seq;
+    size_t count;
+    do {
+        seq = dtc_seq;
+        __sync_synchronize();
+        count = dtc_count;
+        for (size_t i = 0; i < count && i < max && i < ECU_DTC_MAX; i++) {
+            out[i] = dtcs[i];
+        }
+        __sync_synchronize();
+    } while ((seq & 1u) || seq != dtc_seq);
+    return count;
+}
+
+// SAE J2012 display form: system letter, then four hex digits
+void ecu_dtc_format(uint16_t code, char* out)
+{
+    static const char systems[4] = {'P', 'C', 'B', 'U'};
+    static const char hex[] = "0123456789ABCDEF";
+    out[0] = systems[code >> 14];
+    out[1] = hex[(code >> 12) & 0x3];
+    out[2] = hex[(code >> 8) & 0xF];
+    out[3] = hex[(code >> 4) & 0xF];
+    out[4] = hex[code & 0xF];
+    out[5] = '\0';
+}
+
+const ecu_isotp_stats_t* can_get_isotp_stats(void)
+{
+    return &dtc_rx.stats;
+}
+
+// Get current ECU data, converted to engineering units on demand
 ecu_data_t* ecu_get_current_data(void)
 {
+    ecu_fx_to_float(&current_fx, &current_ecu_data);
     return &current_ecu_data;
 }
 
-// Check if data is valid and recent
+// Get current ECU data in raw CAN units
+const ecu_data_fx_t* ecu_get_current_data_fx(void)
+{
+    return &current_fx;
+}
+
+// Check if the link is alive: any message decoded recently
 bool ecu_data_is_fresh(uint32_t max_age_ms)
 {
     if (!data_valid) return false;
@@ -185,50 +479,55 @@ bool ecu_data_is_fresh(uint32_t max_age_ms)
     return (age <= max_age_ms);
 }
 
-// Simulate CAN data for testing (when no real CAN bus available)
+// Simulate CAN data for testing (when no real CAN bus available).
+// The seeded engine/turbo model in ecu_sim.c sends spec frames at the
+// documented rates on an in-memory bus, read back through can_bus_poll()
+// like the real one: filter, decoders, staleness and statistics all run.
+static ecu_sim_t sim;
+static ecu_can_bus_t sim_bus;
+static ecu_can_standin_t sim_standin;
+static bool sim_started = false;
+
+// Commands the dashboard sends go to the model (boost target, safety mode)
+static bool sim_command_send(void* ctx, const ecu_can_frame_t* frame, uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+    ecu_sim_receive((ecu_sim_t*)ctx, frame);
+    return true;
+}
+
+static const ecu_can_bus_t sim_command_bus = {
+    .send = sim_command_send,
+    .receive = NULL,
+    .max_len = ECU_CAN_CLASSIC_MAX_LEN,
+    .name = "sim",
+    .ctx = &sim,
+};
+
 void simulate_can_data(void)
 {
-    static uint32_t last_sim_time = 0;
-    static float sim_phase = 0.0f;
+    uint32_t now = lv_tick_get();
     
-    uint32_t current_time = lv_tick_get();
-    
-    // Update simulation every 50ms (20Hz)
-    if (current_time - last_sim_time >= 50) {
-        last_sim_time = current_time;
-        sim_phase += 0.1f;
-        
-        // Simulate realistic ECU data
-        current_ecu_data.engine_rpm = 1500.0f + sinf(sim_phase * 0.3f) * 500.0f;
-        current_ecu_data.map_pressure = 120.0f + sinf(sim_phase * 0.5f) * 30.0f;
-        current_ecu_data.tps_position = 20.0f + sinf(sim_phase * 0.8f) * 40.0f;
-        current_ecu_data.wastegate_position = 50.0f + sinf(sim_phase * 0.4f) * 20.0f;
-        current_ecu_data.target_boost = 140.0f + sinf(sim_phase * 0.2f) * 20.0f;
-        current_ecu_data.torque_request = 30.0f + sinf(sim_phase * 0.6f) * 25.0f;
-        
-        // Simulate protection modes occasionally
-        if ((int)(sim_phase * 10) % 100 < 5) {
-            current_ecu_data.tcu_protection_active = true;
-        } else {
-            current_ecu_data.tcu_protection_active = false;
-        }
-        
-        if ((int)(sim_phase * 10) % 200 < 3) {
-            current_ecu_data.tcu_limp_mode = true;
-        } else {
-            current_ecu_data.tcu_limp_mode = false;
-        }
-        
-        current_ecu_data.timestamp = current_time;
-        data_valid = true;
-        last_update_time = current_time;
+    if (!sim_started) {
+        ecu_can_standin_init(&sim_bus, &sim_standin, false);
+        ecu_sim_init(&sim, ECU_SIM_SEED, now);
+        if (tx_bus == NULL) tx_bus = &sim_command_bus;
+        sim_started = true;
     }
+    
+    // The bus holds ECU_CAN_STANDIN_DEPTH frames; the model waits while it is drained
+    do {
+        ecu_sim_run(&sim, &sim_bus, now);
+    } while (can_bus_poll(&sim_bus, ECU_CAN_STANDIN_DEPTH) && sim.now_ms != now);
 }
 
-// CAN transmit function for sending commands back to ECU
-void can_send_boost_command(float target_boost, uint8_t control_mode)
+// CAN transmit function for sending commands back to ECU. Only queues the
+// frame: the UI thread must never wait for the bus.
+bool can_send_boost_command(float target_boost, uint8_t control_mode)
 {
     uint8_t tx_data[8] = {0};
+    ecu_can_frame_t frame;
+    ecu_can_tx_class_t cls;
     
     // Prepare boost control command
     uint16_t scaled_target = (uint16_t)(target_boost * 10.0f);
@@ -241,17 +540,34 @@ void can_send_boost_command(float target_boost, uint8_t control_mode)
     tx_data[6] = 0;
     tx_data[7] = 0;
     
-    // Send CAN message (implementation depends on CAN driver)
-    // can_transmit(0x201, tx_data, 8);
+    // Every command carries the full state, so a newer one supersedes
+    // older ones still queued: safety preempts all, mode changes drop
+    // pending setpoints, setpoints coalesce
+    switch (control_mode) {
+        case BOOST_MODE_SAFETY:
+            cls = ECU_CAN_TX_SAFETY;
+            break;
+        case BOOST_MODE_MANUAL:
+            cls = ECU_CAN_TX_SETPOINT;
+            break;
+        default:
+            cls = ECU_CAN_TX_COMMAND;
+            break;
+    }
+    
+    ecu_can_frame_set(&frame, CAN_BOOST_COMMAND_ID, tx_data, sizeof(tx_data), 0);
+    return ecu_can_tx_submit(&frame, cls);
 }
 
 // Error handling for CAN bus errors
 void can_error_handler(uint32_t error_code)
 {
+    ecu_bus_stats_record_error(error_code);
+    
     // Handle different CAN error types
     switch (error_code) {
         case CAN_ERROR_BUS_OFF:
-            // Reset CAN controller
+            // The supervisor recovers the controller; values go stale meanwhile
             data_valid = false;
             break;
             
@@ -271,6 +587,14 @@ void can_error_handler(uint32_t error_code)
     }
 }
 
+// Supervisor alerts into the error counters
+void can_controller_alert_handler(uint32_t alerts)
+{
+    if (alerts & ECU_CAN_ALERT_BUS_OFF) can_error_handler(CAN_ERROR_BUS_OFF);
+    if (alerts & ECU_CAN_ALERT_ERR_PASSIVE) can_error_handler(CAN_ERROR_PASSIVE);
+    if (alerts & ECU_CAN_ALERT_RX_OVERRUN) can_error_handler(CAN_ERROR_OVERRUN);
+}
+
 // Periodic maintenance function
 void can_interface_task(void)
 {
@@ -278,6 +602,18 @@ void can_interface_task(void)
     if (data_valid && (lv_tick_get() - last_update_time > 500)) {
         data_valid = false;
     }
+
+    // Expire a DTC message whose consecutive frames stopped; the RX path only
+    // notices N_Cr when the next frame on 0x3A0 arrives
+    ecu_isotp_rx_poll(&dtc_rx, lv_tick_get());
+
+    // Host builds have no TX task: send the queued commands that are due
+    #if !defined(ESP_PLATFORM)
+    if (tx_bus) {
+        while (ecu_can_tx_service(tx_bus, ecu_can_supervisor_now_ms())) {
+        }
+    }
+    #endif
     
     // In simulation mode, generate test data
     #ifdef SIMULATION_MODE
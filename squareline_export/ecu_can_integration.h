@@ -11,6 +11,12 @@
 #include <math.h>
 #include "lvgl.h"
 #include "ecu_data_structures.h"
+#include "ecu_can_filter.h"
+#include "ecu_can_spec.h"
+#include "ecu_can_bus.h"
+#include "ecu_isotp.h"
+#include "ecu_can_tx.h"
+#include "ecu_sim.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,11 +29,46 @@ extern "C" {
 #define CAN_ERROR_TIMEOUT       0x03
 #define CAN_ERROR_OVERRUN       0x04
 
-// CAN message IDs
-#define CAN_TCU_DATA_ID         0x440
-#define CAN_ECU_DATA_ID         0x380
-#define CAN_BOOST_CONTROL_ID    0x200
+// Staleness: a message (and the channels it carries) is stale once no frame
+// arrived for CAN_STALE_PERIODS expected periods, never less than CAN_STALE_MIN_MS
+#define CAN_STALE_PERIODS       5
+#define CAN_STALE_MIN_MS        50
+#define CAN_STALE_APERIODIC_MS  1000    // Messages without an expected rate
+
+// CAN message IDs (layouts in ecu_can_spec.h)
+#define CAN_TCU_DATA_ID         ECU_CAN_ID_TCU
+#define CAN_ECU_DATA_ID         ECU_CAN_ID_ENGINE
+#define CAN_BOOST_CONTROL_ID    ECU_CAN_ID_BOOST_CONTROL
+#define CAN_ENGINE_TEMPS_ID     ECU_CAN_ID_ENGINE_TEMPS
 #define CAN_BOOST_COMMAND_ID    0x201
+#define CAN_DTC_ID              0x3A0   // ISO-TP, ECU -> dashboard
+#define CAN_DTC_FC_ID           0x3A1   // ISO-TP flow control, dashboard -> ECU
+
+#define ECU_CYLINDERS           6
+#define ECU_DTC_MAX             32
+
+// Seed of the simulated traffic (SIMULATION_MODE); equal seeds replay identical frames
+#ifndef ECU_SIM_SEED
+#define ECU_SIM_SEED            1
+#endif
+
+// Temperatures from the multiplexed 0x381 pages, 0.1 degC
+typedef struct {
+    int16_t coolant;
+    int16_t oil;
+    int16_t egt[ECU_CYLINDERS];
+    uint8_t valid;               // ECU_TEMPS_VALID_* and (ECU_TEMPS_VALID_EGT1 << cylinder)
+} ecu_engine_temps_t;
+
+#define ECU_TEMPS_VALID_COOLANT (1 << 0)
+#define ECU_TEMPS_VALID_OIL     (1 << 1)
+#define ECU_TEMPS_VALID_EGT1    (1 << 2)
+
+// Diagnostic trouble code (SAE J2012 code, status byte as sent by the ECU)
+typedef struct {
+    uint16_t code;
+    uint8_t status;
+} ecu_dtc_t;
 
 // Boost control modes
 #define BOOST_MODE_MANUAL       0x00
@@ -46,10 +87,82 @@ void can_interface_init(void);
  * Main CAN message handler - called by CAN interrupt
  * @param can_id CAN message ID
  * @param data Pointer to CAN data bytes
- * @param length Number of data bytes (0-8)
+ * @param length Number of data bytes (0-8, up to 64 for CAN FD)
  */
 void can_message_handler(uint32_t can_id, const uint8_t* data, uint8_t length);
 
+/**
+ * Frame handler for ecu_can_bus_t transports (classic or FD)
+ * @param frame Received frame; remote requests are ignored
+ */
+void can_frame_handler(const ecu_can_frame_t* frame);
+
+/**
+ * Decode every frame a transport has queued, without waiting
+ * @param bus Transport (ecu_can_bus_twai() or a stand-in bus)
+ * @param max_frames Upper bound per call
+ * @return Frames decoded
+ */
+uint16_t can_bus_poll(const ecu_can_bus_t* bus, uint16_t max_frames);
+
+/**
+ * Get the CAN IDs that have a registered decoder
+ * @param ids Output array
+ * @param max_ids Capacity of ids
+ * @return Number of IDs written
+ */
+size_t can_get_decoder_ids(uint32_t* ids, size_t max_ids);
+
+/**
+ * Get the acceptance filter computed by can_interface_init().
+ * Fields map 1:1 onto twai_filter_config_t; hardware == false means the
+ * ID set could not be covered and filtering is done in software only.
+ * @return Pointer to the filter configuration
+ */
+const ecu_can_filter_t* can_get_acceptance_filter(void);
+
+/**
+ * Get the number of frames dropped in software because no decoder matched
+ * @return Rejected frame count since init
+ */
+uint32_t can_get_rejected_frames(void);
+
+/**
+ * Transport for frames the dashboard sends (ISO-TP flow control). Without
+ * one, segmented diagnostics only work with senders that do not wait for
+ * flow control. Host builds also drain the boost command queue into it
+ * from can_interface_task(); on ESP32 the ecu_can_tx task does that.
+ * @param bus Transport, NULL to disable
+ */
+void can_set_tx_bus(const ecu_can_bus_t* bus);
+
+/**
+ * Copy the temperatures decoded from 0x381
+ * @param out Temperatures; fields not received yet are flagged in valid
+ */
+void ecu_get_engine_temps(ecu_engine_temps_t* out);
+
+/**
+ * Copy the last DTC list received over ISO-TP on CAN_DTC_ID
+ * @param out Output array
+ * @param max Capacity of out
+ * @return Number of DTCs in the list (may exceed max)
+ */
+size_t ecu_get_dtcs(ecu_dtc_t* out, size_t max);
+
+/**
+ * Format a DTC code the way scan tools show it ("P0301")
+ * @param code SAE J2012 code
+ * @param out Buffer of at least 6 characters
+ */
+void ecu_dtc_format(uint16_t code, char* out);
+
+/**
+ * Get the ISO-TP counters of the DTC channel
+ * @return Pointer to the live counters
+ */
+const ecu_isotp_stats_t* can_get_isotp_stats(void);
+
 /**
  * Get pointer to current ECU data structure
  * @return Pointer to current ECU data
@@ -57,18 +170,57 @@ void can_message_handler(uint32_t can_id, const uint8_t* data, uint8_t length);
 ecu_data_t* ecu_get_current_data(void);
 
 /**
- * Check if ECU data is fresh and valid
+ * Get pointer to current ECU data in raw CAN units (no float conversion)
+ * @return Pointer to the fixed-point snapshot
+ */
+const ecu_data_fx_t* ecu_get_current_data_fx(void);
+
+/**
+ * Check if the ECU link is alive (any message decoded within max_age_ms).
+ * Individual values can still be stale, see ecu_stale_channels().
  * @param max_age_ms Maximum acceptable age in milliseconds
  * @return true if data is valid and within age limit
  */
 bool ecu_data_is_fresh(uint32_t max_age_ms);
 
 /**
- * Send boost control command to ECU
+ * Check one channel against the timeout of the message that carries it
+ * @param channel ECU channel
+ * @return true if its message arrived within its timeout
+ */
+bool ecu_channel_is_fresh(ecu_channel_t channel);
+
+/**
+ * Get the channels whose message timed out or never arrived
+ * @return Bitmask of (1 << ECU_CH_*)
+ */
+uint32_t ecu_stale_channels(void);
+
+/**
+ * Check one message against its timeout
+ * @param can_id CAN ID with a registered decoder
+ * @return true if it arrived within its timeout
+ */
+bool can_message_is_fresh(uint32_t can_id);
+
+/**
+ * Override the staleness timeout of a message (after can_interface_init())
+ * @param can_id CAN ID with a registered decoder
+ * @param timeout_ms Timeout, 0 restores the one derived from the expected rate
+ * @return false if the ID has no decoder
+ */
+bool can_set_stale_timeout(uint32_t can_id, uint32_t timeout_ms);
+
+/**
+ * Queue a boost control command for the ECU; never blocks, safe from LVGL
+ * event handlers. BOOST_MODE_SAFETY goes out before anything else and
+ * drops pending commands; manual setpoints coalesce to the latest value
+ * and are sent at most every ECU_CAN_TX_SETPOINT_MIN_MS.
  * @param target_boost Target boost pressure in kPa
  * @param control_mode Control mode (manual/auto/safety)
+ * @return false if the TX queue had no room
  */
-void can_send_boost_command(float target_boost, uint8_t control_mode);
+bool can_send_boost_command(float target_boost, uint8_t control_mode);
 
 /**
  * Handle CAN bus errors
@@ -76,6 +228,13 @@ void can_send_boost_command(float target_boost, uint8_t control_mode);
  */
 void can_error_handler(uint32_t error_code);
 
+/**
+ * Controller alert callback for the CAN supervisor; maps ECU_CAN_ALERT_*
+ * bits onto can_error_handler() codes
+ * @param alerts ECU_CAN_ALERT_* bits
+ */
+void can_controller_alert_handler(uint32_t alerts);
+
 /**
  * Periodic maintenance task for CAN interface
  * Should be called regularly (e.g., every 10ms)
@@ -83,7 +242,9 @@ void can_error_handler(uint32_t error_code);
 void can_interface_task(void);
 
 /**
- * Simulate CAN data for testing without real CAN bus
+ * Simulate CAN data for testing without real CAN bus: frames from the
+ * ecu_sim model (seed ECU_SIM_SEED) go through can_bus_poll(). Without a
+ * TX bus, boost commands are fed back to the model.
  * Only used in simulation mode
  */
 void simulate_can_data(void);
@@ -91,13 +252,13 @@ void simulate_can_data(void);
 // Inline helper functions
 
 /**
- * Convert raw torque value to percentage
- * @param raw_value Raw value from CAN (0-255)
+ * Convert raw torque value to percentage of ECU_TORQUE_FULL_SCALE_NM
+ * @param raw_value Raw value from CAN (1 Nm/bit)
  * @return Torque percentage (0.0-100.0)
  */
-static inline float convert_torque_to_percent(uint8_t raw_value)
+static inline float convert_torque_to_percent(uint16_t raw_value)
 {
-    return (raw_value == 255) ? 0.0f : (float)raw_value * 0.39f;
+    return (float)raw_value * (100.0f / ECU_TORQUE_FULL_SCALE_NM);
 }
 
 /**
@@ -112,32 +273,32 @@ static inline float convert_pressure_to_kpa(uint16_t raw_value)
 
 /**
  * Convert raw position value to percentage
- * @param raw_value Raw value from CAN (0-255)
+ * @param raw_value Raw value from CAN (1 %/bit)
  * @return Position percentage (0.0-100.0)
  */
 static inline float convert_position_to_percent(uint8_t raw_value)
 {
-    return (float)raw_value * 0.392f;
+    return (float)raw_value;
 }
 
 /**
  * Check if TCU is in protection mode
- * @param protection_flags Flags from CAN message
- * @return true if protection is active
+ * @param protection_flags Flags from CAN message (0x440 byte 2)
+ * @return true if overheat, overspeed, low pressure or clutch slip is flagged
  */
 static inline bool is_tcu_protection_active(uint8_t protection_flags)
 {
-    return (protection_flags & 0x02) != 0; // Bit 1
+    return (protection_flags & 0x0F) != 0; // Bits 0-3
 }
 
 /**
  * Check if TCU is in limp mode
- * @param limp_status Limp mode status from CAN
+ * @param protection_flags Flags from CAN message (0x440 byte 2)
  * @return true if in limp mode
  */
-static inline bool is_tcu_limp_mode(uint8_t limp_status)
+static inline bool is_tcu_limp_mode(uint8_t protection_flags)
 {
-    return (limp_status != 5 && limp_status != 6 && limp_status != 7 && limp_status > 0);
+    return (protection_flags & 0x20) != 0; // Bit 5
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,250 @@
+/**
+ * CAN message layouts for the ECU Dashboard
+ * Tables expanded from ecu_can_spec.h, signal extraction/insertion and the
+ * conformance check against the example frames of the document
+ */
+
+#include "ecu_can_spec.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MSG_ENTRY(name, id, dlc, hz, sel) \
+    [ECU_MSG_##name] = { #name, id, dlc, hz, ECU_SIG_##sel },
+const ecu_can_msg_spec_t ecu_can_msgs[ECU_MSG_COUNT] = {
+    ECU_CAN_SPEC_MESSAGES(MSG_ENTRY)
+};
+#undef MSG_ENTRY
+
+#define SIG_ENTRY(name, msg, mux, start, bits, sgn, mul, div, off, unit) \
+    [ECU_SIG_##name] = { #name, unit, ECU_MSG_##msg, mux, start, bits, sgn, mul, div, off },
+const ecu_can_sig_spec_t ecu_can_sigs[ECU_SIG_COUNT] = {
+    ECU_CAN_SPEC_SIGNALS(SIG_ENTRY)
+};
+#undef SIG_ENTRY
+
+// Table-build-time bounds: a message with an invalid payload size or a
+// signal that leaves its frame is a negative array size
+#define MSG_FITS(name, id, dlc, hz, sel) \
+    typedef char msg_fits_##name[((dlc) <= 8 || (dlc) == 12 || (dlc) == 16 || (dlc) == 20 || (dlc) == 24 || \
+                                  (dlc) == 32 || (dlc) == 48 || (dlc) == 64) ? 1 : -1];
+ECU_CAN_SPEC_MESSAGES(MSG_FITS)
+#undef MSG_FITS
+
+#define SIG_FITS(name, msg, mux, start, bits, sgn, mul, div, off, unit) \
+    typedef char sig_fits_##name[((bits) >= 1 && (bits) <= 32 && (start) + (bits) <= ECU_CAN_DLC_##msg * 8 && \
+                                  (mul) != 0 && (div) != 0) ? 1 : -1];
+ECU_CAN_SPEC_SIGNALS(SIG_FITS)
+#undef SIG_FITS
+
+typedef struct {
+    ecu_can_msg_id_t msg;
+    uint8_t data[ECU_CAN_CLASSIC_MAX_LEN];
+} spec_example_t;
+
+#define EXAMPLE_ENTRY(msg, b0, b1, b2, b3, b4, b5, b6, b7) \
+    { ECU_MSG_##msg, { b0, b1, b2, b3, b4, b5, b6, b7 } },
+static const spec_example_t examples[] = {
+    ECU_CAN_SPEC_EXAMPLES(EXAMPLE_ENTRY)
+};
+#undef EXAMPLE_ENTRY
+
+typedef struct {
+    ecu_can_sig_id_t sig;
+    int32_t tenths;
+} spec_expected_t;
+
+#define EXPECTED_ENTRY(sig, tenths) { ECU_SIG_##sig, tenths },
+static const spec_expected_t expected[] = {
+    ECU_CAN_SPEC_EXPECTED(EXPECTED_ENTRY)
+};
+#undef EXPECTED_ENTRY
+
+#define EXAMPLE_COUNT   (sizeof(examples) / sizeof(examples[0]))
+#define EXPECTED_COUNT  (sizeof(expected) / sizeof(expected[0]))
+
+static uint32_t sig_mask(const ecu_can_sig_spec_t* s)
+{
+    return s->bits >= 32 ? 0xFFFFFFFFu : (1u << s->bits) - 1u;
+}
+
+int32_t ecu_can_sig_get(ecu_can_sig_id_t sig, const uint8_t* data)
+{
+    const ecu_can_sig_spec_t* s = &ecu_can_sigs[sig];
+    uint8_t first = s->start_bit >> 3;
+    uint8_t last = (uint8_t)((s->start_bit + s->bits - 1) >> 3);
+    uint8_t shift = s->start_bit & 7;
+    uint64_t bytes = 0;
+
+    // Only the bytes the signal covers are read (up to 5 for an unaligned 32-bit signal)
+    for (uint8_t i = last; ; i--) {
+        bytes = (bytes << 8) | data[i];
+        if (i == first) break;
+    }
+    uint32_t value = (uint32_t)(bytes >> shift) & sig_mask(s);
+
+    if (s->is_signed && s->bits < 32 && (value & (1u << (s->bits - 1)))) {
+        value |= ~sig_mask(s);
+    }
+    return (int32_t)value;
+}
+
+int32_t ecu_can_sig_get_tenths(ecu_can_sig_id_t sig, const uint8_t* data)
+{
+    const ecu_can_sig_spec_t* s = &ecu_can_sigs[sig];
+    int32_t raw = ecu_can_sig_get(sig, data);
+    if (s->div == 1) {
+        return raw * s->mul + s->offset;
+    }
+    return raw * s->mul / s->div + s->offset;
+}
+
+void ecu_can_sig_set(ecu_can_sig_id_t sig, uint8_t* data, int32_t raw)
+{
+    const ecu_can_sig_spec_t* s = &ecu_can_sigs[sig];
+    uint32_t mask = sig_mask(s);
+    int32_t min = s->is_signed ? -(int32_t)(mask >> 1) - 1 : 0;
+    int32_t max = s->is_signed ? (int32_t)(mask >> 1) : (int32_t)mask;
+
+    if (raw < min) raw = min;
+    if (raw > max) raw = max;
+
+    uint32_t value = (uint32_t)raw & mask;
+    uint16_t bit = s->start_bit;
+    uint16_t end = (uint16_t)(s->start_bit + s->bits);
+
+    while (bit < end) {
+        uint8_t shift = bit & 7;
+        uint8_t take = (uint8_t)(8 - shift);
+        if (take > end - bit) take = (uint8_t)(end - bit);
+        uint8_t byte_mask = (uint8_t)(((1u << take) - 1u) << shift);
+        data[bit >> 3] = (uint8_t)((data[bit >> 3] & ~byte_mask) | ((value << shift) & byte_mask));
+        value >>= take;
+        bit += take;
+    }
+}
+
+void ecu_can_sig_set_tenths(ecu_can_sig_id_t sig, uint8_t* data, int32_t tenths)
+{
+    const ecu_can_sig_spec_t* s = &ecu_can_sigs[sig];
+    int32_t num = (tenths - s->offset) * s->div;
+    int32_t raw = num >= 0 ? (num + s->mul / 2) / s->mul : (num - s->mul / 2) / s->mul;
+    ecu_can_sig_set(sig, data, raw);
+}
+
+bool ecu_can_sig_present(ecu_can_sig_id_t sig, const uint8_t* data)
+{
+    const ecu_can_sig_spec_t* s = &ecu_can_sigs[sig];
+    if (s->mux == ECU_MUX_NONE) return true;
+
+    int8_t selector = ecu_can_msgs[s->msg].mux_selector;
+    return selector != ECU_SIG_NONE && ecu_can_sig_get((ecu_can_sig_id_t)selector, data) == s->mux;
+}
+
+const ecu_can_msg_spec_t* ecu_can_spec_find(uint32_t can_id)
+{
+    for (int i = 0; i < ECU_MSG_COUNT; i++) {
+        if (ecu_can_msgs[i].can_id == can_id) return &ecu_can_msgs[i];
+    }
+    return NULL;
+}
+
+// Append one failure line to the report
+static void report_failure(char* report, size_t len, size_t* pos, const char* fmt, ...)
+{
+    if (report == NULL || *pos >= len) return;
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(report + *pos, len - *pos, fmt, args);
+    va_end(args);
+    if (n > 0) *pos += (size_t)n < len - *pos ? (size_t)n : len - *pos - 1;
+}
+
+// Two signals can appear in the same frame (plain, or same selector value)
+static bool sigs_coexist(const ecu_can_sig_spec_t* a, const ecu_can_sig_spec_t* b)
+{
+    return a->msg == b->msg && (a->mux == ECU_MUX_NONE || b->mux == ECU_MUX_NONE || a->mux == b->mux);
+}
+
+static bool sigs_overlap(const ecu_can_sig_spec_t* a, const ecu_can_sig_spec_t* b)
+{
+    return a->start_bit < b->start_bit + b->bits && b->start_bit < a->start_bit + a->bits;
+}
+
+// Mark the bits of a signal in a per-byte mask
+static void mark_bits(const ecu_can_sig_spec_t* s, uint8_t* mask)
+{
+    for (int bit = s->start_bit; bit < s->start_bit + s->bits; bit++) {
+        mask[bit >> 3] |= (uint8_t)(1u << (bit & 7));
+    }
+}
+
+int ecu_can_spec_check(char* report, size_t len)
+{
+    int failures = 0;
+    size_t pos = 0;
+
+    if (report && len) report[0] = '\0';
+
+    // Layout: signals that can share a frame do not share a bit; multiplexed
+    // signals need a selector
+    for (int i = 0; i < ECU_SIG_COUNT; i++) {
+        const ecu_can_sig_spec_t* s = &ecu_can_sigs[i];
+        const ecu_can_msg_spec_t* m = &ecu_can_msgs[s->msg];
+        if (s->mux != ECU_MUX_NONE && (m->mux_selector == ECU_SIG_NONE || m->mux_selector == i)) {
+            report_failure(report, len, &pos, "%s: multiplexed but %s has no selector\n", s->name, m->name);
+            failures++;
+        }
+        for (int j = 0; j < i; j++) {
+            const ecu_can_sig_spec_t* o = &ecu_can_sigs[j];
+            if (sigs_coexist(s, o) && sigs_overlap(s, o)) {
+                report_failure(report, len, &pos, "%s: overlaps %s in %s\n", s->name, o->name, m->name);
+                failures++;
+            }
+        }
+    }
+    if (failures) return failures;
+
+    // Example frames decode to the documented values
+    for (size_t e = 0; e < EXPECTED_COUNT; e++) {
+        const ecu_can_sig_spec_t* s = &ecu_can_sigs[expected[e].sig];
+        const spec_example_t* example = NULL;
+        for (size_t x = 0; x < EXAMPLE_COUNT; x++) {
+            if (examples[x].msg == s->msg) example = &examples[x];
+        }
+        if (example == NULL || !ecu_can_sig_present(expected[e].sig, example->data)) {
+            report_failure(report, len, &pos, "%s: not in the %s example frame\n", s->name, ecu_can_msgs[s->msg].name);
+            failures++;
+            continue;
+        }
+        int32_t got = ecu_can_sig_get_tenths(expected[e].sig, example->data);
+        if (got != expected[e].tenths) {
+            report_failure(report, len, &pos, "%s: decoded %ld, documented %ld (0.1 %s)\n", s->name,
+                           (long)got, (long)expected[e].tenths, s->unit);
+            failures++;
+        }
+    }
+
+    // Re-encoding every signal present in an example reproduces its defined bits
+    for (size_t x = 0; x < EXAMPLE_COUNT; x++) {
+        const ecu_can_msg_spec_t* m = &ecu_can_msgs[examples[x].msg];
+        uint8_t frame[ECU_CAN_CLASSIC_MAX_LEN] = {0};
+        uint8_t defined[ECU_CAN_CLASSIC_MAX_LEN] = {0};
+        for (int i = 0; i < ECU_SIG_COUNT; i++) {
+            if (ecu_can_sigs[i].msg != examples[x].msg) continue;
+            if (!ecu_can_sig_present((ecu_can_sig_id_t)i, examples[x].data)) continue;
+            ecu_can_sig_set_tenths((ecu_can_sig_id_t)i, frame,
+                                   ecu_can_sig_get_tenths((ecu_can_sig_id_t)i, examples[x].data));
+            mark_bits(&ecu_can_sigs[i], defined);
+        }
+        for (uint8_t b = 0; b < m->dlc && b < ECU_CAN_CLASSIC_MAX_LEN; b++) {
+            uint8_t want = examples[x].data[b] & defined[b];
+            if (frame[b] != want) {
+                report_failure(report, len, &pos, "%s: byte %u re-encoded as %02X, example %02X\n", m->name,
+                               b, frame[b], want);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
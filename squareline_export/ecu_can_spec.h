@@ -0,0 +1,212 @@
+/**
+ * CAN message layouts for the ECU Dashboard
+ * Single machine-readable copy of CAN_PROTOCOL_SPECIFICATION.md: the
+ * firmware decoder, the Arduino sketch and both simulators read and write
+ * frames through these tables, and ecu_can_spec_check() decodes the example
+ * frames of the document against their documented values.
+ */
+
+#ifndef ECU_CAN_SPEC_H
+#define ECU_CAN_SPEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ecu_can_frame.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Messages: X(name, can_id, dlc, rate_hz, mux_selector); dlc is the payload
+// in bytes, 0-8 or a CAN FD size (12, 16, 20, 24, 32, 48, 64); mux_selector
+// names the signal that selects the multiplexed signal set, or NONE
+#define ECU_CAN_SPEC_MESSAGES(X) \
+    X(BOOST_CONTROL, 0x200, 8, 50,  NONE)      \
+    X(ENGINE,        0x380, 8, 100, NONE)      \
+    X(ENGINE_TEMPS,  0x381, 8, 10,  TEMP_PAGE) \
+    X(TCU,           0x440, 8, 50,  NONE)
+
+// Signals, Intel (little-endian) bit numbering, bit 0 = LSB of byte 0:
+// X(name, message, mux, start_bit, bits, is_signed, mul, div, offset, unit)
+// mux is ECU_MUX_NONE for signals in every frame, otherwise the selector
+// value the signal is sent under. Physical value in 0.1 units:
+// tenths = raw * mul / div + offset.
+// A signal outside its frame, or wider than 32 bits, fails to compile.
+#define ECU_CAN_SPEC_SIGNALS(X) \
+    X(WASTEGATE_POSITION, BOOST_CONTROL, ECU_MUX_NONE, 0,  8,  false, 10, 1, 0,    "%")   \
+    X(TARGET_BOOST,       BOOST_CONTROL, ECU_MUX_NONE, 8,  16, false, 1,  1, 0,    "kPa") \
+    X(ACTUAL_BOOST,       BOOST_CONTROL, ECU_MUX_NONE, 24, 16, false, 1,  1, 0,    "kPa") \
+    X(BOOST_ERROR,        BOOST_CONTROL, ECU_MUX_NONE, 40, 8,  true,  10, 1, 0,    "%")   \
+    X(WASTEGATE_DUTY,     BOOST_CONTROL, ECU_MUX_NONE, 48, 16, false, 1,  1, 0,    "%")   \
+    X(ENGINE_RPM,         ENGINE,        ECU_MUX_NONE, 0,  16, false, 10, 1, 0,    "rpm") \
+    X(MAP_PRESSURE,       ENGINE,        ECU_MUX_NONE, 16, 16, false, 1,  1, 0,    "kPa") \
+    X(TPS_POSITION,       ENGINE,        ECU_MUX_NONE, 32, 8,  false, 10, 1, 0,    "%")   \
+    X(ENGINE_TEMP,        ENGINE,        ECU_MUX_NONE, 40, 8,  false, 10, 1, -400, "C")   \
+    X(FUEL_PRESSURE,      ENGINE,        ECU_MUX_NONE, 48, 16, false, 1,  1, 0,    "kPa") \
+    X(TEMP_PAGE,          ENGINE_TEMPS,  ECU_MUX_NONE, 0,  8,  false, 10, 1, 0,    "")    \
+    X(COOLANT_TEMP,       ENGINE_TEMPS,  0,            8,  8,  false, 10, 1, -400, "C")   \
+    X(OIL_TEMP,           ENGINE_TEMPS,  0,            16, 8,  false, 10, 1, -400, "C")   \
+    X(EGT_CYL1,           ENGINE_TEMPS,  1,            8,  16, false, 10, 1, 0,    "C")   \
+    X(EGT_CYL2,           ENGINE_TEMPS,  1,            24, 16, false, 10, 1, 0,    "C")   \
+    X(EGT_CYL3,           ENGINE_TEMPS,  1,            40, 16, false, 10, 1, 0,    "C")   \
+    X(EGT_CYL4,           ENGINE_TEMPS,  2,            8,  16, false, 10, 1, 0,    "C")   \
+    X(EGT_CYL5,           ENGINE_TEMPS,  2,            24, 16, false, 10, 1, 0,    "C")   \
+    X(EGT_CYL6,           ENGINE_TEMPS,  2,            40, 16, false, 10, 1, 0,    "C")   \
+    X(TORQUE_REQUEST,     TCU,           ECU_MUX_NONE, 0,  16, false, 10, 1, 0,    "Nm")  \
+    X(TCU_PROTECTION,     TCU,           ECU_MUX_NONE, 16, 4,  false, 10, 1, 0,    "")    \
+    X(TCU_LAUNCH,         TCU,           ECU_MUX_NONE, 20, 1,  false, 10, 1, 0,    "")    \
+    X(TCU_LIMP,           TCU,           ECU_MUX_NONE, 21, 1,  false, 10, 1, 0,    "")    \
+    X(TCU_DIAGNOSTIC,     TCU,           ECU_MUX_NONE, 22, 1,  false, 10, 1, 0,    "")    \
+    X(TCU_SYSTEM_ERROR,   TCU,           ECU_MUX_NONE, 23, 1,  false, 10, 1, 0,    "")    \
+    X(GEAR,               TCU,           ECU_MUX_NONE, 24, 8,  false, 10, 1, 0,    "")    \
+    X(CLUTCH_PRESSURE,    TCU,           ECU_MUX_NONE, 32, 16, false, 1,  1, 0,    "bar") \
+    X(TCU_TEMP,           TCU,           ECU_MUX_NONE, 48, 8,  false, 10, 1, -400, "C")   \
+    X(SHIFT_STRATEGY,     TCU,           ECU_MUX_NONE, 56, 8,  false, 10, 1, 0,    "")
+
+// Example frames of the document (classic): X(message, b0, b1, b2, b3, b4, b5, b6, b7)
+#define ECU_CAN_SPEC_EXAMPLES(X) \
+    X(BOOST_CONTROL, 0x2D, 0x7D, 0x00, 0x6E, 0x00, 0xFB, 0x2C, 0x01) \
+    X(ENGINE,        0x10, 0x0E, 0xFA, 0x00, 0x54, 0x6E, 0x90, 0x01) \
+    X(ENGINE_TEMPS,  0x01, 0x2C, 0x03, 0x36, 0x03, 0x40, 0x03, 0x00) \
+    X(TCU,           0xF4, 0x01, 0x20, 0x03, 0x64, 0x00, 0x5A, 0x02)
+
+// Documented values of the example frames, in 0.1 units: X(signal, tenths)
+#define ECU_CAN_SPEC_EXPECTED(X) \
+    X(WASTEGATE_POSITION, 450)   \
+    X(TARGET_BOOST,       125)   \
+    X(ACTUAL_BOOST,       110)   \
+    X(BOOST_ERROR,        -50)   \
+    X(WASTEGATE_DUTY,     300)   \
+    X(ENGINE_RPM,         36000) \
+    X(MAP_PRESSURE,       250)   \
+    X(TPS_POSITION,       840)   \
+    X(ENGINE_TEMP,        700)   \
+    X(FUEL_PRESSURE,      400)   \
+    X(TEMP_PAGE,          10)    \
+    X(EGT_CYL1,           8120)  \
+    X(EGT_CYL2,           8220)  \
+    X(EGT_CYL3,           8320)  \
+    X(TORQUE_REQUEST,     5000)  \
+    X(TCU_PROTECTION,     0)     \
+    X(TCU_LIMP,           10)    \
+    X(GEAR,               30)    \
+    X(CLUTCH_PRESSURE,    100)   \
+    X(TCU_TEMP,           500)   \
+    X(SHIFT_STRATEGY,     20)
+
+#define ECU_CAN_SPEC_MAX_DLC    ECU_CAN_FD_MAX_LEN
+#define ECU_MUX_NONE            (-1)
+#define ECU_SIG_NONE            (-1)    // mux_selector of plain messages
+
+// ECU_CAN_ID_<message>, ECU_CAN_DLC_<message>, ECU_CAN_HZ_<message>
+#define ECU_CAN_SPEC_MSG_CONSTANTS(name, id, dlc, hz, sel) \
+    ECU_CAN_ID_##name = id, ECU_CAN_DLC_##name = dlc, ECU_CAN_HZ_##name = hz,
+enum { ECU_CAN_SPEC_MESSAGES(ECU_CAN_SPEC_MSG_CONSTANTS) };
+#undef ECU_CAN_SPEC_MSG_CONSTANTS
+
+#define ECU_CAN_SPEC_MSG_ENUM(name, id, dlc, hz, sel) ECU_MSG_##name,
+typedef enum {
+    ECU_CAN_SPEC_MESSAGES(ECU_CAN_SPEC_MSG_ENUM)
+    ECU_MSG_COUNT
+} ecu_can_msg_id_t;
+#undef ECU_CAN_SPEC_MSG_ENUM
+
+#define ECU_CAN_SPEC_SIG_ENUM(name, msg, mux, start, bits, sgn, mul, div, off, unit) ECU_SIG_##name,
+typedef enum {
+    ECU_CAN_SPEC_SIGNALS(ECU_CAN_SPEC_SIG_ENUM)
+    ECU_SIG_COUNT
+} ecu_can_sig_id_t;
+#undef ECU_CAN_SPEC_SIG_ENUM
+
+typedef struct {
+    const char* name;
+    uint32_t can_id;
+    uint8_t dlc;
+    uint16_t rate_hz;
+    int8_t mux_selector;         // ecu_can_sig_id_t of the selector, ECU_SIG_NONE if not multiplexed
+} ecu_can_msg_spec_t;
+
+typedef struct {
+    const char* name;
+    const char* unit;
+    ecu_can_msg_id_t msg;
+    int16_t mux;                 // Selector value, ECU_MUX_NONE if always present
+    uint16_t start_bit;
+    uint8_t bits;
+    bool is_signed;
+    int16_t mul;
+    int16_t div;
+    int16_t offset;              // 0.1 units
+} ecu_can_sig_spec_t;
+
+extern const ecu_can_msg_spec_t ecu_can_msgs[ECU_MSG_COUNT];
+extern const ecu_can_sig_spec_t ecu_can_sigs[ECU_SIG_COUNT];
+
+/**
+ * Extract a signal in raw units (sign-extended if signed). No bounds
+ * check: the tables are checked at compile time, the caller checks the
+ * frame length once against the message DLC.
+ * @param sig Signal
+ * @param data Frame payload, at least the DLC of the signal's message
+ * @return Raw value
+ */
+int32_t ecu_can_sig_get(ecu_can_sig_id_t sig, const uint8_t* data);
+
+/**
+ * Extract a signal in 0.1 physical units
+ * @param sig Signal
+ * @param data Frame payload
+ * @return Value in tenths
+ */
+int32_t ecu_can_sig_get_tenths(ecu_can_sig_id_t sig, const uint8_t* data);
+
+/**
+ * Insert a raw value, clamped to the signal's range; other bits are kept
+ * @param sig Signal
+ * @param data Frame payload
+ * @param raw Raw value
+ */
+void ecu_can_sig_set(ecu_can_sig_id_t sig, uint8_t* data, int32_t raw);
+
+/**
+ * Insert a value given in 0.1 physical units (rounded to the resolution)
+ * @param sig Signal
+ * @param data Frame payload
+ * @param tenths Value in tenths
+ */
+void ecu_can_sig_set_tenths(ecu_can_sig_id_t sig, uint8_t* data, int32_t tenths);
+
+/**
+ * Check whether a frame carries a signal: always true for plain signals,
+ * for multiplexed ones only if the selector matches
+ * @param sig Signal
+ * @param data Frame payload
+ * @return true if the signal is valid in this frame
+ */
+bool ecu_can_sig_present(ecu_can_sig_id_t sig, const uint8_t* data);
+
+/**
+ * Find a message by CAN ID
+ * @param can_id CAN ID
+ * @return Message spec, NULL if the ID is not in the specification
+ */
+const ecu_can_msg_spec_t* ecu_can_spec_find(uint32_t can_id);
+
+/**
+ * Check the tables against themselves and the document: no two signals
+ * that can appear together overlap, multiplexed signals belong to a
+ * message with a selector, every example frame decodes to its documented
+ * values and re-encodes to the same bytes (frame bounds are checked at
+ * compile time)
+ * @param report Optional, receives one line per failure
+ * @param len Report buffer size
+ * @return Number of failures, 0 if the tables conform
+ */
+int ecu_can_spec_check(char* report, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_CAN_SPEC_H
@@ -0,0 +1,475 @@
+/**
+ * CAN controller supervisor for the ECU Dashboard
+ * The state machine only sees alert bits and timestamps, so it runs the
+ * same against the TWAI driver and against a simulated bus. The supervisor
+ * task is the only writer; readers copy the status under a sequence counter.
+ */
+
+#include "ecu_can_supervisor.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#else
+#include <time.h>
+#endif
+
+static ecu_can_sup_status_t status;
+static volatile uint32_t status_seq = 0;
+static volatile bool restart_requested = false;
+
+static ecu_can_action_t pending_action = ECU_CAN_ACTION_NONE;
+static ecu_can_action_t last_action = ECU_CAN_ACTION_NONE;
+static uint32_t action_due_ms = 0;
+static uint32_t recovery_deadline_ms = 0;
+static uint32_t down_since_ms = 0;
+static uint32_t up_since_ms = 0;
+static bool down = false;                   // Off the bus since down_since_ms
+static bool ever_started = false;
+
+static const char *const state_names[ECU_CAN_SUP_STATE_COUNT] = {
+    [ECU_CAN_SUP_STOPPED]    = "stopped",
+    [ECU_CAN_SUP_RUNNING]    = "running",
+    [ECU_CAN_SUP_WARNING]    = "warning",
+    [ECU_CAN_SUP_PASSIVE]    = "passive",
+    [ECU_CAN_SUP_BUS_OFF]    = "bus-off",
+    [ECU_CAN_SUP_RECOVERING] = "recovering",
+    [ECU_CAN_SUP_RESTARTING] = "restarting",
+};
+
+// Bracket every status change so readers never see a torn copy
+static void status_begin(void)
+{
+    status_seq++;
+    __sync_synchronize();
+}
+
+static void status_end(void)
+{
+    __sync_synchronize();
+    status_seq++;
+}
+
+static bool time_reached(uint32_t now_ms, uint32_t at_ms)
+{
+    return (int32_t)(now_ms - at_ms) >= 0;
+}
+
+static bool on_bus(ecu_can_sup_state_t state)
+{
+    return state == ECU_CAN_SUP_RUNNING || state == ECU_CAN_SUP_WARNING || state == ECU_CAN_SUP_PASSIVE;
+}
+
+// Schedule an action after the next backoff step
+static void schedule_backoff(ecu_can_action_t action, uint32_t now_ms)
+{
+    uint32_t backoff = ECU_CAN_SUP_BACKOFF_MIN_MS;
+    for (uint16_t i = 0; i < status.attempt && backoff < ECU_CAN_SUP_BACKOFF_MAX_MS; i++) {
+        backoff <<= 1;
+    }
+    if (backoff > ECU_CAN_SUP_BACKOFF_MAX_MS) backoff = ECU_CAN_SUP_BACKOFF_MAX_MS;
+
+    status.attempt++;
+    status.backoff_ms = backoff;
+    pending_action = action;
+    action_due_ms = now_ms + backoff;
+}
+
+static void go_down(ecu_can_sup_state_t state, uint32_t now_ms)
+{
+    if (!down) {
+        down = true;
+        down_since_ms = now_ms;
+        // A bus that stayed up long enough starts over at the shortest backoff
+        if (ever_started && now_ms - up_since_ms >= ECU_CAN_SUP_STABLE_MS) {
+            status.attempt = 0;
+        }
+    }
+    status.state = state;
+}
+
+void ecu_can_supervisor_init(void)
+{
+    status_begin();
+    memset(&status, 0, sizeof(status));
+    status.state = ECU_CAN_SUP_STOPPED;
+    status_end();
+
+    restart_requested = false;
+    pending_action = ECU_CAN_ACTION_NONE;
+    last_action = ECU_CAN_ACTION_NONE;
+    down = false;
+    ever_started = false;
+}
+
+void ecu_can_supervisor_on_alerts(uint32_t alerts, uint8_t tec, uint8_t rec, uint32_t now_ms)
+{
+    status_begin();
+
+    status.tx_error_counter = tec;
+    status.rx_error_counter = rec;
+    if (alerts & ECU_CAN_ALERT_BUS_ERROR) status.bus_errors++;
+    if (alerts & ECU_CAN_ALERT_RX_OVERRUN) status.rx_overruns++;
+
+    if (alerts & ECU_CAN_ALERT_BUS_OFF) {
+        if (on_bus(status.state)) {
+            status.bus_off_count++;
+            go_down(ECU_CAN_SUP_BUS_OFF, now_ms);
+            schedule_backoff(ECU_CAN_ACTION_INITIATE_RECOVERY, now_ms);
+        }
+    } else if (alerts & ECU_CAN_ALERT_RECOVERED) {
+        if (status.state == ECU_CAN_SUP_RECOVERING || status.state == ECU_CAN_SUP_BUS_OFF) {
+            // Controller is back in the stopped state, restart it right away
+            status.state = ECU_CAN_SUP_RESTARTING;
+            pending_action = ECU_CAN_ACTION_START;
+            action_due_ms = now_ms;
+        }
+    } else if (on_bus(status.state)) {
+        if (alerts & ECU_CAN_ALERT_ERR_PASSIVE) {
+            if (status.state != ECU_CAN_SUP_PASSIVE) status.passive_count++;
+            status.state = ECU_CAN_SUP_PASSIVE;
+        } else if (alerts & ECU_CAN_ALERT_ERR_ACTIVE) {
+            status.state = (tec > 96 || rec > 96) ? ECU_CAN_SUP_WARNING : ECU_CAN_SUP_RUNNING;
+        } else if ((alerts & ECU_CAN_ALERT_ERR_WARN) && status.state == ECU_CAN_SUP_RUNNING) {
+            status.state = ECU_CAN_SUP_WARNING;
+        } else if ((alerts & ECU_CAN_ALERT_BELOW_WARN) && status.state == ECU_CAN_SUP_WARNING) {
+            status.state = ECU_CAN_SUP_RUNNING;
+        }
+    }
+
+    status_end();
+}
+
+ecu_can_action_t ecu_can_supervisor_poll(uint32_t now_ms)
+{
+    ecu_can_action_t action = ECU_CAN_ACTION_NONE;
+
+    status_begin();
+
+    if (restart_requested) {
+        restart_requested = false;
+        go_down(ECU_CAN_SUP_RESTARTING, now_ms);
+        pending_action = ECU_CAN_ACTION_RESTART;
+        action_due_ms = now_ms;
+    }
+
+    if (pending_action != ECU_CAN_ACTION_NONE && time_reached(now_ms, action_due_ms)) {
+        action = pending_action;
+        pending_action = ECU_CAN_ACTION_NONE;
+        if (action == ECU_CAN_ACTION_INITIATE_RECOVERY) {
+            status.state = ECU_CAN_SUP_RECOVERING;
+            recovery_deadline_ms = now_ms + ECU_CAN_SUP_RECOVERY_TIMEOUT_MS;
+        } else {
+            status.state = ECU_CAN_SUP_RESTARTING;
+        }
+    } else if (status.state == ECU_CAN_SUP_RECOVERING && time_reached(now_ms, recovery_deadline_ms)) {
+        // Bus held dominant or the recovery got lost: reinstall instead of waiting forever
+        action = ECU_CAN_ACTION_RESTART;
+        status.state = ECU_CAN_SUP_RESTARTING;
+    }
+
+    if (action != ECU_CAN_ACTION_NONE) last_action = action;
+    status_end();
+    return action;
+}
+
+uint32_t ecu_can_supervisor_next_wait_ms(uint32_t now_ms)
+{
+    uint32_t wait = ECU_CAN_SUP_POLL_MS;
+    uint32_t at;
+
+    if (restart_requested) return 0;
+    if (pending_action != ECU_CAN_ACTION_NONE) {
+        at = action_due_ms;
+    } else if (status.state == ECU_CAN_SUP_RECOVERING) {
+        at = recovery_deadline_ms;
+    } else {
+        return wait;
+    }
+
+    if (time_reached(now_ms, at)) return 0;
+    return (at - now_ms) < wait ? at - now_ms : wait;
+}
+
+void ecu_can_supervisor_started(uint32_t now_ms)
+{
+    status_begin();
+
+    if (last_action == ECU_CAN_ACTION_RESTART) status.restarts++;
+    if (down) {
+        uint32_t took = now_ms - down_since_ms;
+        status.recoveries++;
+        status.last_recover_ms = took;
+        if (took > status.max_recover_ms) status.max_recover_ms = took;
+        down = false;
+    }
+    status.state = ECU_CAN_SUP_RUNNING;
+    status.tx_error_counter = 0;
+    status.rx_error_counter = 0;
+    up_since_ms = now_ms;
+    ever_started = true;
+    last_action = ECU_CAN_ACTION_NONE;
+
+    status_end();
+}
+
+void ecu_can_supervisor_action_failed(uint32_t now_ms)
+{
+    status_begin();
+
+    status.failed_actions++;
+    go_down(ECU_CAN_SUP_RESTARTING, now_ms);
+    if (last_action == ECU_CAN_ACTION_RESTART) {
+        schedule_backoff(ECU_CAN_ACTION_RESTART, now_ms);
+    } else {
+        // Controller not in the state the driver expected: start over from scratch
+        pending_action = ECU_CAN_ACTION_RESTART;
+        action_due_ms = now_ms;
+    }
+    last_action = ECU_CAN_ACTION_NONE;
+
+    status_end();
+}
+
+void ecu_can_supervisor_request_restart(void)
+{
+    restart_requested = true;
+}
+
+bool ecu_can_supervisor_bus_usable(void)
+{
+    return on_bus(status.state);
+}
+
+void ecu_can_supervisor_get(ecu_can_sup_status_t* out, uint32_t now_ms)
+{
+    uint32_t seq;
+    uint32_t since;
+    uint32_t due;
+    bool was_down;
+    bool scheduled;
+
+    do {
+        seq = status_seq;
+        __sync_synchronize();
+        *out = status;
+        since = down_since_ms;
+        was_down = down;
+        due = action_due_ms;
+        scheduled = pending_action != ECU_CAN_ACTION_NONE;
+        __sync_synchronize();
+    } while ((seq & 1u) || seq != status_seq);
+
+    out->down_ms = was_down ? now_ms - since : 0;
+    out->retry_in_ms = (scheduled && !time_reached(now_ms, due)) ? due - now_ms : 0;
+}
+
+const char* ecu_can_supervisor_state_name(ecu_can_sup_state_t state)
+{
+    return state < ECU_CAN_SUP_STATE_COUNT ? state_names[state] : "?";
+}
+
+size_t ecu_can_supervisor_format_text(const ecu_can_sup_status_t* s, char* buf, size_t len)
+{
+    if (len == 0) return 0;
+
+    int n = snprintf(buf, len,
+                     "CAN %s  TEC %u REC %u  bus-off %lu passive %lu  recovered %lu (last %lu ms, max %lu ms)"
+                     "  restarts %lu  bus errors %lu  overruns %lu",
+                     ecu_can_supervisor_state_name(s->state), s->tx_error_counter, s->rx_error_counter,
+                     (unsigned long)s->bus_off_count, (unsigned long)s->passive_count,
+                     (unsigned long)s->recoveries, (unsigned long)s->last_recover_ms,
+                     (unsigned long)s->max_recover_ms, (unsigned long)s->restarts,
+                     (unsigned long)s->bus_errors, (unsigned long)s->rx_overruns);
+    if (n < 0) {
+        buf[0] = '\0';
+        return 0;
+    }
+    return (size_t)n < len ? (size_t)n : len - 1;
+}
+
+uint32_t ecu_can_supervisor_now_ms(void)
+{
+#if defined(ESP_PLATFORM)
+    return (uint32_t)(esp_timer_get_time() / 1000);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000u + ts.tv_nsec / 1000000);
+#endif
+}
+
+#if defined(ESP_PLATFORM)
+
+#define SUP_TASK_STACK      3072
+#define SUP_TASK_PRIORITY   (configMAX_PRIORITIES - 2)   // Above the UI, recovery is time critical
+
+#define SUP_TWAI_ALERTS     (TWAI_ALERT_ERR_ACTIVE | TWAI_ALERT_ABOVE_ERR_WARN | TWAI_ALERT_BELOW_ERR_WARN | \
+                             TWAI_ALERT_ERR_PASS | TWAI_ALERT_BUS_OFF | TWAI_ALERT_BUS_RECOVERED | \
+                             TWAI_ALERT_BUS_ERROR | TWAI_ALERT_RX_QUEUE_FULL)
+
+static twai_general_config_t sup_g_config;
+static twai_timing_config_t sup_t_config;
+static twai_filter_config_t sup_f_config;
+static void (*sup_alert_cb)(uint32_t alerts);
+static SemaphoreHandle_t driver_mutex;
+static volatile bool sim_bus_off = false;
+static bool sim_recovering = false;
+static uint32_t sim_recovered_ms = 0;
+
+static uint32_t map_alerts(uint32_t twai_alerts)
+{
+    uint32_t alerts = 0;
+    if (twai_alerts & TWAI_ALERT_ERR_ACTIVE) alerts |= ECU_CAN_ALERT_ERR_ACTIVE;
+    if (twai_alerts & TWAI_ALERT_ABOVE_ERR_WARN) alerts |= ECU_CAN_ALERT_ERR_WARN;
+    if (twai_alerts & TWAI_ALERT_BELOW_ERR_WARN) alerts |= ECU_CAN_ALERT_BELOW_WARN;
+    if (twai_alerts & TWAI_ALERT_ERR_PASS) alerts |= ECU_CAN_ALERT_ERR_PASSIVE;
+    if (twai_alerts & TWAI_ALERT_BUS_OFF) alerts |= ECU_CAN_ALERT_BUS_OFF;
+    if (twai_alerts & TWAI_ALERT_BUS_RECOVERED) alerts |= ECU_CAN_ALERT_RECOVERED;
+    if (twai_alerts & TWAI_ALERT_BUS_ERROR) alerts |= ECU_CAN_ALERT_BUS_ERROR;
+    if (twai_alerts & TWAI_ALERT_RX_QUEUE_FULL) alerts |= ECU_CAN_ALERT_RX_OVERRUN;
+    return alerts;
+}
+
+// 128 occurrences of 11 recessive bits at the configured bitrate (APB clock 80 MHz)
+static uint32_t sim_recovery_ms(void)
+{
+    uint32_t bit_tq = 1u + sup_t_config.tseg_1 + sup_t_config.tseg_2;
+    uint64_t ticks = 128ull * 11u * sup_t_config.brp * bit_tq;
+    return (uint32_t)(ticks / 80000u) + 1u;
+}
+
+static esp_err_t driver_restart(void)
+{
+    esp_err_t err;
+
+    xSemaphoreTake(driver_mutex, portMAX_DELAY);
+    twai_stop();                                // Fails harmlessly when already stopped
+    twai_driver_uninstall();
+    err = twai_driver_install(&sup_g_config, &sup_t_config, &sup_f_config);
+    if (err == ESP_OK) err = twai_start();
+    xSemaphoreGive(driver_mutex);
+    return err;
+}
+
+static esp_err_t run_action(ecu_can_action_t action)
+{
+    switch (action) {
+        case ECU_CAN_ACTION_INITIATE_RECOVERY:
+            if (sim_recovering) {
+                sim_recovered_ms = ecu_can_supervisor_now_ms() + sim_recovery_ms();
+                return ESP_OK;
+            }
+            return twai_initiate_recovery();
+        case ECU_CAN_ACTION_START:
+            return twai_start();
+        case ECU_CAN_ACTION_RESTART:
+            sim_recovering = false;
+            return driver_restart();
+        default:
+            return ESP_OK;
+    }
+}
+
+static void supervisor_task(void* arg)
+{
+    (void)arg;
+
+    for (;;) {
+        uint32_t twai_alerts = 0;
+        uint32_t alerts = 0;
+        uint32_t wait = ecu_can_supervisor_next_wait_ms(ecu_can_supervisor_now_ms());
+
+        if (sim_recovering && sim_recovered_ms && wait > 1) wait = 1;
+        esp_err_t err = twai_read_alerts(&twai_alerts, pdMS_TO_TICKS(wait));
+        if (err == ESP_OK) {
+            alerts = map_alerts(twai_alerts);
+        } else if (err != ESP_ERR_TIMEOUT && wait) {
+            vTaskDelay(pdMS_TO_TICKS(wait));    // Driver not installed, don't spin
+        }
+
+        if (sim_bus_off) {
+            sim_bus_off = false;
+            sim_recovering = true;
+            sim_recovered_ms = 0;
+            twai_stop();
+            alerts |= ECU_CAN_ALERT_BUS_OFF;
+        } else if (sim_recovering && sim_recovered_ms && (int32_t)(ecu_can_supervisor_now_ms() - sim_recovered_ms) >= 0) {
+            sim_recovering = false;
+            sim_recovered_ms = 0;
+            alerts |= ECU_CAN_ALERT_RECOVERED;
+        }
+
+        twai_status_info_t info;
+        uint8_t tec = 0;
+        uint8_t rec = 0;
+        if (twai_get_status_info(&info) == ESP_OK) {
+            tec = info.tx_error_counter > 255 ? 255 : (uint8_t)info.tx_error_counter;
+            rec = info.rx_error_counter > 255 ? 255 : (uint8_t)info.rx_error_counter;
+        }
+        if (alerts) {
+            ecu_can_supervisor_on_alerts(alerts, tec, rec, ecu_can_supervisor_now_ms());
+            if (sup_alert_cb) sup_alert_cb(alerts);
+        }
+
+        ecu_can_action_t action = ecu_can_supervisor_poll(ecu_can_supervisor_now_ms());
+        if (action == ECU_CAN_ACTION_NONE) continue;
+
+        if (run_action(action) != ESP_OK) {
+            ecu_can_supervisor_action_failed(ecu_can_supervisor_now_ms());
+        } else if (action != ECU_CAN_ACTION_INITIATE_RECOVERY) {
+            ecu_can_supervisor_started(ecu_can_supervisor_now_ms());
+        }
+    }
+}
+
+esp_err_t ecu_can_supervisor_start(const twai_general_config_t* g_config,
+                                   const twai_timing_config_t* t_config,
+                                   const twai_filter_config_t* f_config,
+                                   void (*alert_cb)(uint32_t alerts))
+{
+    sup_g_config = *g_config;
+    sup_g_config.alerts_enabled |= SUP_TWAI_ALERTS;
+    sup_t_config = *t_config;
+    sup_f_config = *f_config;
+    sup_alert_cb = alert_cb;
+
+    ecu_can_supervisor_init();
+    if (driver_mutex == NULL) {
+        driver_mutex = xSemaphoreCreateMutex();
+        if (driver_mutex == NULL) return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = twai_driver_install(&sup_g_config, &sup_t_config, &sup_f_config);
+    if (err != ESP_OK) return err;
+    err = twai_start();
+    if (err != ESP_OK) return err;
+    ecu_can_supervisor_started(ecu_can_supervisor_now_ms());
+
+    if (xTaskCreate(supervisor_task, "can_sup", SUP_TASK_STACK, NULL, SUP_TASK_PRIORITY, NULL) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+bool ecu_can_supervisor_driver_lock(uint32_t timeout_ms)
+{
+    if (driver_mutex == NULL || !ecu_can_supervisor_bus_usable()) return false;
+    return xSemaphoreTake(driver_mutex, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+void ecu_can_supervisor_driver_unlock(void)
+{
+    xSemaphoreGive(driver_mutex);
+}
+
+void ecu_can_supervisor_simulate_bus_off(void)
+{
+    sim_bus_off = true;
+}
+
+#endif // ESP_PLATFORM
@@ -0,0 +1,193 @@
+/**
+ * CAN controller supervisor for the ECU Dashboard
+ * Watches the controller alerts, recovers from bus-off with exponential
+ * backoff, falls back to a driver reinstall when recovery stalls and
+ * measures how long the bus was down
+ */
+
+#ifndef ECU_CAN_SUPERVISOR_H
+#define ECU_CAN_SUPERVISOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(ESP_PLATFORM)
+#include "driver/twai.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECU_CAN_SUP_BACKOFF_MIN_MS      50u        // First retry after a bus-off
+#define ECU_CAN_SUP_BACKOFF_MAX_MS      5000u      // Backoff cap
+#define ECU_CAN_SUP_STABLE_MS           10000u     // Running this long resets the backoff
+#define ECU_CAN_SUP_RECOVERY_TIMEOUT_MS 1000u      // Recovery not done by then: reinstall
+#define ECU_CAN_SUP_POLL_MS             100u       // Alert wait when nothing is scheduled
+
+// Driver-independent alert bits (the ESP32 task maps TWAI_ALERT_* onto these)
+#define ECU_CAN_ALERT_ERR_ACTIVE        (1u << 0)  // Back to error active
+#define ECU_CAN_ALERT_ERR_WARN          (1u << 1)  // An error counter exceeded 96
+#define ECU_CAN_ALERT_BELOW_WARN        (1u << 2)  // Both error counters below 96 again
+#define ECU_CAN_ALERT_ERR_PASSIVE       (1u << 3)  // An error counter reached 128
+#define ECU_CAN_ALERT_BUS_OFF           (1u << 4)  // TEC exceeded 255, controller off the bus
+#define ECU_CAN_ALERT_RECOVERED         (1u << 5)  // Bus-off recovery finished, driver stopped
+#define ECU_CAN_ALERT_BUS_ERROR         (1u << 6)  // Bit, stuff, CRC, form or ACK error
+#define ECU_CAN_ALERT_RX_OVERRUN        (1u << 7)  // RX queue full or hardware FIFO overrun
+
+typedef enum {
+    ECU_CAN_SUP_STOPPED = 0,    // Driver not started yet
+    ECU_CAN_SUP_RUNNING,        // Error active
+    ECU_CAN_SUP_WARNING,        // Error counter above the warning limit
+    ECU_CAN_SUP_PASSIVE,        // Error passive, still receiving
+    ECU_CAN_SUP_BUS_OFF,        // Off the bus, waiting for the backoff to expire
+    ECU_CAN_SUP_RECOVERING,     // Recovery initiated, waiting for 128 x 11 recessive bits
+    ECU_CAN_SUP_RESTARTING,     // Driver reinstall due or in progress
+    ECU_CAN_SUP_STATE_COUNT
+} ecu_can_sup_state_t;
+
+// What the driver glue has to do next
+typedef enum {
+    ECU_CAN_ACTION_NONE = 0,
+    ECU_CAN_ACTION_INITIATE_RECOVERY,  // twai_initiate_recovery()
+    ECU_CAN_ACTION_START,              // twai_start() after a completed recovery
+    ECU_CAN_ACTION_RESTART,            // Stop, uninstall, install and start the driver
+} ecu_can_action_t;
+
+typedef struct {
+    ecu_can_sup_state_t state;
+    uint8_t tx_error_counter;
+    uint8_t rx_error_counter;
+    uint16_t attempt;            // Bus-offs since the bus was last stable
+    uint32_t backoff_ms;         // Backoff of the current / last bus-off
+    uint32_t retry_in_ms;        // Until the next scheduled action, 0 if none
+    uint32_t down_ms;            // Time off the bus so far, 0 while on it
+    uint32_t bus_off_count;
+    uint32_t passive_count;
+    uint32_t bus_errors;
+    uint32_t rx_overruns;
+    uint32_t recoveries;         // Back on the bus after a bus-off or restart
+    uint32_t restarts;           // Driver reinstalls
+    uint32_t failed_actions;     // Driver calls that returned an error
+    uint32_t last_recover_ms;    // Bus-off to running, last recovery
+    uint32_t max_recover_ms;     // Bus-off to running, worst recovery
+} ecu_can_sup_status_t;
+
+/**
+ * Reset the state machine and its counters
+ */
+void ecu_can_supervisor_init(void);
+
+/**
+ * Feed controller alerts. Single writer: the alert/poll/started/failed
+ * calls must all come from the supervisor task.
+ * @param alerts ECU_CAN_ALERT_* bits
+ * @param tec Transmit error counter
+ * @param rec Receive error counter
+ * @param now_ms Millisecond timestamp
+ */
+void ecu_can_supervisor_on_alerts(uint32_t alerts, uint8_t tec, uint8_t rec, uint32_t now_ms);
+
+/**
+ * Take the next driver action once it is due
+ * @param now_ms Millisecond timestamp
+ * @return Action to perform, report the result with started() or action_failed()
+ */
+ecu_can_action_t ecu_can_supervisor_poll(uint32_t now_ms);
+
+/**
+ * Milliseconds until poll() has something to do
+ * @param now_ms Millisecond timestamp
+ * @return Wait time, ECU_CAN_SUP_POLL_MS if nothing is scheduled
+ */
+uint32_t ecu_can_supervisor_next_wait_ms(uint32_t now_ms);
+
+/**
+ * The driver is running (initial start, START or RESTART succeeded)
+ * @param now_ms Millisecond timestamp
+ */
+void ecu_can_supervisor_started(uint32_t now_ms);
+
+/**
+ * The last action failed. A failed recovery or start escalates to a
+ * restart; a failed restart is retried after the next backoff step.
+ * @param now_ms Millisecond timestamp
+ */
+void ecu_can_supervisor_action_failed(uint32_t now_ms);
+
+/**
+ * Ask for a driver reinstall (e.g. from the application error handler).
+ * Safe from any task; served by the next poll().
+ */
+void ecu_can_supervisor_request_restart(void);
+
+/**
+ * @return true while frames can be received (running, warning or passive)
+ */
+bool ecu_can_supervisor_bus_usable(void);
+
+/**
+ * Read a consistent status snapshot
+ * @param out Status
+ * @param now_ms Millisecond timestamp
+ */
+void ecu_can_supervisor_get(ecu_can_sup_status_t* out, uint32_t now_ms);
+
+/**
+ * @param state Supervisor state
+ * @return Short state name
+ */
+const char* ecu_can_supervisor_state_name(ecu_can_sup_state_t state);
+
+/**
+ * Format the status as one text line (serial / diagnostics screen)
+ * @param status Status snapshot
+ * @param buf Output buffer
+ * @param len Buffer size
+ * @return Characters written, excluding the terminator
+ */
+size_t ecu_can_supervisor_format_text(const ecu_can_sup_status_t* status, char* buf, size_t len);
+
+/**
+ * @return Millisecond timestamp used by the supervisor task
+ */
+uint32_t ecu_can_supervisor_now_ms(void);
+
+#if defined(ESP_PLATFORM)
+/**
+ * Install and start the TWAI driver and the supervisor task. The configs
+ * are kept for reinstalls; the alerts the supervisor needs are enabled.
+ * @param g_config General configuration
+ * @param t_config Timing configuration
+ * @param f_config Acceptance filter
+ * @param alert_cb Optional, called from the supervisor task with ECU_CAN_ALERT_* bits
+ * @return ESP_OK, or the error of the failing driver call
+ */
+esp_err_t ecu_can_supervisor_start(const twai_general_config_t* g_config,
+                                   const twai_timing_config_t* t_config,
+                                   const twai_filter_config_t* f_config,
+                                   void (*alert_cb)(uint32_t alerts));
+
+/**
+ * Hold off driver reinstalls while the RX path uses the driver
+ * @param timeout_ms Wait for a reinstall in progress
+ * @return false if the driver is being reinstalled or the bus is down
+ */
+bool ecu_can_supervisor_driver_lock(uint32_t timeout_ms);
+
+void ecu_can_supervisor_driver_unlock(void);
+
+/**
+ * Simulate a bus-off (bench test of the recovery path): the driver is
+ * stopped, the supervisor sees BUS_OFF, and the recovery completes after
+ * 128 x 11 bit times as on a real bus
+ */
+void ecu_can_supervisor_simulate_bus_off(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_CAN_SUPERVISOR_H
@@ -0,0 +1,305 @@
+/**
+ * CAN transmit queue for the ECU Dashboard
+ * A handful of slots scanned under a short critical section: the frame is
+ * copied out before the bus is touched, so a submit never waits for a
+ * transmission. A slot is removed after a successful send only if nobody
+ * rewrote it meanwhile; a setpoint coalesced during the send goes out next.
+ */
+
+#include "ecu_can_tx.h"
+#include "ecu_can_supervisor.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static portMUX_TYPE tx_mux = portMUX_INITIALIZER_UNLOCKED;
+#define TX_LOCK()       portENTER_CRITICAL(&tx_mux)
+#define TX_UNLOCK()     portEXIT_CRITICAL(&tx_mux)
+#else
+static volatile int tx_spin = 0;
+#define TX_LOCK()       while (__sync_lock_test_and_set(&tx_spin, 1)) {}
+#define TX_UNLOCK()     __sync_lock_release(&tx_spin)
+#endif
+
+typedef struct {
+    ecu_can_frame_t frame;
+    bool used;
+    uint8_t cls;
+    uint32_t order;              // Submit order, FIFO within a class
+    uint32_t stamp;              // New on every write, checked before removal
+    uint32_t queued_ms;
+} tx_slot_t;
+
+static tx_slot_t slots[ECU_CAN_TX_DEPTH];
+static ecu_can_tx_stats_t stats;
+static uint32_t next_order = 0;
+static uint32_t next_stamp = 0;
+static uint32_t last_setpoint_ms = 0;
+static bool setpoint_sent = false;           // last_setpoint_ms is valid
+static uint32_t retry_at_ms = 0;
+static bool holding_off = false;             // Last send failed, wait until retry_at_ms
+
+#if defined(ESP_PLATFORM)
+static TaskHandle_t tx_task = NULL;
+#endif
+
+static bool before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+static bool setpoint_due(uint32_t now_ms)
+{
+    return !setpoint_sent || now_ms - last_setpoint_ms >= ECU_CAN_TX_SETPOINT_MIN_MS;
+}
+
+static void release(tx_slot_t* slot)
+{
+    slot->used = false;
+    stats.pending--;
+}
+
+// Highest class first, oldest first within a class; setpoints only when due
+static tx_slot_t* next_due(uint32_t now_ms)
+{
+    tx_slot_t* best = NULL;
+    bool setpoints = setpoint_due(now_ms);
+
+    for (int i = 0; i < ECU_CAN_TX_DEPTH; i++) {
+        tx_slot_t* s = &slots[i];
+        if (!s->used || (s->cls == ECU_CAN_TX_SETPOINT && !setpoints)) continue;
+        if (best == NULL || s->cls < best->cls || (s->cls == best->cls && before(s->order, best->order))) {
+            best = s;
+        }
+    }
+    return best;
+}
+
+// Slot for a new frame of class cls: a free one, else the newest frame of the lowest class below cls
+static tx_slot_t* claim_slot(ecu_can_tx_class_t cls)
+{
+    tx_slot_t* victim = NULL;
+
+    for (int i = 0; i < ECU_CAN_TX_DEPTH; i++) {
+        if (!slots[i].used) return &slots[i];
+    }
+    for (int i = 0; i < ECU_CAN_TX_DEPTH; i++) {
+        tx_slot_t* s = &slots[i];
+        if (s->cls <= cls) continue;
+        if (victim == NULL || s->cls > victim->cls || (s->cls == victim->cls && before(victim->order, s->order))) {
+            victim = s;
+        }
+    }
+    if (victim) {
+        release(victim);
+        stats.evicted++;
+    }
+    return victim;
+}
+
+void ecu_can_tx_init(void)
+{
+    TX_LOCK();
+    memset(slots, 0, sizeof(slots));
+    memset(&stats, 0, sizeof(stats));
+    setpoint_sent = false;
+    holding_off = false;
+    TX_UNLOCK();
+}
+
+bool ecu_can_tx_submit(const ecu_can_frame_t* frame, ecu_can_tx_class_t cls)
+{
+    uint32_t now = ecu_can_supervisor_now_ms();
+    tx_slot_t* slot = NULL;
+    bool coalesced = false;
+
+    if (cls >= ECU_CAN_TX_CLASS_COUNT || frame->len > ECU_CAN_FD_MAX_LEN) return false;
+
+    TX_LOCK();
+    for (int i = 0; i < ECU_CAN_TX_DEPTH; i++) {
+        tx_slot_t* s = &slots[i];
+        if (!s->used || s->frame.id != frame->id) continue;
+        if (s->cls > cls) {
+            release(s);
+            stats.superseded++;
+        } else if (s->cls == cls && cls == ECU_CAN_TX_SETPOINT) {
+            slot = s;
+            coalesced = true;
+        }
+    }
+
+    if (slot == NULL) slot = claim_slot(cls);
+    if (slot == NULL) {
+        stats.rejected++;
+        TX_UNLOCK();
+        return false;
+    }
+
+    ecu_can_frame_set(&slot->frame, frame->id, frame->data, frame->len, frame->flags);
+    slot->stamp = next_stamp++;
+    if (coalesced) {
+        // Keeps its place in the queue, only the payload is newer
+        stats.coalesced++;
+    } else {
+        slot->used = true;
+        slot->cls = (uint8_t)cls;
+        slot->order = next_order++;
+        slot->queued_ms = now;
+        stats.queued++;
+        stats.pending++;
+        if (stats.pending > stats.max_pending) stats.max_pending = stats.pending;
+    }
+    TX_UNLOCK();
+
+#if defined(ESP_PLATFORM)
+    if (tx_task) xTaskNotifyGive(tx_task);
+#endif
+    return true;
+}
+
+bool ecu_can_tx_service(const ecu_can_bus_t* bus, uint32_t now_ms)
+{
+    ecu_can_frame_t frame;
+    uint32_t stamp;
+    uint32_t queued_ms;
+    uint8_t cls;
+
+    TX_LOCK();
+    if (holding_off && before(now_ms, retry_at_ms)) {
+        TX_UNLOCK();
+        return false;
+    }
+    holding_off = false;
+    tx_slot_t* slot = next_due(now_ms);
+    if (slot == NULL) {
+        TX_UNLOCK();
+        return false;
+    }
+    ecu_can_frame_set(&frame, slot->frame.id, slot->frame.data, slot->frame.len, slot->frame.flags);
+    stamp = slot->stamp;
+    queued_ms = slot->queued_ms;
+    cls = slot->cls;
+    TX_UNLOCK();
+
+    bool ok = ecu_can_bus_send(bus, &frame, ECU_CAN_TX_SEND_TIMEOUT_MS);
+
+    TX_LOCK();
+    if (ok) {
+        for (int i = 0; i < ECU_CAN_TX_DEPTH; i++) {
+            if (slots[i].used && slots[i].stamp == stamp) {
+                release(&slots[i]);
+                break;
+            }
+        }
+        stats.sent++;
+        if (cls == ECU_CAN_TX_SETPOINT) {
+            last_setpoint_ms = now_ms;
+            setpoint_sent = true;
+        } else if (cls == ECU_CAN_TX_SAFETY) {
+            stats.safety_latency_ms = now_ms - queued_ms;
+            if (stats.safety_latency_ms > stats.safety_latency_max_ms) {
+                stats.safety_latency_max_ms = stats.safety_latency_ms;
+            }
+        }
+    } else {
+        stats.send_failures++;
+        holding_off = true;
+        retry_at_ms = now_ms + ECU_CAN_TX_RETRY_MS;
+    }
+    TX_UNLOCK();
+    return ok;
+}
+
+uint32_t ecu_can_tx_next_wait_ms(uint32_t now_ms)
+{
+    uint32_t wait = ECU_CAN_TX_IDLE_MS;
+
+    TX_LOCK();
+    if (holding_off && stats.pending) {
+        wait = before(now_ms, retry_at_ms) ? retry_at_ms - now_ms : 0;
+    } else {
+        for (int i = 0; i < ECU_CAN_TX_DEPTH && wait; i++) {
+            if (!slots[i].used) continue;
+            if (slots[i].cls != ECU_CAN_TX_SETPOINT || setpoint_due(now_ms)) {
+                wait = 0;
+            } else {
+                uint32_t due = ECU_CAN_TX_SETPOINT_MIN_MS - (now_ms - last_setpoint_ms);
+                if (due < wait) wait = due;
+            }
+        }
+    }
+    TX_UNLOCK();
+    return wait;
+}
+
+void ecu_can_tx_get_stats(ecu_can_tx_stats_t* out)
+{
+    TX_LOCK();
+    *out = stats;
+    TX_UNLOCK();
+}
+
+size_t ecu_can_tx_format_text(const ecu_can_tx_stats_t* s, char* buf, size_t len)
+{
+    if (len == 0) return 0;
+
+    int n = snprintf(buf, len,
+                     "CAN TX sent %lu failed %lu  pending %u (max %u)  coalesced %lu superseded %lu"
+                     "  evicted %lu rejected %lu  safety %lu ms (max %lu ms)",
+                     (unsigned long)s->sent, (unsigned long)s->send_failures, s->pending, s->max_pending,
+                     (unsigned long)s->coalesced, (unsigned long)s->superseded,
+                     (unsigned long)s->evicted, (unsigned long)s->rejected,
+                     (unsigned long)s->safety_latency_ms, (unsigned long)s->safety_latency_max_ms);
+    if (n < 0) {
+        buf[0] = '\0';
+        return 0;
+    }
+    return (size_t)n < len ? (size_t)n : len - 1;
+}
+
+#if defined(ESP_PLATFORM)
+
+#define TX_TASK_STACK       3072
+#define TX_TASK_PRIORITY    (configMAX_PRIORITIES - 3)   // Below the supervisor, above the UI
+
+static const ecu_can_bus_t* tx_task_bus = NULL;
+
+static void tx_task_fn(void* arg)
+{
+    (void)arg;
+
+    for (;;) {
+        uint32_t wait = ecu_can_tx_next_wait_ms(ecu_can_supervisor_now_ms());
+        if (wait) {
+            TickType_t ticks = pdMS_TO_TICKS(wait);
+            ulTaskNotifyTake(pdTRUE, ticks ? ticks : 1);
+            continue;
+        }
+
+        // Bus off or driver being reinstalled: frames stay queued until it is back
+        bool twai = tx_task_bus == ecu_can_bus_twai();
+        if (twai && !ecu_can_supervisor_driver_lock(ECU_CAN_TX_SEND_TIMEOUT_MS)) {
+            vTaskDelay(pdMS_TO_TICKS(ECU_CAN_TX_RETRY_MS));
+            continue;
+        }
+        while (ecu_can_tx_service(tx_task_bus, ecu_can_supervisor_now_ms())) {
+        }
+        if (twai) ecu_can_supervisor_driver_unlock();
+    }
+}
+
+esp_err_t ecu_can_tx_start(const ecu_can_bus_t* bus)
+{
+    tx_task_bus = bus;
+    if (tx_task) return ESP_OK;
+
+    if (xTaskCreate(tx_task_fn, "can_tx", TX_TASK_STACK, NULL, TX_TASK_PRIORITY, &tx_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+#endif // ESP_PLATFORM
@@ -0,0 +1,115 @@
+/**
+ * CAN transmit queue for the ECU Dashboard
+ * Commands are queued from any task, LVGL event handlers included, without
+ * touching the bus; a single TX task sends them. Safety frames preempt
+ * everything, setpoints coalesce to the latest value per CAN ID and go out
+ * at a bounded rate. Submitting never blocks.
+ */
+
+#ifndef ECU_CAN_TX_H
+#define ECU_CAN_TX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ecu_can_frame.h"
+#include "ecu_can_bus.h"
+
+#if defined(ESP_PLATFORM)
+#include "esp_err.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECU_CAN_TX_DEPTH            8       // Pending frames
+#define ECU_CAN_TX_SETPOINT_MIN_MS  50u     // Setpoint frames at most every 50 ms (20/s)
+#define ECU_CAN_TX_SEND_TIMEOUT_MS  10u     // Wait for controller queue space (TX task only)
+#define ECU_CAN_TX_RETRY_MS         20u     // Hold-off after a failed send
+#define ECU_CAN_TX_IDLE_MS          1000u   // TX task wait when nothing is pending
+
+// Queue classes, highest priority first. A frame supersedes pending frames
+// of the same CAN ID in a lower class: they carry older state and must not
+// follow it onto the bus.
+typedef enum {
+    ECU_CAN_TX_SAFETY = 0,       // Sent first, never rate limited
+    ECU_CAN_TX_COMMAND,          // Mode changes, diagnostics: in submit order
+    ECU_CAN_TX_SETPOINT,         // Latest value per CAN ID; all setpoints share one rate limit
+    ECU_CAN_TX_CLASS_COUNT
+} ecu_can_tx_class_t;
+
+typedef struct {
+    uint32_t queued;             // Accepted by submit
+    uint32_t coalesced;          // Setpoints merged into a pending one
+    uint32_t superseded;         // Pending frames dropped for a higher class of the same ID
+    uint32_t evicted;            // Lower-class frames dropped to make room
+    uint32_t rejected;           // Queue full of equal or higher classes
+    uint32_t sent;
+    uint32_t send_failures;      // Bus refused or timed out, frame kept for a retry
+    uint8_t pending;
+    uint8_t max_pending;
+    uint32_t safety_latency_ms;      // Submit to bus, last safety frame
+    uint32_t safety_latency_max_ms;  // Submit to bus, worst safety frame
+} ecu_can_tx_stats_t;
+
+/**
+ * Empty the queue and reset the statistics
+ */
+void ecu_can_tx_init(void);
+
+/**
+ * Queue a frame. Never blocks; safe from any task (not from an ISR).
+ * @param frame Frame to send
+ * @param cls Queue class
+ * @return false if the queue is full of frames of equal or higher class
+ */
+bool ecu_can_tx_submit(const ecu_can_frame_t* frame, ecu_can_tx_class_t cls);
+
+/**
+ * Send the next due frame. Single consumer: the TX task, or the main
+ * loop on host builds. The frame stays queued if the bus refuses it.
+ * @param bus Transport
+ * @param now_ms Millisecond timestamp (ecu_can_supervisor_now_ms())
+ * @return true if a frame was sent
+ */
+bool ecu_can_tx_service(const ecu_can_bus_t* bus, uint32_t now_ms);
+
+/**
+ * Milliseconds until service() has something to send
+ * @param now_ms Millisecond timestamp
+ * @return 0 if a frame is due, ECU_CAN_TX_IDLE_MS if nothing is pending
+ */
+uint32_t ecu_can_tx_next_wait_ms(uint32_t now_ms);
+
+/**
+ * Read a consistent statistics snapshot
+ * @param out Statistics
+ */
+void ecu_can_tx_get_stats(ecu_can_tx_stats_t* out);
+
+/**
+ * Format the statistics as one text line (serial / diagnostics screen)
+ * @param stats Statistics snapshot
+ * @param buf Output buffer
+ * @param len Buffer size
+ * @return Characters written, excluding the terminator
+ */
+size_t ecu_can_tx_format_text(const ecu_can_tx_stats_t* stats, char* buf, size_t len);
+
+#if defined(ESP_PLATFORM)
+/**
+ * Start the TX task. It sleeps until a frame is submitted or a setpoint
+ * becomes due; on the TWAI bus it sends under the supervisor driver lock,
+ * so frames wait out a bus-off instead of being lost.
+ * @param bus Transport
+ * @return ESP_OK, ESP_ERR_NO_MEM if the task could not be created
+ */
+esp_err_t ecu_can_tx_start(const ecu_can_bus_t* bus);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_CAN_TX_H
@@ -17,6 +17,126 @@ typedef struct {
     uint32_t timestamp;          // Timestamp in milliseconds
 } ecu_data_t;
 
+// Numeric ECU channels, used to index gauges and per-channel state
+typedef enum {
+    ECU_CH_MAP_PRESSURE = 0,
+    ECU_CH_WASTEGATE_POSITION,
+    ECU_CH_TPS_POSITION,
+    ECU_CH_ENGINE_RPM,
+    ECU_CH_TARGET_BOOST,
+    ECU_CH_TORQUE_REQUEST,
+    ECU_CH_COUNT
+} ecu_channel_t;
+
+// Read a numeric channel from the ECU data structure
+static inline float ecu_data_get_channel(const ecu_data_t* data, ecu_channel_t channel)
+{
+    switch (channel) {
+        case ECU_CH_MAP_PRESSURE:       return data->map_pressure;
+        case ECU_CH_WASTEGATE_POSITION: return data->wastegate_position;
+        case ECU_CH_TPS_POSITION:       return data->tps_position;
+        case ECU_CH_ENGINE_RPM:         return data->engine_rpm;
+        case ECU_CH_TARGET_BOOST:       return data->target_boost;
+        case ECU_CH_TORQUE_REQUEST:     return data->torque_request;
+        default:                        return 0.0f;
+    }
+}
+
+// Fixed-point ECU snapshot: raw CAN units as decoded, 16 bytes instead of 32.
+// Converted to engineering units only for presentation (ecu_fx_get_tenths).
+// Frame layouts are defined in ecu_can_spec.h.
+typedef struct {
+    uint16_t map_pressure;       // 0.1 kPa/bit (0x380 bytes 2-3)
+    uint16_t target_boost;       // 0.1 kPa/bit (0x200 bytes 1-2)
+    uint16_t engine_rpm;         // 1 RPM/bit (0x380 bytes 0-1)
+    uint16_t torque_request;     // 1 Nm/bit (0x440 bytes 0-1)
+    uint8_t wastegate_position;  // 1 %/bit (0x200 byte 0)
+    uint8_t tps_position;        // 1 %/bit (0x380 byte 4)
+    uint8_t flags;               // ECU_FX_FLAG_*
+    uint8_t reserved;
+    uint32_t timestamp;          // Timestamp in milliseconds
+} ecu_data_fx_t;
+
+#define ECU_FX_FLAG_TCU_PROTECTION  (1 << 0)
+#define ECU_FX_FLAG_TCU_LIMP        (1 << 1)
+
+// Torque request is shown as a percentage of this
+#define ECU_TORQUE_FULL_SCALE_NM    500
+
+// Raw-to-display scale of a channel: tenths = raw * mul / div (rounded)
+typedef struct {
+    int16_t mul;
+    int16_t div;
+} ecu_channel_scale_t;
+
+// Scale metadata per channel
+static inline ecu_channel_scale_t ecu_channel_scale(ecu_channel_t channel)
+{
+    ecu_channel_scale_t scale = {1, 1};    // MAP, target boost: 0.1 kPa/bit
+    switch (channel) {
+        case ECU_CH_WASTEGATE_POSITION:
+        case ECU_CH_TPS_POSITION:
+        case ECU_CH_ENGINE_RPM:         scale.mul = 10; break;
+        case ECU_CH_TORQUE_REQUEST:     scale.mul = 1000; scale.div = ECU_TORQUE_FULL_SCALE_NM; break;
+        default:                        break;
+    }
+    return scale;
+}
+
+// Read a channel in raw CAN units
+static inline int32_t ecu_fx_get_raw(const ecu_data_fx_t* data, ecu_channel_t channel)
+{
+    switch (channel) {
+        case ECU_CH_MAP_PRESSURE:       return data->map_pressure;
+        case ECU_CH_WASTEGATE_POSITION: return data->wastegate_position;
+        case ECU_CH_TPS_POSITION:       return data->tps_position;
+        case ECU_CH_ENGINE_RPM:         return data->engine_rpm;
+        case ECU_CH_TARGET_BOOST:       return data->target_boost;
+        case ECU_CH_TORQUE_REQUEST:     return data->torque_request;
+        default:                        return 0;
+    }
+}
+
+// Read a channel in 0.1 engineering units, integer only
+static inline int32_t ecu_fx_get_tenths(const ecu_data_fx_t* data, ecu_channel_t channel)
+{
+    ecu_channel_scale_t scale = ecu_channel_scale(channel);
+    int32_t raw = ecu_fx_get_raw(data, channel);
+    if (scale.div == 1) {
+        return raw * scale.mul;
+    }
+    return (raw * scale.mul + scale.div / 2) / scale.div;
+}
+
+// Presentation-side conversion to the float model
+static inline void ecu_fx_to_float(const ecu_data_fx_t* fx, ecu_data_t* out)
+{
+    out->map_pressure = (float)ecu_fx_get_tenths(fx, ECU_CH_MAP_PRESSURE) * 0.1f;
+    out->wastegate_position = (float)ecu_fx_get_tenths(fx, ECU_CH_WASTEGATE_POSITION) * 0.1f;
+    out->tps_position = (float)ecu_fx_get_tenths(fx, ECU_CH_TPS_POSITION) * 0.1f;
+    out->engine_rpm = (float)fx->engine_rpm;
+    out->target_boost = (float)ecu_fx_get_tenths(fx, ECU_CH_TARGET_BOOST) * 0.1f;
+    out->torque_request = (float)ecu_fx_get_tenths(fx, ECU_CH_TORQUE_REQUEST) * 0.1f;
+    out->tcu_protection_active = (fx->flags & ECU_FX_FLAG_TCU_PROTECTION) != 0;
+    out->tcu_limp_mode = (fx->flags & ECU_FX_FLAG_TCU_LIMP) != 0;
+    out->timestamp = fx->timestamp;
+}
+
+// Float model to raw units (simulation and legacy callers)
+static inline void ecu_fx_from_float(const ecu_data_t* in, ecu_data_fx_t* fx)
+{
+    fx->map_pressure = (uint16_t)(in->map_pressure * 10.0f + 0.5f);
+    fx->target_boost = (uint16_t)(in->target_boost * 10.0f + 0.5f);
+    fx->engine_rpm = (uint16_t)(in->engine_rpm + 0.5f);
+    fx->wastegate_position = (uint8_t)(in->wastegate_position + 0.5f);
+    fx->tps_position = (uint8_t)(in->tps_position + 0.5f);
+    fx->torque_request = (uint16_t)(in->torque_request * (ECU_TORQUE_FULL_SCALE_NM / 100.0f) + 0.5f);
+    fx->flags = (in->tcu_protection_active ? ECU_FX_FLAG_TCU_PROTECTION : 0) |
+                (in->tcu_limp_mode ? ECU_FX_FLAG_TCU_LIMP : 0);
+    fx->reserved = 0;
+    fx->timestamp = in->timestamp;
+}
+
 // Gauge configuration structure
 typedef struct {
     const char* title;           // Gauge title
@@ -31,6 +151,9 @@ typedef struct {
     uint32_t danger_color;       // Danger color
 } gauge_config_t;
 
+// Threshold value for gauges without warning/danger levels
+#define GAUGE_THRESHOLD_NONE    3.4e38f
+
 // Display settings structure
 typedef struct {
     uint8_t gauge_size;          // 0=small, 1=medium, 2=large, 3=xlarge
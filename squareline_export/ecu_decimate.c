@@ -0,0 +1,196 @@
+/**
+ * Min/max/mean decimation of int16 sample blocks
+ * The PIE path handles the 16-byte aligned middle of a block eight lanes at
+ * a time; the unaligned head and tail, and short blocks, use the scalar loop
+ */
+
+#include "ecu_decimate.h"
+#include <stdio.h>
+
+#if defined(ESP_PLATFORM)
+#include "esp_timer.h"
+#else
+#include <time.h>
+#endif
+
+#if ECU_DECIMATE_USE_PIE
+// ecu_decimate_s3.S: reduce `vectors` aligned groups of 8 samples
+extern void ecu_decimate_pie_s16(const int16_t* src, uint32_t vectors,
+                                 int16_t* min8, int16_t* max8, int32_t* sum,
+                                 const int16_t* ones);
+
+static const int16_t pie_ones[8] __attribute__((aligned(16))) = {1, 1, 1, 1, 1, 1, 1, 1};
+#endif
+
+// Benchmark limits
+#define BENCH_MAX_SAMPLES   4096
+#define BENCH_MAX_BUCKETS   512
+
+static int32_t block_scalar(const int16_t* src, uint32_t count, int16_t* min_out, int16_t* max_out)
+{
+    int16_t lo = src[0];
+    int16_t hi = src[0];
+    int32_t sum = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        int16_t v = src[i];
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+        sum += v;
+    }
+
+    *min_out = lo;
+    *max_out = hi;
+    return sum;
+}
+
+int32_t ecu_decimate_block(const int16_t* src, uint32_t count, int16_t* min_out, int16_t* max_out)
+{
+#if ECU_DECIMATE_USE_PIE
+    if (count >= ECU_DECIMATE_VECTOR_MIN) {
+        int16_t min8[8] __attribute__((aligned(16)));
+        int16_t max8[8] __attribute__((aligned(16)));
+        int32_t sum;
+
+        // Samples before the first 16-byte boundary, then whole vectors, then the rest
+        uint32_t head = ((16 - ((uintptr_t)src & 15)) & 15) / sizeof(int16_t);
+        uint32_t vectors = (count - head) / 8;
+        uint32_t tail = count - head - vectors * 8;
+
+        ecu_decimate_pie_s16(src + head, vectors, min8, max8, &sum, pie_ones);
+
+        int16_t lo = min8[0];
+        int16_t hi = max8[0];
+        for (int i = 1; i < 8; i++) {
+            if (min8[i] < lo) lo = min8[i];
+            if (max8[i] > hi) hi = max8[i];
+        }
+
+        int16_t part_lo, part_hi;
+        if (head) {
+            sum += block_scalar(src, head, &part_lo, &part_hi);
+            if (part_lo < lo) lo = part_lo;
+            if (part_hi > hi) hi = part_hi;
+        }
+        if (tail) {
+            sum += block_scalar(src + head + vectors * 8, tail, &part_lo, &part_hi);
+            if (part_lo < lo) lo = part_lo;
+            if (part_hi > hi) hi = part_hi;
+        }
+
+        *min_out = lo;
+        *max_out = hi;
+        return sum;
+    }
+#endif
+    return block_scalar(src, count, min_out, max_out);
+}
+
+// Shared bucket loop; `reduce` is the block kernel to use
+static void decimate_with(int32_t (*reduce)(const int16_t*, uint32_t, int16_t*, int16_t*),
+                          const int16_t* src, uint32_t count, uint32_t buckets,
+                          int16_t* min_out, int16_t* max_out, int16_t* mean_out)
+{
+    for (uint32_t b = 0; b < buckets; b++) {
+        uint32_t start = (uint32_t)((uint64_t)b * count / buckets);
+        uint32_t end = (uint32_t)((uint64_t)(b + 1) * count / buckets);
+        uint32_t n = end - start;
+        int16_t lo, hi;
+
+        int32_t sum = reduce(src + start, n, &lo, &hi);
+
+        if (min_out) min_out[b] = lo;
+        if (max_out) max_out[b] = hi;
+        if (mean_out) mean_out[b] = (int16_t)(sum / (int32_t)n);
+    }
+}
+
+void ecu_decimate(const int16_t* src, uint32_t count, uint32_t buckets,
+                  int16_t* min_out, int16_t* max_out, int16_t* mean_out)
+{
+    if (buckets == 0 || count < buckets) return;
+    decimate_with(ecu_decimate_block, src, count, buckets, min_out, max_out, mean_out);
+}
+
+void ecu_decimate_scalar(const int16_t* src, uint32_t count, uint32_t buckets,
+                         int16_t* min_out, int16_t* max_out, int16_t* mean_out)
+{
+    if (buckets == 0 || count < buckets) return;
+    decimate_with(block_scalar, src, count, buckets, min_out, max_out, mean_out);
+}
+
+// Benchmark clock in microseconds
+static uint32_t bench_now_us(void)
+{
+#if defined(ESP_PLATFORM)
+    return (uint32_t)esp_timer_get_time();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+#endif
+}
+
+void ecu_decimate_benchmark(uint32_t samples, uint32_t buckets, uint32_t passes,
+                            ecu_decimate_bench_t* result)
+{
+    static int16_t src[BENCH_MAX_SAMPLES] __attribute__((aligned(16)));
+    static int16_t scalar_out[3][BENCH_MAX_BUCKETS];
+    static int16_t vector_out[3][BENCH_MAX_BUCKETS];
+    uint32_t seed = 0x1234567u;
+
+    if (samples > BENCH_MAX_SAMPLES) samples = BENCH_MAX_SAMPLES;
+    if (buckets > BENCH_MAX_BUCKETS) buckets = BENCH_MAX_BUCKETS;
+    if (buckets > samples) buckets = samples;
+
+    // Boost-like trace in 0.1 kPa: slow ramps plus sensor noise
+    for (uint32_t i = 0; i < samples; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        src[i] = (int16_t)(1000 + (i % 1500) + (int16_t)((seed >> 24) & 0x3F) - 32);
+    }
+
+    uint32_t t0 = bench_now_us();
+    for (uint32_t p = 0; p < passes; p++) {
+        ecu_decimate_scalar(src, samples, buckets, scalar_out[0], scalar_out[1], scalar_out[2]);
+    }
+    uint32_t t1 = bench_now_us();
+    for (uint32_t p = 0; p < passes; p++) {
+        ecu_decimate(src, samples, buckets, vector_out[0], vector_out[1], vector_out[2]);
+    }
+    uint32_t t2 = bench_now_us();
+
+    result->samples = samples;
+    result->buckets = buckets;
+    result->passes = passes;
+    result->scalar_us = t1 - t0;
+    result->vector_us = t2 - t1;
+    result->vector_available = ECU_DECIMATE_USE_PIE;
+    result->results_match = true;
+    for (int k = 0; k < 3; k++) {
+        for (uint32_t b = 0; b < buckets; b++) {
+            if (scalar_out[k][b] != vector_out[k][b]) {
+                result->results_match = false;
+            }
+        }
+    }
+}
+
+size_t ecu_decimate_bench_format_text(const ecu_decimate_bench_t* result, char* buf, size_t len)
+{
+    if (len == 0) return 0;
+
+    uint32_t passes = result->passes ? result->passes : 1;
+    int n = snprintf(buf, len,
+                     "Decimate %lu samples -> %lu buckets: scalar %lu us, %s %lu us per pass (x%.2f), %s",
+                     (unsigned long)result->samples, (unsigned long)result->buckets,
+                     (unsigned long)(result->scalar_us / passes),
+                     result->vector_available ? "PIE" : "dispatch",
+                     (unsigned long)(result->vector_us / passes),
+                     result->vector_us ? (double)result->scalar_us / result->vector_us : 0.0,
+                     result->results_match ? "results match" : "RESULTS DIFFER");
+    if (n < 0) {
+        buf[0] = '\0';
+        return 0;
+    }
+    return (size_t)n < len ? (size_t)n : len - 1;
+}
@@ -0,0 +1,98 @@
+/**
+ * Min/max/mean decimation of int16 sample blocks
+ * Uses the ESP32-S3 PIE vector unit when available, portable C otherwise
+ */
+
+#ifndef ECU_DECIMATE_H
+#define ECU_DECIMATE_H
+
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#endif
+
+// PIE kernel: ESP32-S3 only; define ECU_DECIMATE_FORCE_SCALAR to disable
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(ECU_DECIMATE_FORCE_SCALAR)
+#define ECU_DECIMATE_USE_PIE    1
+#else
+#define ECU_DECIMATE_USE_PIE    0
+#endif
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Minimum block length worth handing to the vector unit
+#define ECU_DECIMATE_VECTOR_MIN     32
+
+// Benchmark result
+typedef struct {
+    uint32_t samples;            // Samples reduced per pass
+    uint32_t buckets;            // Buckets per pass
+    uint32_t passes;             // Passes timed per path
+    uint32_t scalar_us;          // Total time of the scalar path
+    uint32_t vector_us;          // Total time of the dispatched path (PIE if available)
+    bool vector_available;       // PIE kernel compiled in
+    bool results_match;          // Both paths produced identical buckets
+} ecu_decimate_bench_t;
+
+/**
+ * Reduce one block of samples
+ * @param src Samples
+ * @param count Number of samples (> 0)
+ * @param min_out Minimum
+ * @param max_out Maximum
+ * @return Sum of all samples
+ */
+int32_t ecu_decimate_block(const int16_t* src, uint32_t count, int16_t* min_out, int16_t* max_out);
+
+/**
+ * Split samples into equal buckets and reduce each to min/max/mean.
+ * Bucket b covers [b*count/buckets, (b+1)*count/buckets).
+ * @param src Samples
+ * @param count Number of samples (>= buckets)
+ * @param buckets Number of output buckets (> 0)
+ * @param min_out Per-bucket minimum, or NULL
+ * @param max_out Per-bucket maximum, or NULL
+ * @param mean_out Per-bucket mean (truncated toward zero), or NULL
+ */
+void ecu_decimate(const int16_t* src, uint32_t count, uint32_t buckets,
+                  int16_t* min_out, int16_t* max_out, int16_t* mean_out);
+
+/**
+ * Scalar reference for ecu_decimate(), always portable C
+ */
+void ecu_decimate_scalar(const int16_t* src, uint32_t count, uint32_t buckets,
+                         int16_t* min_out, int16_t* max_out, int16_t* mean_out);
+
+/**
+ * Time the scalar and dispatched paths on a synthetic boost trace
+ * @param samples Samples per pass (up to 4096)
+ * @param buckets Buckets per pass
+ * @param passes Passes per path
+ * @param result Timing and consistency result
+ */
+void ecu_decimate_benchmark(uint32_t samples, uint32_t buckets, uint32_t passes,
+                            ecu_decimate_bench_t* result);
+
+/**
+ * Format a benchmark result as one text line
+ * @param result Benchmark result
+ * @param buf Output buffer
+ * @param len Buffer size
+ * @return Characters written, excluding the terminator
+ */
+size_t ecu_decimate_bench_format_text(const ecu_decimate_bench_t* result, char* buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ASSEMBLER__
+
+#endif // ECU_DECIMATE_H
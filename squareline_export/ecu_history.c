@@ -0,0 +1,159 @@
+/**
+ * Multi-resolution history buffer for the ECU Dashboard
+ * Tier 0 stores every sample; each slower tier folds a fixed number of
+ * buckets of the tier below into one min/max bucket
+ */
+
+#include "ecu_history.h"
+#include "ecu_decimate.h"
+#include <string.h>
+
+// One ring of min/max buckets; min and max are kept in separate arrays
+// so a column reduction runs over contiguous int16 data
+typedef struct {
+    int16_t min[ECU_HISTORY_CHANNEL_COUNT][ECU_HISTORY_LEN];
+    int16_t max[ECU_HISTORY_CHANNEL_COUNT][ECU_HISTORY_LEN];
+    int16_t pending_min[ECU_HISTORY_CHANNEL_COUNT];  // Bucket being filled
+    int16_t pending_max[ECU_HISTORY_CHANNEL_COUNT];
+    uint16_t head;                  // Next write index (oldest bucket once full)
+    uint16_t count;                 // Committed buckets, up to ECU_HISTORY_LEN
+    uint8_t pending_count;          // Inputs folded into the pending bucket
+    volatile uint32_t revision;     // Incremented on every commit
+} history_tier_t;
+
+static history_tier_t history_tiers[ECU_HISTORY_TIER_COUNT];
+
+// Inputs per bucket for each tier
+static const uint8_t tier_factor[ECU_HISTORY_TIER_COUNT] = {
+    [ECU_HISTORY_TIER_10S]   = 1,
+    [ECU_HISTORY_TIER_1MIN]  = ECU_HISTORY_TIER1_FACTOR,
+    [ECU_HISTORY_TIER_10MIN] = ECU_HISTORY_TIER2_FACTOR,
+};
+
+// ECU data source of each recorded channel
+static const ecu_channel_t history_sources[ECU_HISTORY_CHANNEL_COUNT] = {
+    [ECU_HISTORY_BOOST]     = ECU_CH_MAP_PRESSURE,
+    [ECU_HISTORY_TARGET]    = ECU_CH_TARGET_BOOST,
+    [ECU_HISTORY_WASTEGATE] = ECU_CH_WASTEGATE_POSITION,
+};
+
+// Clamp 0.1 units to int16 so a sample never collides with ECU_HISTORY_NO_DATA
+static int16_t clamp_tenths(int32_t tenths)
+{
+    if (tenths > INT16_MAX) return INT16_MAX;
+    if (tenths < -INT16_MAX) return -INT16_MAX;
+    return (int16_t)tenths;
+}
+
+// Fold one min/max bucket into a tier, committing and cascading when it is full
+static void tier_fold(int tier_index, const int16_t* in_min, const int16_t* in_max)
+{
+    history_tier_t* tier = &history_tiers[tier_index];
+
+    for (int ch = 0; ch < ECU_HISTORY_CHANNEL_COUNT; ch++) {
+        if (tier->pending_count == 0 || in_min[ch] < tier->pending_min[ch]) {
+            tier->pending_min[ch] = in_min[ch];
+        }
+        if (tier->pending_count == 0 || in_max[ch] > tier->pending_max[ch]) {
+            tier->pending_max[ch] = in_max[ch];
+        }
+    }
+
+    if (++tier->pending_count < tier_factor[tier_index]) {
+        return;
+    }
+
+    uint16_t slot = tier->head;
+    for (int ch = 0; ch < ECU_HISTORY_CHANNEL_COUNT; ch++) {
+        tier->min[ch][slot] = tier->pending_min[ch];
+        tier->max[ch][slot] = tier->pending_max[ch];
+    }
+    tier->head = (slot + 1 < ECU_HISTORY_LEN) ? slot + 1 : 0;
+    if (tier->count < ECU_HISTORY_LEN) {
+        tier->count++;
+    }
+    tier->pending_count = 0;
+    tier->revision++;
+
+    if (tier_index + 1 < ECU_HISTORY_TIER_COUNT) {
+        tier_fold(tier_index + 1, tier->pending_min, tier->pending_max);
+    }
+}
+
+void ecu_history_reset(void)
+{
+    memset(history_tiers, 0, sizeof(history_tiers));
+}
+
+void ecu_history_push(const ecu_data_fx_t* data)
+{
+    int16_t sample[ECU_HISTORY_CHANNEL_COUNT];
+
+    for (int ch = 0; ch < ECU_HISTORY_CHANNEL_COUNT; ch++) {
+        sample[ch] = clamp_tenths(ecu_fx_get_tenths(data, history_sources[ch]));
+    }
+    tier_fold(ECU_HISTORY_TIER_10S, sample, sample);
+}
+
+uint32_t ecu_history_revision(ecu_history_tier_t tier)
+{
+    return history_tiers[tier].revision;
+}
+
+uint16_t ecu_history_read(ecu_history_tier_t tier, ecu_history_channel_t channel,
+                          int16_t* min_out, int16_t* max_out, uint16_t points)
+{
+    const history_tier_t* t = &history_tiers[tier];
+    const int16_t* src_min = t->min[channel];
+    const int16_t* src_max = t->max[channel];
+    uint16_t head = t->head;
+    uint16_t count = t->count;
+    uint16_t first = ECU_HISTORY_LEN - count;  // Window position of the oldest bucket
+    uint16_t filled = 0;
+
+    if (points == 0) return 0;
+    if (points > ECU_HISTORY_LEN) points = ECU_HISTORY_LEN;
+
+    for (uint16_t col = 0; col < points; col++) {
+        uint16_t start = (uint32_t)col * ECU_HISTORY_LEN / points;
+        uint16_t end = (uint32_t)(col + 1) * ECU_HISTORY_LEN / points;
+
+        if (end <= first) {
+            min_out[col] = ECU_HISTORY_NO_DATA;
+            max_out[col] = ECU_HISTORY_NO_DATA;
+            continue;
+        }
+        if (start < first) start = first;
+
+        // Window position p lives at ring index (head + p) mod LEN;
+        // a column that crosses the end of the ring is reduced in two spans
+        uint16_t idx = head + start;
+        if (idx >= ECU_HISTORY_LEN) idx -= ECU_HISTORY_LEN;
+        uint16_t n = end - start;
+        uint16_t first_span = (idx + n > ECU_HISTORY_LEN) ? ECU_HISTORY_LEN - idx : n;
+
+        int16_t lo, hi, span_lo, span_hi, unused;
+        ecu_decimate_block(&src_min[idx], first_span, &lo, &unused);
+        ecu_decimate_block(&src_max[idx], first_span, &unused, &hi);
+        if (first_span < n) {
+            ecu_decimate_block(src_min, n - first_span, &span_lo, &unused);
+            ecu_decimate_block(src_max, n - first_span, &unused, &span_hi);
+            if (span_lo < lo) lo = span_lo;
+            if (span_hi > hi) hi = span_hi;
+        }
+        min_out[col] = lo;
+        max_out[col] = hi;
+        filled++;
+    }
+
+    return filled;
+}
+
+uint32_t ecu_history_span_ms(ecu_history_tier_t tier)
+{
+    uint32_t bucket_ms = ECU_HISTORY_SAMPLE_MS;
+    for (int i = 1; i <= (int)tier; i++) {
+        bucket_ms *= tier_factor[i];
+    }
+    return bucket_ms * ECU_HISTORY_LEN;
+}
@@ -0,0 +1,92 @@
+/**
+ * Multi-resolution history buffer for the ECU Dashboard
+ * Keeps boost, target boost and wastegate at full rate for the last 10 s,
+ * plus min/max decimated tiers covering 1 min and 10 min
+ */
+
+#ifndef ECU_HISTORY_H
+#define ECU_HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ecu_data_structures.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Entries per tier; every tier spans ECU_HISTORY_LEN buckets
+#define ECU_HISTORY_LEN             500
+
+// Full-rate sample period (boost control frame 0x200, 50Hz)
+#define ECU_HISTORY_SAMPLE_MS       20
+
+// Samples folded into one bucket of the next tier
+#define ECU_HISTORY_TIER1_FACTOR    6       // 500 x 120ms = 1 min
+#define ECU_HISTORY_TIER2_FACTOR    10      // 500 x 1.2s  = 10 min
+
+// Marker for columns with no data yet
+#define ECU_HISTORY_NO_DATA         INT16_MIN
+
+// History tiers
+typedef enum {
+    ECU_HISTORY_TIER_10S = 0,
+    ECU_HISTORY_TIER_1MIN,
+    ECU_HISTORY_TIER_10MIN,
+    ECU_HISTORY_TIER_COUNT
+} ecu_history_tier_t;
+
+// Recorded channels
+typedef enum {
+    ECU_HISTORY_BOOST = 0,      // MAP pressure, 0.1 kPa
+    ECU_HISTORY_TARGET,         // Target boost, 0.1 kPa
+    ECU_HISTORY_WASTEGATE,      // Wastegate position, 0.1 %
+    ECU_HISTORY_CHANNEL_COUNT
+} ecu_history_channel_t;
+
+/**
+ * Clear all tiers
+ */
+void ecu_history_reset(void);
+
+/**
+ * Append one full-rate sample and cascade completed buckets into the
+ * slower tiers. O(1); call from the decode path at ECU_HISTORY_SAMPLE_MS.
+ * Single writer: readers may see the newest bucket change while rendering.
+ * @param data Current ECU data in raw CAN units
+ */
+void ecu_history_push(const ecu_data_fx_t* data);
+
+/**
+ * Revision counter of a tier, incremented whenever a bucket is committed
+ * @param tier History tier
+ * @return Revision, compare with a previous value to detect new data
+ */
+uint32_t ecu_history_revision(ecu_history_tier_t tier);
+
+/**
+ * Reduce a whole tier to a fixed number of columns, oldest first.
+ * Cost depends only on ECU_HISTORY_LEN, not on how long the session ran.
+ * Columns not yet covered by data are set to ECU_HISTORY_NO_DATA.
+ * @param tier History tier
+ * @param channel Channel to read
+ * @param min_out Per-column minimum (points entries)
+ * @param max_out Per-column maximum (points entries)
+ * @param points Number of columns, 1..ECU_HISTORY_LEN
+ * @return Number of columns that contain data (right-aligned)
+ */
+uint16_t ecu_history_read(ecu_history_tier_t tier, ecu_history_channel_t channel,
+                          int16_t* min_out, int16_t* max_out, uint16_t points);
+
+/**
+ * Time span of one tier
+ * @param tier History tier
+ * @return Span in milliseconds
+ */
+uint32_t ecu_history_span_ms(ecu_history_tier_t tier);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_HISTORY_H
@@ -0,0 +1,165 @@
+/**
+ * ISO-TP (ISO 15765-2) receiver for the ECU Dashboard
+ * Receive side only: single, first and consecutive frames in, flow control
+ * out. One message in flight per channel.
+ */
+
+#include "ecu_isotp.h"
+#include <string.h>
+
+#define PCI_SINGLE          0x0
+#define PCI_FIRST           0x1
+#define PCI_CONSECUTIVE     0x2
+#define PCI_FLOW_CONTROL    0x3
+
+#define CLASSIC_LEN         8
+
+static void send_flow_control(ecu_isotp_rx_t* rx, uint8_t flow_status)
+{
+    uint8_t fc[CLASSIC_LEN];
+
+    if (rx->send == NULL) return;
+    memset(fc, ECU_ISOTP_FC_PADDING, sizeof(fc));
+    fc[0] = (uint8_t)((PCI_FLOW_CONTROL << 4) | flow_status);
+    fc[1] = rx->block_size;
+    fc[2] = rx->st_min;
+    if (rx->send(rx->ctx, rx->fc_id, fc, rx->fc_len)) {
+        rx->stats.flow_controls++;
+    } else {
+        rx->stats.fc_failures++;
+    }
+}
+
+static void deliver(ecu_isotp_rx_t* rx, const uint8_t* data, uint16_t len)
+{
+    rx->stats.messages++;
+    if (rx->deliver) rx->deliver(rx->ctx, data, len);
+}
+
+void ecu_isotp_rx_init(ecu_isotp_rx_t* rx, uint32_t rx_id, uint32_t fc_id,
+                       ecu_isotp_deliver_fn deliver_cb, ecu_isotp_send_fn send, void* ctx)
+{
+    memset(rx, 0, sizeof(*rx));
+    rx->rx_id = rx_id;
+    rx->fc_id = fc_id;
+    rx->fc_len = CLASSIC_LEN;
+    rx->deliver = deliver_cb;
+    rx->send = send;
+    rx->ctx = ctx;
+}
+
+// Single frame: classic SF_DL in the low nibble, or the FD escape (nibble 0, length in byte 1)
+static bool rx_single(ecu_isotp_rx_t* rx, const uint8_t* data, uint8_t len)
+{
+    uint8_t dl = data[0] & 0x0F;
+    uint8_t offset = 1;
+
+    if (dl == 0 && len > CLASSIC_LEN) {
+        dl = data[1];
+        offset = 2;
+    }
+    if (dl == 0 || dl > len - offset) return false;
+
+    rx->stats.single_frames++;
+    deliver(rx, data + offset, dl);
+    return true;
+}
+
+static bool rx_first(ecu_isotp_rx_t* rx, const uint8_t* data, uint8_t len, uint32_t now_ms)
+{
+    uint32_t total = ((uint32_t)(data[0] & 0x0F) << 8) | data[1];
+    uint8_t offset = 2;
+
+    // FF_DL escape: 32-bit length for messages over 4095 bytes
+    if (total == 0) {
+        if (len < 6) return false;
+        total = ((uint32_t)data[2] << 24) | ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 8) | data[5];
+        offset = 6;
+    }
+
+    if (rx->receiving) rx->stats.restarts++;
+    rx->receiving = false;
+
+    if (total > ECU_ISOTP_MAX_PAYLOAD) {
+        rx->stats.overflows++;
+        send_flow_control(rx, ECU_ISOTP_FS_OVERFLOW);
+        return false;
+    }
+    // A first frame must not fit a single frame; treat it as malformed
+    if (total <= (uint32_t)(len - offset)) return false;
+
+    memcpy(rx->buf, data + offset, len - offset);
+    rx->expected = (uint16_t)total;
+    rx->received = (uint16_t)(len - offset);
+    rx->next_sn = 1;
+    rx->block_count = 0;
+    rx->last_ms = now_ms;
+    rx->receiving = true;
+    send_flow_control(rx, ECU_ISOTP_FS_CTS);
+    return false;
+}
+
+static bool rx_consecutive(ecu_isotp_rx_t* rx, const uint8_t* data, uint8_t len, uint32_t now_ms)
+{
+    if (!rx->receiving) return false;
+
+    if ((data[0] & 0x0F) != rx->next_sn) {
+        rx->stats.sequence_errors++;
+        rx->receiving = false;
+        return false;
+    }
+
+    uint16_t remaining = (uint16_t)(rx->expected - rx->received);
+    uint16_t take = (uint16_t)(len - 1);
+    if (take > remaining) take = remaining;
+
+    memcpy(rx->buf + rx->received, data + 1, take);
+    rx->received = (uint16_t)(rx->received + take);
+    rx->next_sn = (uint8_t)((rx->next_sn + 1) & 0x0F);
+    rx->last_ms = now_ms;
+    rx->stats.consecutive_frames++;
+
+    if (rx->received >= rx->expected) {
+        rx->receiving = false;
+        deliver(rx, rx->buf, rx->expected);
+        return true;
+    }
+
+    if (rx->block_size && ++rx->block_count >= rx->block_size) {
+        rx->block_count = 0;
+        send_flow_control(rx, ECU_ISOTP_FS_CTS);
+    }
+    return false;
+}
+
+bool ecu_isotp_rx_frame(ecu_isotp_rx_t* rx, const uint8_t* data, uint8_t len, uint32_t now_ms)
+{
+    if (len < 2) return false;
+
+    ecu_isotp_rx_poll(rx, now_ms);
+
+    switch (data[0] >> 4) {
+        case PCI_SINGLE:
+            // A single frame aborts a segmented message in flight
+            if (rx->receiving) {
+                rx->stats.restarts++;
+                rx->receiving = false;
+            }
+            return rx_single(rx, data, len);
+        case PCI_FIRST:
+            return rx_first(rx, data, len, now_ms);
+        case PCI_CONSECUTIVE:
+            return rx_consecutive(rx, data, len, now_ms);
+        default:
+            // Flow control is for senders; reserved PCI types are ignored
+            return false;
+    }
+}
+
+void ecu_isotp_rx_poll(ecu_isotp_rx_t* rx, uint32_t now_ms)
+{
+    if (rx->receiving && now_ms - rx->last_ms > ECU_ISOTP_TIMEOUT_CR_MS) {
+        rx->receiving = false;
+        rx->stats.timeouts++;
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * ISO-TP (ISO 15765-2) receiver for the ECU Dashboard
+ * Reassembles segmented diagnostic payloads (DTC lists, extended data)
+ * into a buffer preallocated per channel. Single and first frames use the
+ * classic or the CAN FD escape format; flow control goes out through a
+ * send callback. No heap allocation, safe to run in the RX path.
+ */
+
+#ifndef ECU_ISOTP_H
+#define ECU_ISOTP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECU_ISOTP_MAX_PAYLOAD   256     // Reassembly buffer per channel
+#define ECU_ISOTP_TIMEOUT_CR_MS 1000    // N_Cr: max gap between consecutive frames
+#define ECU_ISOTP_FC_PADDING    0xCC    // Fill byte of flow control frames
+
+// Flow status of a flow control frame
+#define ECU_ISOTP_FS_CTS        0       // Continue to send
+#define ECU_ISOTP_FS_WAIT       1
+#define ECU_ISOTP_FS_OVERFLOW   2       // Message longer than the buffer
+
+/**
+ * Send a flow control frame
+ * @param ctx Callback context
+ * @param can_id Flow control ID of the channel
+ * @param data Frame payload
+ * @param len Payload bytes
+ * @return false if it could not be queued
+ */
+typedef bool (*ecu_isotp_send_fn)(void* ctx, uint32_t can_id, const uint8_t* data, uint8_t len);
+
+/**
+ * Deliver a complete message. data points into the channel buffer and is
+ * valid until the next frame is fed to the channel.
+ * @param ctx Callback context
+ * @param data Payload
+ * @param len Payload bytes
+ */
+typedef void (*ecu_isotp_deliver_fn)(void* ctx, const uint8_t* data, uint16_t len);
+
+typedef struct {
+    uint32_t messages;           // Delivered
+    uint32_t single_frames;
+    uint32_t consecutive_frames;
+    uint32_t flow_controls;      // Flow control frames sent
+    uint32_t timeouts;           // N_Cr expired mid-message
+    uint32_t sequence_errors;    // Wrong sequence number, message dropped
+    uint32_t overflows;          // Announced length above ECU_ISOTP_MAX_PAYLOAD
+    uint32_t restarts;           // New first frame while receiving
+    uint32_t fc_failures;        // Flow control could not be sent
+} ecu_isotp_stats_t;
+
+typedef struct {
+    uint32_t rx_id;              // Data frames from the sender
+    uint32_t fc_id;              // Our flow control frames
+    uint8_t block_size;          // BS advertised in flow control, 0 = all at once
+    uint8_t st_min;              // STmin advertised in flow control (raw ISO-TP encoding)
+    uint8_t fc_len;              // Flow control frame length (8, padded)
+    bool receiving;
+    uint8_t next_sn;
+    uint8_t block_count;
+    uint16_t expected;
+    uint16_t received;
+    uint32_t last_ms;
+    ecu_isotp_send_fn send;
+    ecu_isotp_deliver_fn deliver;
+    void* ctx;
+    ecu_isotp_stats_t stats;
+    uint8_t buf[ECU_ISOTP_MAX_PAYLOAD];
+} ecu_isotp_rx_t;
+
+/**
+ * Set up a receive channel
+ * @param rx Channel storage
+ * @param rx_id CAN ID the sender uses
+ * @param fc_id CAN ID for our flow control frames
+ * @param deliver Called with every complete message
+ * @param send Sends flow control; NULL for listen-only (sender must not wait for FC)
+ * @param ctx Passed to both callbacks
+ */
+void ecu_isotp_rx_init(ecu_isotp_rx_t* rx, uint32_t rx_id, uint32_t fc_id,
+                       ecu_isotp_deliver_fn deliver, ecu_isotp_send_fn send, void* ctx);
+
+/**
+ * Feed one frame received on rx_id
+ * @param rx Channel
+ * @param data Frame payload
+ * @param len Payload bytes (8 classic, up to 64 FD)
+ * @param now_ms Millisecond timestamp
+ * @return true if the frame completed a message (already delivered)
+ */
+bool ecu_isotp_rx_frame(ecu_isotp_rx_t* rx, const uint8_t* data, uint8_t len, uint32_t now_ms);
+
+/**
+ * Drop a message whose next consecutive frame is overdue
+ * @param rx Channel
+ * @param now_ms Millisecond timestamp
+ */
+void ecu_isotp_rx_poll(ecu_isotp_rx_t* rx, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_ISOTP_H
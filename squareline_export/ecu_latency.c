@@ -0,0 +1,255 @@
+/**
+ * End-to-end latency tracing for the ECU Dashboard
+ * The trace state is one word, (sample id << 8) | last stage, advanced with
+ * compare-and-swap so the RX path and the LVGL task never block each other.
+ * Each stamp carries its sample id; stamps of an abandoned trace are ignored.
+ */
+
+#include "ecu_latency.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TRACE_IDLE          0u
+#define TRACE_ID(state)     ((state) >> 8)
+#define TRACE_STAGE(state)  ((state) & 0xFFu)
+#define TRACE_STATE(id, st) (((id) << 8) | (uint32_t)(st))
+#define TRACE_ID_MASK       0x00FFFFFFu
+
+typedef struct {
+    volatile uint32_t id;
+    volatile uint32_t us;
+} stamp_t;
+
+static volatile uint32_t trace_state = TRACE_IDLE;
+static uint32_t trace_next_id = 0;
+static stamp_t stamps[ECU_LAT_STAGE_COUNT];
+
+// Histograms, written only where ECU_LAT_FLUSH is stamped (LVGL task)
+static volatile uint32_t hist_seq = 0;
+static ecu_latency_hist_t hists[ECU_LAT_STAGE_COUNT];
+static uint64_t hist_sums[ECU_LAT_STAGE_COUNT];
+
+static const char *const stage_names[ECU_LAT_STAGE_COUNT] = {
+    [ECU_LAT_RX]        = "total",
+    [ECU_LAT_DECODE]    = "decode",
+    [ECU_LAT_PUBLISH]   = "publish",
+    [ECU_LAT_UI_UPDATE] = "ui",
+    [ECU_LAT_RENDER]    = "render",
+    [ECU_LAT_VSYNC]     = "vsync",
+    [ECU_LAT_FLUSH]     = "flush",
+};
+
+static uint8_t bucket_of(uint32_t us)
+{
+    if (us < (1u << (ECU_LATENCY_BUCKET_SHIFT + 1))) return 0;
+    int log2 = 31 - __builtin_clz(us);
+    int bucket = log2 - ECU_LATENCY_BUCKET_SHIFT;
+    return bucket >= ECU_LATENCY_BUCKETS ? ECU_LATENCY_BUCKETS - 1 : (uint8_t)bucket;
+}
+
+static void hist_add(ecu_latency_hist_t* h, uint64_t* sum, uint32_t us)
+{
+    if (h->count == 0 || us < h->min_us) h->min_us = us;
+    if (us > h->max_us) h->max_us = us;
+    h->count++;
+    *sum += us;
+    h->mean_us = (uint32_t)(*sum / h->count);
+    h->buckets[bucket_of(us)]++;
+}
+
+// Fold a completed trace into the histograms
+static void trace_complete(uint32_t id)
+{
+    uint32_t prev = stamps[ECU_LAT_RX].us;
+
+    hist_seq++;
+    __sync_synchronize();
+
+    for (int stage = ECU_LAT_DECODE; stage < ECU_LAT_STAGE_COUNT; stage++) {
+        if (stamps[stage].id != id) continue;       // Skipped stage
+        uint32_t delta = stamps[stage].us - prev;
+        if ((int32_t)delta < 0) continue;           // Lost a race with a later stage
+        hist_add(&hists[stage], &hist_sums[stage], delta);
+        prev = stamps[stage].us;
+    }
+    hist_add(&hists[ECU_LAT_TOTAL], &hist_sums[ECU_LAT_TOTAL],
+             stamps[ECU_LAT_FLUSH].us - stamps[ECU_LAT_RX].us);
+
+    __sync_synchronize();
+    hist_seq++;
+}
+
+void ecu_latency_reset(void)
+{
+    hist_seq++;
+    __sync_synchronize();
+    memset(hists, 0, sizeof(hists));
+    memset(hist_sums, 0, sizeof(hist_sums));
+    __sync_synchronize();
+    hist_seq++;
+
+    trace_state = TRACE_IDLE;
+}
+
+uint32_t ecu_latency_begin(uint32_t rx_us)
+{
+    uint32_t state = trace_state;
+
+    if (state != TRACE_IDLE) {
+        // Keep following the current sample unless it stalled (no redraw for it)
+        if (stamps[ECU_LAT_RX].id == TRACE_ID(state) &&
+            rx_us - stamps[ECU_LAT_RX].us < ECU_LATENCY_TIMEOUT_US) {
+            return 0;
+        }
+        if (!__sync_bool_compare_and_swap(&trace_state, state, TRACE_IDLE)) {
+            return 0;
+        }
+    }
+
+    uint32_t id = ++trace_next_id & TRACE_ID_MASK;
+    if (id == 0) id = ++trace_next_id & TRACE_ID_MASK;
+
+    stamps[ECU_LAT_RX].us = rx_us;
+    stamps[ECU_LAT_RX].id = id;
+    __sync_synchronize();
+
+    if (!__sync_bool_compare_and_swap(&trace_state, TRACE_IDLE, TRACE_STATE(id, ECU_LAT_RX))) {
+        return 0;
+    }
+    return id;
+}
+
+void ecu_latency_mark(ecu_latency_stage_t stage, uint32_t now_us)
+{
+    uint32_t state = trace_state;
+
+    if (state == TRACE_IDLE) return;
+
+    // Stages come in order; only VSYNC may be skipped. A redraw that started
+    // before this sample reached the UI (RENDER/FLUSH while still at DECODE
+    // or PUBLISH) does not show it and is ignored.
+    uint32_t last = TRACE_STAGE(state);
+    if ((uint32_t)stage != last + 1 &&
+        !(stage == ECU_LAT_FLUSH && last == ECU_LAT_RENDER)) {
+        return;
+    }
+
+    uint32_t id = TRACE_ID(state);
+    stamps[stage].us = now_us;
+    stamps[stage].id = id;
+    __sync_synchronize();
+
+    if (!__sync_bool_compare_and_swap(&trace_state, state, TRACE_STATE(id, stage))) return;
+
+    if (stage == ECU_LAT_FLUSH) {
+        trace_complete(id);
+        __sync_bool_compare_and_swap(&trace_state, TRACE_STATE(id, stage), TRACE_IDLE);
+    }
+}
+
+bool ecu_latency_get(ecu_latency_stage_t slot, ecu_latency_hist_t* out)
+{
+    uint32_t seq;
+
+    do {
+        seq = hist_seq;
+        __sync_synchronize();
+        *out = hists[slot];
+        __sync_synchronize();
+    } while ((seq & 1u) || seq != hist_seq);
+
+    return out->count > 0;
+}
+
+uint32_t ecu_latency_percentile_us(const ecu_latency_hist_t* hist, uint8_t percent)
+{
+    if (hist->count == 0) return 0;
+
+    uint32_t rank = (uint32_t)(((uint64_t)hist->count * percent + 99u) / 100u);
+    uint32_t seen = 0;
+
+    for (int k = 0; k < ECU_LATENCY_BUCKETS; k++) {
+        seen += hist->buckets[k];
+        if (seen >= rank) {
+            uint32_t upper = (k == ECU_LATENCY_BUCKETS - 1) ? hist->max_us
+                                                             : (1u << (k + ECU_LATENCY_BUCKET_SHIFT + 1));
+            return upper < hist->max_us ? upper : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+const char* ecu_latency_stage_name(ecu_latency_stage_t stage)
+{
+    return stage_names[stage];
+}
+
+// Append formatted text; false once the buffer is full
+static bool text_append(char* buf, size_t len, size_t* pos, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + *pos, len - *pos, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= len - *pos) return false;
+    *pos += (size_t)n;
+    return true;
+}
+
+size_t ecu_latency_format_text(char* buf, size_t len)
+{
+    size_t pos = 0;
+    ecu_latency_hist_t h;
+
+    if (len == 0) return 0;
+    buf[0] = '\0';
+
+    if (!text_append(buf, len, &pos, "stage        n      min      p50      p99      max (us)\n")) return pos;
+
+    for (int slot = 0; slot < ECU_LAT_STAGE_COUNT; slot++) {
+        if (!ecu_latency_get((ecu_latency_stage_t)slot, &h)) continue;
+        if (!text_append(buf, len, &pos, "%-8s %6lu %8lu %8lu %8lu %8lu\n", stage_names[slot],
+                         (unsigned long)h.count, (unsigned long)h.min_us,
+                         (unsigned long)ecu_latency_percentile_us(&h, 50),
+                         (unsigned long)ecu_latency_percentile_us(&h, 99),
+                         (unsigned long)h.max_us)) {
+            break;
+        }
+    }
+    return pos;
+}
+
+size_t ecu_latency_format_json(char* buf, size_t len)
+{
+    size_t pos = 0;
+    bool ok;
+    ecu_latency_hist_t h;
+
+    if (len == 0) return 0;
+
+    ok = text_append(buf, len, &pos, "{\"type\":\"latency\",\"bucket_shift\":%d,\"stages\":[",
+                     ECU_LATENCY_BUCKET_SHIFT);
+
+    for (int slot = 0; ok && slot < ECU_LAT_STAGE_COUNT; slot++) {
+        ecu_latency_get((ecu_latency_stage_t)slot, &h);
+        ok = text_append(buf, len, &pos,
+                         "%s{\"name\":\"%s\",\"n\":%lu,\"min\":%lu,\"mean\":%lu,\"p50\":%lu,\"p99\":%lu,\"max\":%lu,\"hist\":[",
+                         slot ? "," : "", stage_names[slot], (unsigned long)h.count,
+                         (unsigned long)h.min_us, (unsigned long)h.mean_us,
+                         (unsigned long)ecu_latency_percentile_us(&h, 50),
+                         (unsigned long)ecu_latency_percentile_us(&h, 99),
+                         (unsigned long)h.max_us);
+        for (int k = 0; ok && k < ECU_LATENCY_BUCKETS; k++) {
+            ok = text_append(buf, len, &pos, "%s%lu", k ? "," : "", (unsigned long)h.buckets[k]);
+        }
+        if (ok) ok = text_append(buf, len, &pos, "]}");
+    }
+
+    if (ok) ok = text_append(buf, len, &pos, "]}");
+    if (!ok) {
+        buf[0] = '\0';
+        return 0;
+    }
+    return pos;
+}
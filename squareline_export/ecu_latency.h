@@ -0,0 +1,113 @@
+/**
+ * End-to-end latency tracing for the ECU Dashboard
+ * Follows one MAP change at a time from CAN receive to the last flushed
+ * pixel and records per-stage latencies in log2 histograms
+ */
+
+#ifndef ECU_LATENCY_H
+#define ECU_LATENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Histogram bucket k counts latencies in [2^(k+SHIFT), 2^(k+SHIFT+1)) us;
+// bucket 0 also takes everything faster, the last one everything slower
+#define ECU_LATENCY_BUCKETS         16
+#define ECU_LATENCY_BUCKET_SHIFT    6          // 64 us .. 2 s
+#define ECU_LATENCY_TIMEOUT_US      1000000u   // Traces older than this are abandoned
+
+// Pipeline stages, stamped in order; only VSYNC may be skipped (SPI panels
+// lack it) and is then left out of the histograms
+typedef enum {
+    ECU_LAT_RX = 0,         // Frame taken from the TWAI driver
+    ECU_LAT_DECODE,         // Value decoded into the fixed-point snapshot
+    ECU_LAT_PUBLISH,        // Snapshot handed to the UI
+    ECU_LAT_UI_UPDATE,      // ui_update_gauges() finished (widgets invalidated)
+    ECU_LAT_RENDER,         // First flush_cb of the next refresh (first area rendered)
+    ECU_LAT_VSYNC,          // Flush released by VSYNC
+    ECU_LAT_FLUSH,          // Last area of the refresh handed to the panel
+    ECU_LAT_STAGE_COUNT
+} ecu_latency_stage_t;
+
+// Histogram slot ECU_LAT_RX holds the end-to-end latency (RX -> FLUSH);
+// every other slot holds the time from the previous stamped stage
+#define ECU_LAT_TOTAL   ECU_LAT_RX
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t mean_us;
+    uint32_t buckets[ECU_LATENCY_BUCKETS];
+} ecu_latency_hist_t;
+
+/**
+ * Clear all histograms and abandon the trace in flight
+ */
+void ecu_latency_reset(void);
+
+/**
+ * Start tracing a sample, unless one is already in flight
+ * @param rx_us Receive timestamp in microseconds
+ * @return Sample ID, 0 if the tracer was busy
+ */
+uint32_t ecu_latency_begin(uint32_t rx_us);
+
+/**
+ * Stamp a stage of the sample in flight; ignored when idle or when the
+ * stage is not the next one (VSYNC may be skipped). Stamping ECU_LAT_FLUSH
+ * completes the trace.
+ * Lock-free, may be called from the RX path and the LVGL task.
+ * @param stage Pipeline stage
+ * @param now_us Timestamp in microseconds
+ */
+void ecu_latency_mark(ecu_latency_stage_t stage, uint32_t now_us);
+
+/**
+ * Copy one histogram
+ * @param slot ECU_LAT_TOTAL or a stage > ECU_LAT_RX
+ * @param out Histogram
+ * @return false if it holds no samples
+ */
+bool ecu_latency_get(ecu_latency_stage_t slot, ecu_latency_hist_t* out);
+
+/**
+ * Estimate a percentile from a histogram (upper bound of the bucket)
+ * @param hist Histogram
+ * @param percent 1..100
+ * @return Latency in microseconds
+ */
+uint32_t ecu_latency_percentile_us(const ecu_latency_hist_t* hist, uint8_t percent);
+
+/**
+ * @param stage Pipeline stage
+ * @return Short stage name
+ */
+const char* ecu_latency_stage_name(ecu_latency_stage_t stage);
+
+/**
+ * Format all histograms as text lines (serial dump)
+ * @param buf Output buffer
+ * @param len Buffer size
+ * @return Characters written, excluding the terminator
+ */
+size_t ecu_latency_format_text(char* buf, size_t len);
+
+/**
+ * Format all histograms as a JSON object (WebSocket dump)
+ * @param buf Output buffer
+ * @param len Buffer size
+ * @return Characters written, excluding the terminator (0 if truncated)
+ */
+size_t ecu_latency_format_json(char* buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_LATENCY_H
@@ -0,0 +1,379 @@
+/**
+ * ECU/TCU traffic simulator for the ECU Dashboard
+ * Model steps and frame deadlines run in simulated time order, so the
+ * frames only depend on the seed: a host run and a device run with the
+ * same seed send the same bytes at the same simulated times.
+ */
+
+#include "ecu_sim.h"
+#include "ecu_data_structures.h"
+#include <stdio.h>
+#include <string.h>
+
+#define COMMAND_ID          0x201   // CAN_BOOST_COMMAND_ID
+#define MODE_MANUAL         0x00    // BOOST_MODE_MANUAL
+#define MODE_AUTOMATIC      0x01    // BOOST_MODE_AUTOMATIC
+#define MODE_SAFETY         0x02    // BOOST_MODE_SAFETY
+
+#define DT                  (ECU_SIM_STEP_MS / 1000.0f)
+#define IDLE_RPM            800.0f
+#define LIMITER_RPM         6800.0f
+#define UPSHIFT_RPM         6200.0f // At full load; light throttle shifts from 2500 rpm
+#define DOWNSHIFT_RPM       1300.0f
+#define ATMOSPHERE_KPA      100.0f
+#define DEFAULT_TARGET_KPA  180
+#define OVERBOOST_MARGIN    25.0f   // kPa above target counted as overboost
+#define OVERBOOST_LIMP_MS   500u    // Sustained overboost that sends the TCU to limp
+#define LIMP_THROTTLE       30.0f   // Throttle cap in limp mode, %
+
+static const float gear_ratio[7] = { 0.0f, 3.60f, 2.19f, 1.41f, 1.00f, 0.83f, 0.69f };
+
+static uint32_t next_random(ecu_sim_t* sim)
+{
+    // xorshift32
+    uint32_t x = sim->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->rng = x;
+    return x;
+}
+
+static float random_range(ecu_sim_t* sim, float lo, float hi)
+{
+    return lo + (hi - lo) * (float)(next_random(sim) % 10001u) / 10000.0f;
+}
+
+static float clampf(float v, float lo, float hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static bool reached(uint32_t now, uint32_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static uint32_t period_ms(const ecu_sim_t* sim, ecu_can_msg_id_t msg)
+{
+    uint32_t hz = (uint32_t)ecu_can_msgs[msg].rate_hz * (sim->rate_scale ? sim->rate_scale : 1u);
+    uint32_t period = 1000u / hz;
+    return period ? period : 1u;
+}
+
+void ecu_sim_init(ecu_sim_t* sim, uint32_t seed, uint32_t now_ms)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->rate_scale = 1;
+    sim->overboost_per_min = 2;
+    sim->boost_target_kpa = DEFAULT_TARGET_KPA;
+
+    sim->rng = seed ? seed : 0x2545F491u;
+    sim->now_ms = now_ms;
+    sim->next_step_ms = now_ms;
+    sim->driver_next_ms = now_ms;
+    sim->rpm = IDLE_RPM;
+    sim->gear = 1;
+    sim->map_kpa = ATMOSPHERE_KPA;
+    sim->target_kpa = ATMOSPHERE_KPA;
+    sim->wastegate = 1.0f;
+    sim->coolant_c = 20.0f;
+    sim->oil_c = 20.0f;
+    sim->tcu_c = 20.0f;
+    for (int i = 0; i < ECU_SIM_CYLINDERS; i++) {
+        sim->egt_trim_c[i] = (int16_t)random_range(sim, -25.0f, 25.0f);
+        sim->egt_c[i] = 20.0f;
+    }
+    // Stagger the first frames like independent ECUs do
+    for (int m = 0; m < ECU_MSG_COUNT; m++) {
+        sim->next_due_ms[m] = now_ms + 1u + (uint32_t)m;
+    }
+}
+
+// Driver: hold a throttle target for a few seconds, then pick another
+static void step_driver(ecu_sim_t* sim, uint32_t t)
+{
+    if (reached(t, sim->driver_next_ms)) {
+        uint32_t r = next_random(sim) % 100u;
+        if (r < 15) {
+            sim->throttle_target = 0.0f;                                // Lift
+        } else if (r < 55) {
+            sim->throttle_target = random_range(sim, 10.0f, 35.0f);    // Cruise
+        } else if (r < 85) {
+            sim->throttle_target = random_range(sim, 35.0f, 70.0f);
+        } else {
+            sim->throttle_target = random_range(sim, 85.0f, 100.0f);   // Full load pull
+        }
+        sim->driver_next_ms = t + 1000u + next_random(sim) % 4000u;
+    }
+
+    float target = sim->throttle_target;
+    if (sim->limp && target > LIMP_THROTTLE) target = LIMP_THROTTLE;
+    float slew = 150.0f * DT;                                           // %/s
+    sim->throttle += clampf(target - sim->throttle, -slew, slew);
+}
+
+static void step_engine(ecu_sim_t* sim)
+{
+    float load = sim->throttle / 100.0f;
+    float boost = clampf((sim->map_kpa - ATMOSPHERE_KPA) / 100.0f, 0.0f, 1.5f);
+    float drive = load * (0.55f + 0.45f * boost);
+    float rel = sim->rpm / LIMITER_RPM;
+    float drag = 0.12f + 0.8f * rel * rel;
+
+    // Lower gears rev faster
+    sim->rpm += (drive - drag) * 2600.0f * gear_ratio[sim->gear] / gear_ratio[1] * DT;
+    sim->rpm = clampf(sim->rpm, IDLE_RPM, LIMITER_RPM);
+
+    float upshift = 2500.0f + (UPSHIFT_RPM - 2500.0f) * load;
+    if (sim->rpm > upshift && sim->gear < 6) {
+        sim->rpm *= gear_ratio[sim->gear + 1] / gear_ratio[sim->gear];
+        sim->gear++;
+        sim->stats.shifts++;
+    } else if (sim->rpm < DOWNSHIFT_RPM && sim->gear > 1) {
+        sim->rpm = clampf(sim->rpm * gear_ratio[sim->gear - 1] / gear_ratio[sim->gear], IDLE_RPM, UPSHIFT_RPM - 200.0f);
+        sim->gear--;
+        sim->stats.shifts++;
+    }
+}
+
+// Turbo with lag and a PI wastegate controller; an overboost event sticks
+// the wastegate closed, sustained overboost puts the TCU into limp mode
+static void step_turbo(ecu_sim_t* sim, uint32_t t)
+{
+    float load = sim->throttle / 100.0f;
+    float spool = clampf((sim->rpm - 1800.0f) / 2700.0f, 0.0f, 1.0f);
+    bool stuck = !reached(t, sim->overboost_until_ms) && sim->overboost_until_ms != 0;
+
+    if (sim->safety || sim->limp) {
+        sim->target_kpa = ATMOSPHERE_KPA;
+    } else {
+        sim->target_kpa = ATMOSPHERE_KPA + (sim->boost_target_kpa - ATMOSPHERE_KPA) * clampf(load * 1.25f, 0.0f, 1.0f);
+    }
+
+    float potential = 30.0f + 70.0f * clampf(load * 2.5f, 0.0f, 1.0f) +
+                      170.0f * spool * load * (1.0f - 0.85f * sim->wastegate);
+    float tau = potential > sim->map_kpa ? 0.35f : 0.15f;              // Spool-up is slower than blow-off
+    sim->map_kpa += (potential - sim->map_kpa) * DT / tau;
+
+    float error = (sim->map_kpa - sim->target_kpa) / 100.0f;
+    sim->wg_integral = clampf(sim->wg_integral + error * 2.0f * DT, 0.0f, 1.0f);
+    float command = stuck ? 0.0f : clampf(0.8f * error + sim->wg_integral, 0.0f, 1.0f);
+    sim->wastegate += (command - sim->wastegate) * DT / 0.08f;
+
+    if (!stuck && sim->overboost_per_min && sim->map_kpa > 130.0f) {
+        // Poisson rate per step, in millionths
+        uint32_t chance = (uint32_t)sim->overboost_per_min * ECU_SIM_STEP_MS * 1000u / 60u;
+        if (next_random(sim) % 1000000u < chance) ecu_sim_trigger_overboost(sim);
+    }
+
+    if (sim->map_kpa > sim->target_kpa + OVERBOOST_MARGIN) {
+        sim->overboost_ms += ECU_SIM_STEP_MS;
+        if (sim->overboost_ms >= OVERBOOST_LIMP_MS && !sim->limp) {
+            sim->limp = true;
+            sim->limp_until_ms = t + ECU_SIM_LIMP_MS;
+            sim->stats.limp_events++;
+        }
+    } else {
+        sim->overboost_ms = 0;
+    }
+    if (sim->limp && reached(t, sim->limp_until_ms)) sim->limp = false;
+}
+
+static void step_temps(ecu_sim_t* sim)
+{
+    float load = sim->throttle / 100.0f;
+    float speed = sim->rpm / LIMITER_RPM;
+    float overboost = sim->map_kpa > sim->target_kpa + OVERBOOST_MARGIN ? 80.0f : 0.0f;
+
+    sim->coolant_c += (88.0f + 6.0f * load - sim->coolant_c) * DT / 90.0f;
+    sim->oil_c += (sim->coolant_c + 12.0f * load - sim->oil_c) * DT / 120.0f;
+    sim->tcu_c += (65.0f + 30.0f * load - sim->tcu_c) * DT / 60.0f;
+    for (int i = 0; i < ECU_SIM_CYLINDERS; i++) {
+        float target = 350.0f + 550.0f * load * (0.5f + 0.5f * speed) + sim->egt_trim_c[i] + overboost;
+        sim->egt_c[i] += (target - sim->egt_c[i]) * DT / 1.5f;
+    }
+}
+
+static void step_model(ecu_sim_t* sim, uint32_t t)
+{
+    step_driver(sim, t);
+    step_engine(sim);
+    step_turbo(sim, t);
+    step_temps(sim);
+    sim->stats.steps++;
+}
+
+static int32_t tenths(float v)
+{
+    return (int32_t)(v * 10.0f + (v >= 0.0f ? 0.5f : -0.5f));
+}
+
+// Lay out one message from the model state, with a little sensor noise
+static void encode(ecu_sim_t* sim, ecu_can_msg_id_t msg, uint8_t* data)
+{
+    float load = sim->throttle / 100.0f;
+    float map_kpa = sim->map_kpa + random_range(sim, -0.5f, 0.5f);
+    static const ecu_can_sig_id_t egt[ECU_SIM_CYLINDERS] = {
+        ECU_SIG_EGT_CYL1, ECU_SIG_EGT_CYL2, ECU_SIG_EGT_CYL3,
+        ECU_SIG_EGT_CYL4, ECU_SIG_EGT_CYL5, ECU_SIG_EGT_CYL6,
+    };
+
+    switch (msg) {
+        case ECU_MSG_BOOST_CONTROL:
+            ecu_can_sig_set_tenths(ECU_SIG_WASTEGATE_POSITION, data, tenths(sim->wastegate * 100.0f));
+            ecu_can_sig_set_tenths(ECU_SIG_TARGET_BOOST, data, tenths(sim->target_kpa));
+            ecu_can_sig_set_tenths(ECU_SIG_ACTUAL_BOOST, data, tenths(map_kpa));
+            ecu_can_sig_set_tenths(ECU_SIG_BOOST_ERROR, data,
+                                   tenths((sim->target_kpa - map_kpa) / sim->target_kpa * 100.0f));
+            ecu_can_sig_set_tenths(ECU_SIG_WASTEGATE_DUTY, data, tenths(sim->wastegate * 100.0f));
+            break;
+        case ECU_MSG_ENGINE:
+            ecu_can_sig_set_tenths(ECU_SIG_ENGINE_RPM, data, tenths(sim->rpm + random_range(sim, -5.0f, 5.0f)));
+            ecu_can_sig_set_tenths(ECU_SIG_MAP_PRESSURE, data, tenths(map_kpa));
+            ecu_can_sig_set_tenths(ECU_SIG_TPS_POSITION, data, tenths(sim->throttle));
+            ecu_can_sig_set_tenths(ECU_SIG_ENGINE_TEMP, data, tenths(sim->coolant_c));
+            ecu_can_sig_set_tenths(ECU_SIG_FUEL_PRESSURE, data, tenths(300.0f + map_kpa - ATMOSPHERE_KPA));
+            break;
+        case ECU_MSG_ENGINE_TEMPS:
+            ecu_can_sig_set(ECU_SIG_TEMP_PAGE, data, sim->temp_page);
+            if (sim->temp_page == 0) {
+                ecu_can_sig_set_tenths(ECU_SIG_COOLANT_TEMP, data, tenths(sim->coolant_c));
+                ecu_can_sig_set_tenths(ECU_SIG_OIL_TEMP, data, tenths(sim->oil_c));
+            } else {
+                int first = (sim->temp_page - 1) * 3;
+                for (int i = first; i < first + 3; i++) {
+                    ecu_can_sig_set_tenths(egt[i], data, tenths(sim->egt_c[i] + random_range(sim, -3.0f, 3.0f)));
+                }
+            }
+            sim->temp_page = (uint8_t)((sim->temp_page + 1) % ECU_SIM_TEMP_PAGES);
+            break;
+        case ECU_MSG_TCU: {
+            float boost = clampf((sim->map_kpa - ATMOSPHERE_KPA) / 100.0f, 0.0f, 1.5f);
+            float torque = clampf(load * (0.55f + 0.45f * boost), 0.0f, 1.0f) * ECU_TORQUE_FULL_SCALE_NM;
+            // Protection: bit 0 overheat, bit 1 overspeed, bit 3 clutch slip at full torque
+            int32_t protection = (sim->tcu_c > 110.0f ? 0x1 : 0) | (sim->rpm > 6500.0f ? 0x2 : 0) |
+                                 (torque > 0.96f * ECU_TORQUE_FULL_SCALE_NM ? 0x8 : 0);
+            ecu_can_sig_set_tenths(ECU_SIG_TORQUE_REQUEST, data, tenths(torque));
+            ecu_can_sig_set(ECU_SIG_TCU_PROTECTION, data, protection);
+            ecu_can_sig_set(ECU_SIG_TCU_LIMP, data, sim->limp ? 1 : 0);
+            ecu_can_sig_set(ECU_SIG_GEAR, data, sim->gear);
+            ecu_can_sig_set_tenths(ECU_SIG_CLUTCH_PRESSURE, data, tenths(8.0f + 10.0f * load));
+            ecu_can_sig_set_tenths(ECU_SIG_TCU_TEMP, data, tenths(sim->tcu_c));
+            ecu_can_sig_set(ECU_SIG_SHIFT_STRATEGY, data, sim->limp ? 0 : (load > 0.8f ? 2 : 1));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static bool send_message(ecu_sim_t* sim, const ecu_can_bus_t* bus, ecu_can_msg_id_t msg)
+{
+    ecu_can_frame_t frame;
+    uint32_t rng = sim->rng;
+    uint8_t page = sim->temp_page;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.id = ecu_can_msgs[msg].can_id;
+    frame.len = ecu_can_msgs[msg].dlc;
+    frame.flags = frame.len > ECU_CAN_CLASSIC_MAX_LEN ? ECU_CAN_FRAME_FD : 0;
+    encode(sim, msg, frame.data);
+
+    if (!ecu_can_bus_send(bus, &frame, 0)) {
+        // Encoded again on the next run, identically
+        sim->rng = rng;
+        sim->temp_page = page;
+        sim->stats.deferred++;
+        return false;
+    }
+    sim->stats.frames++;
+    return true;
+}
+
+uint16_t ecu_sim_run(ecu_sim_t* sim, const ecu_can_bus_t* bus, uint32_t now_ms)
+{
+    uint16_t sent = 0;
+    uint32_t gap = now_ms - sim->now_ms;
+
+    // After a long stall skip ahead instead of replaying a burst of stale traffic
+    if ((int32_t)gap > (int32_t)ECU_SIM_MAX_CATCH_UP_MS) {
+        uint32_t skip = gap - ECU_SIM_MAX_CATCH_UP_MS;
+        sim->next_step_ms += skip;
+        sim->driver_next_ms += skip;
+        if (sim->overboost_until_ms) sim->overboost_until_ms += skip;
+        if (sim->limp) sim->limp_until_ms += skip;
+        for (int m = 0; m < ECU_MSG_COUNT; m++) {
+            sim->next_due_ms[m] += skip;
+        }
+        sim->stats.skipped_ms += skip;
+    }
+
+    for (;;) {
+        // Earliest frame deadline; a model step at the same time runs first
+        int due = -1;
+        for (int m = 0; m < ECU_MSG_COUNT; m++) {
+            if (ecu_can_msgs[m].rate_hz == 0) continue;
+            if (due < 0 || (int32_t)(sim->next_due_ms[m] - sim->next_due_ms[due]) < 0) due = m;
+        }
+
+        if (reached(now_ms, sim->next_step_ms) &&
+            (due < 0 || !reached(sim->next_step_ms, sim->next_due_ms[due] + 1u))) {
+            step_model(sim, sim->next_step_ms);
+            sim->next_step_ms += ECU_SIM_STEP_MS;
+        } else if (due >= 0 && reached(now_ms, sim->next_due_ms[due])) {
+            if (!send_message(sim, bus, (ecu_can_msg_id_t)due)) {
+                // Bus full: stop just before this frame, the consumer catches up
+                sim->now_ms = sim->next_due_ms[due] - 1u;
+                return sent;
+            }
+            sim->next_due_ms[due] += period_ms(sim, (ecu_can_msg_id_t)due);
+            sent++;
+        } else {
+            break;
+        }
+    }
+    sim->now_ms = now_ms;
+    return sent;
+}
+
+void ecu_sim_receive(ecu_sim_t* sim, const ecu_can_frame_t* frame)
+{
+    if (frame->id != COMMAND_ID || frame->len < 4) return;
+
+    uint8_t mode = frame->data[0];
+    uint16_t target = (uint16_t)((frame->data[2] | (frame->data[3] << 8)) / 10);
+
+    sim->safety = mode == MODE_SAFETY;
+    if (mode == MODE_MANUAL && target >= ATMOSPHERE_KPA) {
+        sim->boost_target_kpa = target;
+    } else if (mode == MODE_AUTOMATIC) {
+        sim->boost_target_kpa = DEFAULT_TARGET_KPA;
+    }
+}
+
+void ecu_sim_trigger_overboost(ecu_sim_t* sim)
+{
+    sim->overboost_until_ms = sim->next_step_ms + ECU_SIM_OVERBOOST_MS;
+    if (sim->overboost_until_ms == 0) sim->overboost_until_ms = 1;
+    sim->stats.overboost_events++;
+}
+
+size_t ecu_sim_format_text(const ecu_sim_t* sim, char* buf, size_t len)
+{
+    if (len == 0) return 0;
+
+    int n = snprintf(buf, len,
+                     "SIM rpm %u gear %u thr %u%%  map %u/%u kPa wg %u%%%s  frames %lu deferred %lu"
+                     "  overboost %lu limp %lu shifts %lu",
+                     (unsigned)sim->rpm, sim->gear, (unsigned)sim->throttle,
+                     (unsigned)sim->map_kpa, (unsigned)sim->target_kpa, (unsigned)(sim->wastegate * 100.0f),
+                     sim->limp ? " LIMP" : "", (unsigned long)sim->stats.frames, (unsigned long)sim->stats.deferred,
+                     (unsigned long)sim->stats.overboost_events, (unsigned long)sim->stats.limp_events,
+                     (unsigned long)sim->stats.shifts);
+    if (n < 0) {
+        buf[0] = '\0';
+        return 0;
+    }
+    return (size_t)n < len ? (size_t)n : len - 1;
+}
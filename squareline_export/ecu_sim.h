@@ -0,0 +1,122 @@
+/**
+ * ECU/TCU traffic simulator for the ECU Dashboard
+ * A small seeded engine, turbo and gearbox model sends real frames, laid
+ * out by ecu_can_spec.h at the documented rates, into a CAN bus. Reading
+ * that bus with can_bus_poll() exercises the same RX path and decoders as
+ * the vehicle. Output depends only on the seed and the time stepped to,
+ * not on how often ecu_sim_run() is called or how fast it is drained.
+ */
+
+#ifndef ECU_SIM_H
+#define ECU_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ecu_can_spec.h"
+#include "ecu_can_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECU_SIM_STEP_MS             5u      // Model time step
+#define ECU_SIM_MAX_CATCH_UP_MS     1000u   // Longer gaps are skipped, not replayed
+#define ECU_SIM_OVERBOOST_MS        1500u   // Wastegate stuck closed this long per event
+#define ECU_SIM_LIMP_MS             10000u  // Limp mode duration
+#define ECU_SIM_TEMP_PAGES          3       // 0x381 pages: temperatures, EGT 1-3, EGT 4-6
+#define ECU_SIM_CYLINDERS           6
+
+typedef struct {
+    uint32_t frames;             // Sent on the bus
+    uint32_t deferred;           // Refused by the bus (queue full), retried on the next run
+    uint32_t steps;              // Model steps run
+    uint32_t overboost_events;
+    uint32_t limp_events;
+    uint32_t shifts;
+    uint32_t skipped_ms;         // Time dropped by the catch-up limit
+} ecu_sim_stats_t;
+
+typedef struct {
+    // Configuration, may be changed after init
+    uint8_t rate_scale;          // Multiplies every message rate (load tests), 1 = documented rates
+    uint16_t overboost_per_min;  // Random overboost events per minute under boost, 0 = none
+    uint16_t boost_target_kpa;   // Commanded target (absolute), changed by 0x201 commands
+
+    // Model state
+    uint32_t rng;
+    uint32_t now_ms;             // Simulated time reached
+    uint32_t next_step_ms;
+    uint32_t next_due_ms[ECU_MSG_COUNT];
+    uint32_t driver_next_ms;     // Next throttle target change
+    float throttle_target;       // %
+    float throttle;              // %
+    float rpm;
+    uint8_t gear;                // 1-6
+    float map_kpa;
+    float target_kpa;
+    float wastegate;             // 0 closed - 1 open
+    float wg_integral;
+    float coolant_c;
+    float oil_c;
+    float tcu_c;
+    float egt_c[ECU_SIM_CYLINDERS];
+    int16_t egt_trim_c[ECU_SIM_CYLINDERS];  // Seeded per-cylinder spread
+    uint32_t overboost_until_ms; // Wastegate stuck closed until then
+    uint32_t overboost_ms;       // Time spent above the overboost limit, current event
+    uint32_t limp_until_ms;
+    bool limp;
+    bool safety;                 // BOOST_MODE_SAFETY received
+    uint8_t temp_page;
+
+    ecu_sim_stats_t stats;
+} ecu_sim_t;
+
+/**
+ * Start a simulation
+ * @param sim State
+ * @param seed Any value; equal seeds give identical traffic
+ * @param now_ms Timestamp the simulation starts at
+ */
+void ecu_sim_init(ecu_sim_t* sim, uint32_t seed, uint32_t now_ms);
+
+/**
+ * Advance the model to now_ms and send every frame due up to then. If
+ * the bus is full the simulation stops just before the refused frame and
+ * continues from there on the next call: frames are delayed, never lost,
+ * and the traffic stays identical.
+ * @param sim State
+ * @param bus Transport the frames are sent on (never waits)
+ * @param now_ms Millisecond timestamp
+ * @return Frames sent
+ */
+uint16_t ecu_sim_run(ecu_sim_t* sim, const ecu_can_bus_t* bus, uint32_t now_ms);
+
+/**
+ * Feed a frame the dashboard sent; boost commands (0x201) move the target
+ * and BOOST_MODE_SAFETY drops boost to atmospheric
+ * @param sim State
+ * @param frame Frame
+ */
+void ecu_sim_receive(ecu_sim_t* sim, const ecu_can_frame_t* frame);
+
+/**
+ * Stick the wastegate closed now (bench test of the overboost handling)
+ * @param sim State
+ */
+void ecu_sim_trigger_overboost(ecu_sim_t* sim);
+
+/**
+ * Format the model state and statistics as one text line
+ * @param sim State
+ * @param buf Output buffer
+ * @param len Buffer size
+ * @return Characters written, excluding the terminator
+ */
+size_t ecu_sim_format_text(const ecu_sim_t* sim, char* buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_SIM_H
@@ -0,0 +1,160 @@
+/**
+ * Per-channel statistics for the ECU Dashboard
+ * Each channel is a small sequence-locked record: the decode path is the
+ * only writer, readers copy the record and retry if it changed underneath
+ */
+
+#include "ecu_stats.h"
+#include <string.h>
+
+// Gaps longer than this (bus loss, stale data) are not counted as time above threshold
+#define ECU_STATS_MAX_GAP_MS    500
+
+typedef struct {
+    volatile uint32_t seq;            // Odd while the writer is updating
+    volatile uint32_t reset_request;  // Bumped by readers
+    uint32_t reset_done;              // Last reset_request served by the writer
+    uint32_t count;
+    int32_t min;                      // 0.1 units
+    int32_t max;                      // 0.1 units
+    int32_t origin;                   // First sample, 0.1 units; sums are taken around it
+    int64_t sum;                      // Sum of (sample - origin), 0.1 units
+    int64_t sum_sq;                   // Sum of (sample - origin)^2, 0.01 units
+    int32_t threshold;                // 0.1 units, INT32_MAX when disabled
+    uint32_t time_above_ms;
+    uint32_t last_ms;
+    bool above;
+} channel_state_t;
+
+static channel_state_t channel_states[ECU_CH_COUNT];
+
+// Defaults match the gauge warning thresholds
+static const float default_thresholds[ECU_CH_COUNT] = {
+    [ECU_CH_MAP_PRESSURE]       = 230.0f,
+    [ECU_CH_WASTEGATE_POSITION] = GAUGE_THRESHOLD_NONE,
+    [ECU_CH_TPS_POSITION]       = GAUGE_THRESHOLD_NONE,
+    [ECU_CH_ENGINE_RPM]         = 6000.0f,
+    [ECU_CH_TARGET_BOOST]       = GAUGE_THRESHOLD_NONE,
+    [ECU_CH_TORQUE_REQUEST]     = GAUGE_THRESHOLD_NONE,
+};
+
+// Threshold in engineering units to 0.1 units
+static int32_t threshold_to_tenths(float threshold)
+{
+    if (threshold >= (float)(INT32_MAX / 10)) return INT32_MAX;
+    return (int32_t)(threshold * 10.0f + (threshold >= 0.0f ? 0.5f : -0.5f));
+}
+
+static void clear_channel(channel_state_t* st)
+{
+    st->count = 0;
+    st->min = 0;
+    st->max = 0;
+    st->origin = 0;
+    st->sum = 0;
+    st->sum_sq = 0;
+    st->time_above_ms = 0;
+    st->above = false;
+}
+
+void ecu_stats_init(void)
+{
+    memset(channel_states, 0, sizeof(channel_states));
+    for (int ch = 0; ch < ECU_CH_COUNT; ch++) {
+        channel_states[ch].threshold = threshold_to_tenths(default_thresholds[ch]);
+    }
+}
+
+void ecu_stats_update(ecu_channel_t channel, int32_t tenths, uint32_t now_ms)
+{
+    channel_state_t* st = &channel_states[channel];
+
+    st->seq++;
+    __sync_synchronize();
+
+    if (st->reset_request != st->reset_done) {
+        st->reset_done = st->reset_request;
+        clear_channel(st);
+    }
+
+    if (st->count == 0) {
+        st->min = tenths;
+        st->max = tenths;
+        st->origin = tenths;
+    } else {
+        if (tenths < st->min) st->min = tenths;
+        if (tenths > st->max) st->max = tenths;
+
+        // The interval since the previous sample belongs to the previous state
+        uint32_t dt = now_ms - st->last_ms;
+        if (st->above && dt <= ECU_STATS_MAX_GAP_MS) {
+            st->time_above_ms += dt;
+        }
+    }
+
+    // Integer sums only; ecu_stats_pull() turns them into mean and variance.
+    // Shifting by the first sample keeps sum_sq small and the variance exact.
+    int64_t delta = (int64_t)tenths - st->origin;
+    st->count++;
+    st->sum += delta;
+    st->sum_sq += delta * delta;
+
+    st->above = (tenths > st->threshold);
+    st->last_ms = now_ms;
+
+    __sync_synchronize();
+    st->seq++;
+}
+
+void ecu_stats_set_threshold(ecu_channel_t channel, float threshold)
+{
+    channel_states[channel].threshold = threshold_to_tenths(threshold);
+}
+
+bool ecu_stats_pull(ecu_channel_t channel, ecu_channel_stats_t* out, bool reset)
+{
+    channel_state_t* st = &channel_states[channel];
+    uint32_t seq;
+    bool reset_pending;
+    int32_t origin;
+    int64_t sum;
+    int64_t sum_sq;
+
+    do {
+        seq = st->seq;
+        __sync_synchronize();
+        out->min = (float)st->min * 0.1f;
+        out->max = (float)st->max * 0.1f;
+        origin = st->origin;
+        sum = st->sum;
+        sum_sq = st->sum_sq;
+        out->threshold = (st->threshold == INT32_MAX) ? GAUGE_THRESHOLD_NONE : (float)st->threshold * 0.1f;
+        out->count = st->count;
+        out->time_above_ms = st->time_above_ms;
+        reset_pending = (st->reset_request != st->reset_done);
+        __sync_synchronize();
+    } while ((seq & 1u) || seq != st->seq);
+
+    if (out->count > 0) {
+        double n = (double)out->count;
+        double mean = (double)sum / n;
+        out->mean = (float)(((double)origin + mean) * 0.1);
+        out->variance = (out->count > 1) ? (float)(((double)sum_sq - (double)sum * mean) * 0.01 / (n - 1.0)) : 0.0f;
+    } else {
+        out->mean = 0.0f;
+        out->variance = 0.0f;
+    }
+
+    // A reset the writer has not served yet means the record is logically empty
+    if (reset_pending) {
+        float threshold = out->threshold;
+        memset(out, 0, sizeof(*out));
+        out->threshold = threshold;
+    }
+
+    if (reset) {
+        st->reset_request++;
+    }
+
+    return out->count > 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * Per-channel statistics for the ECU Dashboard
+ * Peak hold, min/max, time above threshold and mean/variance, updated in
+ * O(1) integer arithmetic from the CAN decode path and read lazily by the UI
+ */
+
+#ifndef ECU_STATS_H
+#define ECU_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ecu_data_structures.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Snapshot of one channel's statistics
+typedef struct {
+    float min;                   // Minimum since reset
+    float max;                   // Maximum (peak hold) since reset
+    float mean;                  // Running mean
+    float variance;              // Sample variance (0 with fewer than 2 samples)
+    float threshold;             // Threshold used for time_above_ms
+    uint32_t count;              // Samples since reset
+    uint32_t time_above_ms;      // Time spent above threshold since reset
+} ecu_channel_stats_t;
+
+/**
+ * Clear all channels and load the default thresholds
+ */
+void ecu_stats_init(void);
+
+/**
+ * Add one sample; call from the decode path for every decoded channel.
+ * Single writer: only one context may call this.
+ * @param channel ECU channel
+ * @param tenths Value in 0.1 engineering units (ecu_fx_get_tenths)
+ * @param now_ms Sample timestamp in milliseconds
+ */
+void ecu_stats_update(ecu_channel_t channel, int32_t tenths, uint32_t now_ms);
+
+/**
+ * Set the threshold used for time-above accounting
+ * @param channel ECU channel
+ * @param threshold Threshold in engineering units (GAUGE_THRESHOLD_NONE disables)
+ */
+void ecu_stats_set_threshold(ecu_channel_t channel, float threshold);
+
+/**
+ * Read a consistent snapshot of one channel, optionally restarting it.
+ * The reset is carried out by the writer on its next sample, so the
+ * reader never races the decode path.
+ * @param channel ECU channel
+ * @param out Snapshot
+ * @param reset Restart statistics after this read
+ * @return false if no sample was recorded since the last reset
+ */
+bool ecu_stats_pull(ecu_channel_t channel, ecu_channel_stats_t* out, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_STATS_H
@@ -0,0 +1,424 @@
+/**
+ * Binary serial telemetry for the ECU Dashboard
+ * Records are sealed (seq, CRC) and COBS encoded outside the lock, then
+ * copied into a byte ring with their 0x00 delimiter. The ring never holds a
+ * partial record, so the background task hands whole records to the link
+ * with one write call.
+ */
+
+#include "ecu_telemetry.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static portMUX_TYPE tlm_mux = portMUX_INITIALIZER_UNLOCKED;
+#define TLM_LOCK()      portENTER_CRITICAL(&tlm_mux)
+#define TLM_UNLOCK()    portEXIT_CRITICAL(&tlm_mux)
+#else
+static volatile int tlm_spin = 0;
+#define TLM_LOCK()      while (__sync_lock_test_and_set(&tlm_spin, 1)) {}
+#define TLM_UNLOCK()    __sync_lock_release(&tlm_spin)
+#endif
+
+#define TLM_RING_MASK   (ECU_TLM_RING_SIZE - 1u)
+#define TLM_PUSH_TRIES  4               // Re-encodes when another producer took the seq first
+
+static uint8_t ring[ECU_TLM_RING_SIZE];
+static uint32_t head = 0;                    // Next write
+static uint32_t tail = 0;                    // Next read
+static uint8_t next_seq = 0;
+static uint32_t dropped_pending = 0;         // Reported by the next DROPPED record
+static volatile ecu_tlm_level_t level = ECU_TLM_LEVEL_OFF;
+static ecu_tlm_stats_t stats;
+
+#if defined(ESP_PLATFORM)
+static TaskHandle_t tlm_task = NULL;
+#endif
+
+// CRC-16/CCITT-FALSE, a nibble at a time: the table stays small
+static const uint16_t crc_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+static uint16_t crc16(const uint8_t* p, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (len--) {
+        crc = (uint16_t)((crc << 4) ^ crc_nibble[(crc >> 12) ^ (*p >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc_nibble[(crc >> 12) ^ (*p++ & 0x0F)]);
+    }
+    return crc;
+}
+
+// COBS: no 0x00 in the output, at most one extra byte per 254
+static size_t cobs_encode(const uint8_t* in, size_t len, uint8_t* out)
+{
+    size_t code_pos = 0;
+    size_t o = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code_pos] = code;
+            code_pos = o++;
+            code = 1;
+            continue;
+        }
+        out[o++] = in[i];
+        if (++code == 0xFF) {
+            out[code_pos] = code;
+            code_pos = o++;
+            code = 1;
+        }
+    }
+    out[code_pos] = code;
+    return o;
+}
+
+static bool cobs_decode(const uint8_t* in, size_t len, uint8_t* out, size_t out_len, size_t* decoded)
+{
+    size_t o = 0;
+    size_t i = 0;
+
+    while (i < len) {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > len) return false;
+        for (uint8_t k = 1; k < code; k++) {
+            if (o >= out_len) return false;
+            out[o++] = in[i++];
+        }
+        if (code != 0xFF && i < len) {
+            if (o >= out_len) return false;
+            out[o++] = 0;
+        }
+    }
+    *decoded = o;
+    return true;
+}
+
+static void put16(uint8_t* p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t v)
+{
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* p)
+{
+    return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+// Seal and encode a record whose payload is in raw[2..2+len); returns the ring bytes
+static size_t encode(uint8_t* raw, size_t len, uint8_t seq, uint8_t* out)
+{
+    raw[1] = seq;
+    put16(raw + 2 + len, crc16(raw, 2 + len));
+    size_t n = cobs_encode(raw, 2 + len + 2, out);
+    out[n++] = 0;
+    return n;
+}
+
+static void ring_copy_in(const uint8_t* p, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        ring[(head + i) & TLM_RING_MASK] = p[i];
+    }
+    head += (uint32_t)len;
+}
+
+// Append one record; a DROPPED record goes first once there is room again.
+// The seq is part of the CRC and the COBS output, so the records are
+// encoded outside the lock for the seq seen at the start and only copied in
+// if no other producer appended meanwhile; otherwise they are encoded again.
+static bool push(uint8_t* raw, size_t len)
+{
+    uint8_t enc[ECU_TLM_MAX_ENCODED];
+    uint8_t drop_raw[2 + 4 + 2];
+    uint8_t drop_enc[sizeof(drop_raw) + 2];
+    bool was_empty = false;
+    bool ok = false;
+    bool committed = false;
+
+    for (int tries = 0; tries < TLM_PUSH_TRIES && !committed; tries++) {
+        TLM_LOCK();
+        uint8_t base = next_seq;
+        uint32_t appended = stats.records;  // Catches a seq that wrapped all the way round
+        uint32_t pending = dropped_pending;
+        TLM_UNLOCK();
+
+        uint8_t seq = base;
+        size_t dn = 0;
+        if (pending) {
+            drop_raw[0] = ECU_TLM_REC_DROPPED;
+            put32(drop_raw + 2, pending);
+            dn = encode(drop_raw, 4, seq++, drop_enc);
+        }
+        size_t n = encode(raw, len, seq, enc);
+
+        TLM_LOCK();
+        if (next_seq != base || stats.records != appended || dropped_pending != pending) {
+            TLM_UNLOCK();
+            continue;
+        }
+        committed = true;
+        was_empty = head == tail;
+        uint32_t space = ECU_TLM_RING_SIZE - (head - tail);
+        // The DROPPED record only goes in together with the record, so a full
+        // ring does not fill up with drop counts of one
+        if (dn && dn + n <= space) {
+            ring_copy_in(drop_enc, dn);
+            space -= (uint32_t)dn;
+            next_seq++;
+            stats.records++;
+            stats.bytes += (uint32_t)dn;
+            dropped_pending = 0;
+        }
+        if (dropped_pending == 0 && n <= space) {
+            ring_copy_in(enc, n);
+            next_seq++;
+            stats.records++;
+            stats.bytes += (uint32_t)n;
+            if (head - tail > stats.max_used) stats.max_used = (uint16_t)(head - tail);
+            ok = true;
+        } else {
+            dropped_pending++;
+            stats.dropped++;
+        }
+        TLM_UNLOCK();
+    }
+    if (!committed) {
+        // Another producer took the seq on every try
+        TLM_LOCK();
+        dropped_pending++;
+        stats.dropped++;
+        TLM_UNLOCK();
+    }
+
+#if defined(ESP_PLATFORM)
+    if (ok && was_empty && tlm_task) xTaskNotifyGive(tlm_task);
+#else
+    (void)was_empty;
+#endif
+    return ok;
+}
+
+void ecu_tlm_init(ecu_tlm_level_t new_level)
+{
+    TLM_LOCK();
+    head = tail = 0;
+    next_seq = 0;
+    dropped_pending = 0;
+    memset(&stats, 0, sizeof(stats));
+    level = new_level;
+    TLM_UNLOCK();
+}
+
+void ecu_tlm_set_level(ecu_tlm_level_t new_level)
+{
+    if (new_level < ECU_TLM_LEVEL_COUNT) level = new_level;
+}
+
+ecu_tlm_level_t ecu_tlm_get_level(void)
+{
+    return level;
+}
+
+bool ecu_tlm_frame(const ecu_can_frame_t* frame, uint32_t rx_us)
+{
+    uint8_t raw[ECU_TLM_FRAME_RECORD];
+    uint8_t len = frame->len > ECU_CAN_FD_MAX_LEN ? ECU_CAN_FD_MAX_LEN : frame->len;
+
+    if (level < ECU_TLM_LEVEL_FRAMES) return false;
+
+    raw[0] = ECU_TLM_REC_FRAME;
+    put32(raw + 2, rx_us);
+    put32(raw + 6, frame->id);
+    raw[10] = frame->flags;
+    raw[11] = len;
+    memcpy(raw + 12, frame->data, len);
+    return push(raw, 10u + len);
+}
+
+bool ecu_tlm_snapshot(const ecu_data_fx_t* data, uint32_t stale_channels, uint32_t time_ms)
+{
+    uint8_t raw[2 + 16 + 2];
+
+    if (level < ECU_TLM_LEVEL_SNAPSHOT) return false;
+
+    raw[0] = ECU_TLM_REC_SNAPSHOT;
+    put32(raw + 2, time_ms);
+    put16(raw + 6, data->map_pressure);
+    put16(raw + 8, data->target_boost);
+    put16(raw + 10, data->engine_rpm);
+    put16(raw + 12, data->torque_request);
+    raw[14] = data->wastegate_position;
+    raw[15] = data->tps_position;
+    raw[16] = data->flags;
+    raw[17] = (uint8_t)stale_channels;
+    return push(raw, 16);
+}
+
+bool ecu_tlm_text(const char* text)
+{
+    uint8_t raw[ECU_TLM_TEXT_RECORD];
+    size_t len = strlen(text);
+
+    if (level < ECU_TLM_LEVEL_TEXT) return false;
+
+    if (len > ECU_TLM_TEXT_MAX) len = ECU_TLM_TEXT_MAX;
+    raw[0] = ECU_TLM_REC_TEXT;
+    memcpy(raw + 2, text, len);
+    return push(raw, len);
+}
+
+size_t ecu_tlm_read(uint8_t* buf, size_t len)
+{
+    size_t n = 0;
+
+    if (len < 2) return 0;
+
+    TLM_LOCK();
+    uint32_t avail = head - tail;
+    size_t take = avail < len - 1 ? avail : len - 1;
+    size_t whole = 0;
+    for (size_t i = 0; i < take; i++) {
+        uint8_t b = ring[(tail + i) & TLM_RING_MASK];
+        buf[1 + i] = b;
+        if (b == 0) whole = i + 1;
+    }
+    tail += (uint32_t)whole;
+    stats.written += (uint32_t)(whole ? whole + 1 : 0);
+    TLM_UNLOCK();
+
+    if (whole) {
+        buf[0] = 0;
+        n = whole + 1;
+    }
+    return n;
+}
+
+void ecu_tlm_get_stats(ecu_tlm_stats_t* out)
+{
+    TLM_LOCK();
+    *out = stats;
+    TLM_UNLOCK();
+}
+
+size_t ecu_tlm_format_text(const ecu_tlm_stats_t* s, char* buf, size_t len)
+{
+    if (len == 0) return 0;
+
+    int n = snprintf(buf, len,
+                     "Telemetry level %u  records %lu dropped %lu  bytes %lu written %lu  ring max %u/%u",
+                     (unsigned)level, (unsigned long)s->records, (unsigned long)s->dropped,
+                     (unsigned long)s->bytes, (unsigned long)s->written,
+                     (unsigned)s->max_used, (unsigned)ECU_TLM_RING_SIZE);
+    if (n < 0) {
+        buf[0] = '\0';
+        return 0;
+    }
+    return (size_t)n < len ? (size_t)n : len - 1;
+}
+
+bool ecu_tlm_decode(const uint8_t* in, size_t len, ecu_tlm_record_t* out)
+{
+    uint8_t raw[ECU_TLM_MAX_RECORD];
+    size_t n;
+
+    if (!cobs_decode(in, len, raw, sizeof(raw), &n) || n < 4) return false;
+    if (get16(raw + n - 2) != crc16(raw, n - 2)) return false;
+
+    const uint8_t* p = raw + 2;
+    size_t plen = n - 4;
+    out->type = raw[0];
+    out->seq = raw[1];
+
+    switch (raw[0]) {
+        case ECU_TLM_REC_FRAME:
+            if (plen < 10 || p[9] > ECU_CAN_FD_MAX_LEN || plen != 10u + p[9]) return false;
+            out->u.frame.rx_us = get32(p);
+            out->u.frame.frame.id = get32(p + 4);
+            out->u.frame.frame.flags = p[8];
+            out->u.frame.frame.len = p[9];
+            memcpy(out->u.frame.frame.data, p + 10, p[9]);
+            return true;
+        case ECU_TLM_REC_SNAPSHOT:
+            if (plen != 16) return false;
+            memset(&out->u.snapshot, 0, sizeof(out->u.snapshot));
+            out->u.snapshot.time_ms = get32(p);
+            out->u.snapshot.data.timestamp = get32(p);
+            out->u.snapshot.data.map_pressure = get16(p + 4);
+            out->u.snapshot.data.target_boost = get16(p + 6);
+            out->u.snapshot.data.engine_rpm = get16(p + 8);
+            out->u.snapshot.data.torque_request = get16(p + 10);
+            out->u.snapshot.data.wastegate_position = p[12];
+            out->u.snapshot.data.tps_position = p[13];
+            out->u.snapshot.data.flags = p[14];
+            out->u.snapshot.stale = p[15];
+            return true;
+        case ECU_TLM_REC_TEXT:
+            if (plen > ECU_TLM_TEXT_MAX) return false;
+            memcpy(out->u.text, p, plen);
+            out->u.text[plen] = '\0';
+            return true;
+        case ECU_TLM_REC_DROPPED:
+            if (plen != 4) return false;
+            out->u.dropped = get32(p);
+            return true;
+        default:
+            return false;
+    }
+}
+
+#if defined(ESP_PLATFORM)
+
+#define TLM_TASK_STACK      2560
+#define TLM_TASK_PRIORITY   1           // Below everything the dashboard needs
+#define TLM_TASK_IDLE_MS    100u
+
+static ecu_tlm_write_fn tlm_write = NULL;
+static void* tlm_write_ctx = NULL;
+
+static void tlm_task_fn(void* arg)
+{
+    static uint8_t chunk[ECU_TLM_WRITE_CHUNK];
+    (void)arg;
+
+    for (;;) {
+        size_t n = ecu_tlm_read(chunk, sizeof(chunk));
+        if (n == 0) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TLM_TASK_IDLE_MS));
+            continue;
+        }
+        tlm_write(chunk, n, tlm_write_ctx);
+    }
+}
+
+esp_err_t ecu_tlm_start(ecu_tlm_write_fn write, void* ctx)
+{
+    tlm_write = write;
+    tlm_write_ctx = ctx;
+    if (tlm_task) return ESP_OK;
+
+    if (xTaskCreate(tlm_task_fn, "tlm", TLM_TASK_STACK, NULL, TLM_TASK_PRIORITY, &tlm_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+#endif // ESP_PLATFORM
@@ -0,0 +1,184 @@
+/**
+ * Binary serial telemetry for the ECU Dashboard
+ * Producers (CAN task, UI task) append compact records to a ring buffer
+ * without waiting; a background task writes whole records to the UART, so
+ * a slow link drops records instead of stalling the dashboard. Records are
+ * COBS framed with a CRC-16 and delimited by 0x00, which lets a decoder
+ * resynchronise and skip plain-text Serial output written between them.
+ *
+ * Record before COBS (little-endian):
+ *   type u8, seq u8, payload, crc u16 (CRC-16/CCITT-FALSE over type..payload)
+ *   FRAME     rx_us u32, id u32, flags u8 (ECU_CAN_FRAME_*), len u8, data[len]
+ *   SNAPSHOT  time_ms u32, map u16, target u16 (0.1 kPa), rpm u16, torque u16 (Nm),
+ *             wastegate u8, tps u8 (%), flags u8 (ECU_FX_FLAG_*), stale u8 (1 << ECU_CH_*)
+ *   TEXT      characters, not terminated
+ *   DROPPED   count u32 (records the ring had no room for)
+ * seq counts records that made it into the ring; a gap seen by the decoder
+ * means bytes were lost on the link.
+ */
+
+#ifndef ECU_TELEMETRY_H
+#define ECU_TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ecu_can_frame.h"
+#include "ecu_data_structures.h"
+
+#if defined(ESP_PLATFORM)
+#include "esp_err.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECU_TLM_RING_SIZE       4096    // Encoded bytes buffered (power of two)
+#define ECU_TLM_TEXT_MAX        120     // Longest TEXT payload
+#define ECU_TLM_FRAME_RECORD    (2 + 10 + ECU_CAN_FD_MAX_LEN + 2)   // FRAME with 64 data bytes
+#define ECU_TLM_TEXT_RECORD     (2 + ECU_TLM_TEXT_MAX + 2)          // TEXT of ECU_TLM_TEXT_MAX
+#define ECU_TLM_MAX_RECORD      (ECU_TLM_FRAME_RECORD > ECU_TLM_TEXT_RECORD ? \
+                                 ECU_TLM_FRAME_RECORD : ECU_TLM_TEXT_RECORD)
+#define ECU_TLM_MAX_ENCODED     (ECU_TLM_MAX_RECORD + 2)            // COBS overhead (< 254 bytes) + delimiter
+#define ECU_TLM_WRITE_CHUNK     256     // Bytes per write call of the background task
+
+// Verbosity: each level includes the ones below it
+typedef enum {
+    ECU_TLM_LEVEL_OFF = 0,       // Nothing; Serial carries only the text reports
+    ECU_TLM_LEVEL_TEXT,          // Text records (events, reports)
+    ECU_TLM_LEVEL_SNAPSHOT,      // Decoded values at the UI update rate
+    ECU_TLM_LEVEL_FRAMES,        // Every received CAN frame
+    ECU_TLM_LEVEL_COUNT
+} ecu_tlm_level_t;
+
+typedef enum {
+    ECU_TLM_REC_FRAME = 1,
+    ECU_TLM_REC_SNAPSHOT = 2,
+    ECU_TLM_REC_TEXT = 3,
+    ECU_TLM_REC_DROPPED = 4,
+} ecu_tlm_type_t;
+
+typedef struct {
+    uint32_t records;            // Appended to the ring
+    uint32_t dropped;            // No room in the ring
+    uint32_t bytes;              // Encoded bytes appended
+    uint32_t written;            // Bytes handed to the link
+    uint16_t max_used;           // Ring high-water mark, bytes
+} ecu_tlm_stats_t;
+
+// A decoded record (host tools)
+typedef struct {
+    uint8_t type;                // ECU_TLM_REC_*
+    uint8_t seq;
+    union {
+        struct {
+            uint32_t rx_us;
+            ecu_can_frame_t frame;
+        } frame;
+        struct {
+            uint32_t time_ms;
+            ecu_data_fx_t data;
+            uint32_t stale;
+        } snapshot;
+        char text[ECU_TLM_TEXT_MAX + 1];    // NUL-terminated
+        uint32_t dropped;
+    } u;
+} ecu_tlm_record_t;
+
+/**
+ * Empty the ring, reset the statistics and set the verbosity
+ * @param level ECU_TLM_LEVEL_*
+ */
+void ecu_tlm_init(ecu_tlm_level_t level);
+
+/**
+ * Change the verbosity at runtime
+ * @param level ECU_TLM_LEVEL_*
+ */
+void ecu_tlm_set_level(ecu_tlm_level_t level);
+
+/**
+ * @return Current verbosity
+ */
+ecu_tlm_level_t ecu_tlm_get_level(void);
+
+/**
+ * Record a received CAN frame (ECU_TLM_LEVEL_FRAMES). Never blocks.
+ * @param frame Frame
+ * @param rx_us Receive timestamp in microseconds
+ * @return false if the level is lower or the ring is full
+ */
+bool ecu_tlm_frame(const ecu_can_frame_t* frame, uint32_t rx_us);
+
+/**
+ * Record the decoded values (ECU_TLM_LEVEL_SNAPSHOT). Never blocks.
+ * @param data Fixed-point snapshot
+ * @param stale_channels (1 << ECU_CH_*) bits of values that stopped updating
+ * @param time_ms Millisecond timestamp
+ * @return false if the level is lower or the ring is full
+ */
+bool ecu_tlm_snapshot(const ecu_data_fx_t* data, uint32_t stale_channels, uint32_t time_ms);
+
+/**
+ * Record a text line (ECU_TLM_LEVEL_TEXT), cut to ECU_TLM_TEXT_MAX. Never blocks.
+ * @param text NUL-terminated text
+ * @return false if the level is lower or the ring is full
+ */
+bool ecu_tlm_text(const char* text);
+
+/**
+ * Take whole encoded records out of the ring, preceded by a 0x00 delimiter
+ * @param buf Output buffer, at least ECU_TLM_MAX_ENCODED + 1 bytes
+ * @param len Buffer size
+ * @return Bytes to write to the link, 0 if the ring is empty
+ */
+size_t ecu_tlm_read(uint8_t* buf, size_t len);
+
+/**
+ * Read a consistent statistics snapshot
+ * @param out Statistics
+ */
+void ecu_tlm_get_stats(ecu_tlm_stats_t* out);
+
+/**
+ * Format the statistics as one text line
+ * @param stats Statistics snapshot
+ * @param buf Output buffer
+ * @param len Buffer size
+ * @return Characters written, excluding the terminator
+ */
+size_t ecu_tlm_format_text(const ecu_tlm_stats_t* stats, char* buf, size_t len);
+
+/**
+ * Decode one COBS frame (the bytes between two 0x00 delimiters)
+ * @param in Encoded bytes, without delimiters
+ * @param len Encoded length
+ * @param out Decoded record
+ * @return false if COBS, CRC, type or length are invalid
+ */
+bool ecu_tlm_decode(const uint8_t* in, size_t len, ecu_tlm_record_t* out);
+
+#if defined(ESP_PLATFORM)
+/**
+ * Write function of the background task, e.g. a wrapper of Serial.write()
+ * @param data Whole records
+ * @param len Bytes
+ * @param ctx Context passed to ecu_tlm_start()
+ */
+typedef void (*ecu_tlm_write_fn)(const uint8_t* data, size_t len, void* ctx);
+
+/**
+ * Start the background task that drains the ring into write
+ * @param write Link write function; may block, only this task waits on it
+ * @param ctx Passed to write
+ * @return ESP_OK, ESP_ERR_NO_MEM if the task could not be created
+ */
+esp_err_t ecu_tlm_start(ecu_tlm_write_fn write, void* ctx);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_TELEMETRY_H
@@ -0,0 +1,383 @@
+/**
+ * Headless host build of the ECU Dashboard telemetry pipeline
+ * CAN frames from SocketCAN (vcan0 fed by cangen, or a real adapter) or
+ * from the ecu_sim model go through can_bus_poll() - filter, decoders,
+ * staleness, bus statistics - and out to WebSocket clients on /ws with the
+ * same JSON contract as esp_idf_s3_working/main/can_websocket.c. Every
+ * second it reports sustained frames/s and broadcast latency percentiles.
+ *
+ * Build (from squareline_export/, host/ first so its lvgl.h is used):
+ *   cc -std=gnu99 -O2 -I host -I . -o ecu_host host/ecu_host.c host/ecu_ws_server.c \
+ *      ecu_can_integration.c ecu_can_bus.c ecu_can_spec.c ecu_can_filter.c \
+ *      ecu_can_supervisor.c ecu_can_tx.c ecu_isotp.c ecu_sim.c ecu_history.c \
+ *      ecu_stats.c ecu_bus_stats.c ecu_latency.c ecu_decimate.c -lm
+ *
+ * Run:
+ *   ./ecu_host                      simulator, seed 1, port 8080
+ *   ./ecu_host -r 20 -t 60          simulator at 20x the documented rates for 60 s
+ *   ./ecu_host -i vcan0             SocketCAN (ip link add vcan0 type vcan; cangen vcan0 -g 0.1)
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ecu_can_integration.h"
+#include "ecu_can_supervisor.h"
+#include "ecu_bus_stats.h"
+#include "ecu_latency.h"
+#include "ecu_ws_server.h"
+
+#define HOST_DEFAULT_PORT       8080
+#define HOST_WS_PATH            "/ws"
+#define HOST_POLL_BATCH         256     // Frames decoded per can_bus_poll() call
+#define HOST_REPORT_MS          1000u   // Report and periodic diagnostics interval
+#define HOST_SAMPLES            65536   // Latency samples per report interval
+#define HOST_RUN_SAMPLES        (1 << 20)   // Reservoir for the whole-run percentiles
+#define HOST_DATA_BUF_LEN       320
+#define HOST_DIAG_BUF_LEN       2048
+
+// Same field order as ECU_CH_*
+static const char* const field_names[] = {
+    "map_pressure", "wastegate_pos", "tps_position", "engine_rpm", "target_boost", "tcu_status"
+};
+
+typedef struct {
+    const char* name;
+    size_t (*format)(char* buf, size_t len);
+    bool periodic;
+} host_diag_source_t;
+
+static size_t host_stats_json(char* buf, size_t len);
+
+// Sources a client can request by name; periodic ones are broadcast every report
+static const host_diag_source_t diag_sources[] = {
+    { "bus", ecu_bus_stats_json, true },
+    { "latency", ecu_latency_format_json, false },
+    { "host", host_stats_json, true },
+};
+
+static ecu_ws_server_t ws;
+static volatile sig_atomic_t stop_requested = 0;
+
+static uint32_t interval_samples[HOST_SAMPLES];
+static uint32_t interval_count = 0;
+static uint32_t run_samples[HOST_RUN_SAMPLES];
+static uint64_t run_count = 0;
+static uint32_t run_rng = 0x9E3779B9u;
+
+static uint64_t total_frames = 0;
+static uint64_t total_broadcasts = 0;
+static uint32_t interval_frames = 0;
+static uint32_t interval_broadcasts = 0;
+static uint32_t last_frames_per_sec = 0;
+static uint32_t last_p99_us = 0;
+
+uint32_t lv_tick_get(void)
+{
+    return ecu_can_supervisor_now_ms();
+}
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+static int compare_u32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Percentile of a sorted array (nearest rank)
+static uint32_t percentile(const uint32_t* sorted, size_t count, uint8_t percent)
+{
+    if (count == 0) return 0;
+    size_t rank = (count * percent + 99) / 100;
+    return sorted[rank ? rank - 1 : 0];
+}
+
+static void record_latency(uint32_t us)
+{
+    if (interval_count < HOST_SAMPLES) interval_samples[interval_count++] = us;
+
+    // Reservoir sampling keeps the run percentiles unbiased past the array size
+    run_count++;
+    if (run_count <= HOST_RUN_SAMPLES) {
+        run_samples[run_count - 1] = us;
+        return;
+    }
+    run_rng ^= run_rng << 13;
+    run_rng ^= run_rng >> 17;
+    run_rng ^= run_rng << 5;
+    uint64_t slot = ((uint64_t)run_rng << 32 | (run_rng ^ 0x5bd1e995u)) % run_count;
+    if (slot < HOST_RUN_SAMPLES) run_samples[slot] = us;
+}
+
+static size_t host_stats_json(char* buf, size_t len)
+{
+    int n = snprintf(buf, len,
+                     "{\"frames_per_sec\":%u,\"frames\":%llu,\"broadcasts\":%llu,\"p99_us\":%u,"
+                     "\"clients\":%u,\"connections\":%u,\"disconnects\":%u,\"rejected\":%u,"
+                     "\"slow_clients\":%u,\"messages_in\":%u,\"frames_out\":%llu,\"bytes_out\":%llu}",
+                     last_frames_per_sec, (unsigned long long)total_frames,
+                     (unsigned long long)total_broadcasts, last_p99_us, ecu_ws_server_clients(&ws),
+                     ws.stats.connections, ws.stats.disconnects, ws.stats.rejected,
+                     ws.stats.slow_clients, ws.stats.messages_in,
+                     (unsigned long long)ws.stats.frames_out, (unsigned long long)ws.stats.bytes_out);
+    if (n < 0) {
+        buf[0] = '\0';
+        return 0;
+    }
+    return (size_t)n < len ? (size_t)n : len - 1;
+}
+
+// can_websocket.c fields plus a "stale" array; stale bits map 1:1 onto ECU_CH_*
+static size_t format_data(char* buf, size_t len)
+{
+    const ecu_data_fx_t* fx = ecu_get_current_data_fx();
+    uint32_t stale = ecu_stale_channels();
+    int tcu_status = (fx->flags & ECU_FX_FLAG_TCU_LIMP) ? 2 : (fx->flags & ECU_FX_FLAG_TCU_PROTECTION) ? 1 : 0;
+    int n = snprintf(buf, len,
+                     "{\"map_pressure\":%d,\"wastegate_pos\":%d,\"tps_position\":%d,"
+                     "\"engine_rpm\":%d,\"target_boost\":%d,\"tcu_status\":%d,\"stale\":[",
+                     (fx->map_pressure + 5) / 10, fx->wastegate_position, fx->tps_position,
+                     fx->engine_rpm, (fx->target_boost + 5) / 10, tcu_status);
+    size_t pos = (n > 0 && (size_t)n < len) ? (size_t)n : 0;
+    bool first = true;
+
+    for (size_t i = 0; pos && i < sizeof(field_names) / sizeof(field_names[0]); i++) {
+        if (!(stale & (1u << i))) continue;
+        n = snprintf(buf + pos, len - pos, "%s\"%s\"", first ? "" : ",", field_names[i]);
+        pos = (n > 0 && (size_t)n < len - pos) ? pos + n : 0;
+        first = false;
+    }
+    if (pos) {
+        n = snprintf(buf + pos, len - pos, "]}");
+        pos = (n > 0 && (size_t)n < len - pos) ? pos + n : 0;
+    }
+    if (!pos && len) buf[0] = '\0';
+    return pos;
+}
+
+// A source name gets that diagnostics object, anything else the current data
+static void on_message(ecu_ws_server_t* srv, int client, const char* text, size_t len, void* ctx)
+{
+    static char buf[HOST_DIAG_BUF_LEN];
+    (void)len;
+    (void)ctx;
+
+    for (size_t i = 0; i < sizeof(diag_sources) / sizeof(diag_sources[0]); i++) {
+        if (strcmp(diag_sources[i].name, text) == 0) {
+            size_t n = diag_sources[i].format(buf, sizeof(buf));
+            if (n) ecu_ws_server_send(srv, client, buf, n);
+            return;
+        }
+    }
+    size_t n = format_data(buf, sizeof(buf));
+    if (n) ecu_ws_server_send(srv, client, buf, n);
+}
+
+// Decode what the bus holds and broadcast the result. The latency sample
+// runs from the start of the batch (frames ready) until the frame is
+// queued for every client.
+static uint16_t pump(const ecu_can_bus_t* bus, uint32_t batch_start_us)
+{
+    char buf[HOST_DATA_BUF_LEN];
+    uint16_t frames = 0;
+    uint16_t n;
+
+    do {
+        n = can_bus_poll(bus, HOST_POLL_BATCH);
+        frames += n;
+    } while (n == HOST_POLL_BATCH);
+    can_interface_task();
+    if (frames == 0) return 0;
+
+    total_frames += frames;
+    interval_frames += frames;
+
+    size_t len = format_data(buf, sizeof(buf));
+    if (len && ecu_ws_server_broadcast(&ws, buf, len)) {
+        record_latency(ecu_bus_stats_now_us() - batch_start_us);
+        total_broadcasts++;
+        interval_broadcasts++;
+    }
+    return frames;
+}
+
+static void report(uint32_t elapsed_ms, bool quiet)
+{
+    static char buf[HOST_DIAG_BUF_LEN];
+
+    qsort(interval_samples, interval_count, sizeof(uint32_t), compare_u32);
+    last_frames_per_sec = (uint32_t)((uint64_t)interval_frames * 1000u / (elapsed_ms ? elapsed_ms : 1));
+    last_p99_us = percentile(interval_samples, interval_count, 99);
+
+    if (!quiet) {
+        printf("frames/s %6u  broadcasts/s %6u  clients %3u  latency us p50 %5u p90 %5u p99 %5u max %6u\n",
+               last_frames_per_sec,
+               (uint32_t)((uint64_t)interval_broadcasts * 1000u / (elapsed_ms ? elapsed_ms : 1)),
+               ecu_ws_server_clients(&ws),
+               percentile(interval_samples, interval_count, 50),
+               percentile(interval_samples, interval_count, 90), last_p99_us,
+               interval_count ? interval_samples[interval_count - 1] : 0);
+        fflush(stdout);
+    }
+    interval_count = 0;
+    interval_frames = 0;
+    interval_broadcasts = 0;
+
+    for (size_t i = 0; i < sizeof(diag_sources) / sizeof(diag_sources[0]); i++) {
+        if (!diag_sources[i].periodic) continue;
+        size_t n = diag_sources[i].format(buf, sizeof(buf));
+        if (n) ecu_ws_server_broadcast(&ws, buf, n);
+    }
+}
+
+static void summary(uint32_t elapsed_ms)
+{
+    size_t count = run_count < HOST_RUN_SAMPLES ? (size_t)run_count : HOST_RUN_SAMPLES;
+
+    qsort(run_samples, count, sizeof(uint32_t), compare_u32);
+    printf("\n%llu frames in %u.%03u s: %llu frames/s sustained, %llu broadcasts\n",
+           (unsigned long long)total_frames, elapsed_ms / 1000, elapsed_ms % 1000,
+           (unsigned long long)(total_frames * 1000u / (elapsed_ms ? elapsed_ms : 1)),
+           (unsigned long long)total_broadcasts);
+    printf("broadcast latency us: p50 %u p90 %u p99 %u p99.9 %u max %u\n",
+           percentile(run_samples, count, 50), percentile(run_samples, count, 90),
+           percentile(run_samples, count, 99),
+           count ? run_samples[count - 1 - (count - 1) / 1000] : 0,
+           count ? run_samples[count - 1] : 0);
+    printf("websocket: %u connections, %u disconnects, %u rejected, %u slow clients, %llu frames out, %llu bytes out\n",
+           ws.stats.connections, ws.stats.disconnects, ws.stats.rejected, ws.stats.slow_clients,
+           (unsigned long long)ws.stats.frames_out, (unsigned long long)ws.stats.bytes_out);
+}
+
+// Simulator mode: boost commands go back to the model, as in simulate_can_data()
+static bool sim_command_send(void* ctx, const ecu_can_frame_t* frame, uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+    ecu_sim_receive((ecu_sim_t*)ctx, frame);
+    return true;
+}
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [-i IFACE] [-f] [-s SEED] [-r SCALE] [-p PORT] [-t SECONDS] [-q]\n"
+            "  -i IFACE   read SocketCAN IFACE (vcan0, can0) instead of the simulator\n"
+            "  -f         CAN FD frames on IFACE\n"
+            "  -s SEED    simulator seed (default %u)\n"
+            "  -r SCALE   simulator message rate multiplier, 1-255 (default 1)\n"
+            "  -p PORT    WebSocket port (default %u)\n"
+            "  -t SECONDS stop after this long (default: until Ctrl-C)\n"
+            "  -q         no per-second report, summary only\n",
+            prog, ECU_SIM_SEED, HOST_DEFAULT_PORT);
+}
+
+int main(int argc, char** argv)
+{
+    const char* ifname = NULL;
+    bool fd_frames = false;
+    uint32_t seed = ECU_SIM_SEED;
+    unsigned long rate_scale = 1;
+    unsigned long port = HOST_DEFAULT_PORT;
+    unsigned long duration_s = 0;
+    bool quiet = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:fs:r:p:t:qh")) != -1) {
+        switch (opt) {
+            case 'i': ifname = optarg; break;
+            case 'f': fd_frames = true; break;
+            case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': rate_scale = strtoul(optarg, NULL, 0); break;
+            case 'p': port = strtoul(optarg, NULL, 0); break;
+            case 't': duration_s = strtoul(optarg, NULL, 0); break;
+            case 'q': quiet = true; break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (rate_scale < 1 || rate_scale > 255 || port < 1 || port > 65535) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    can_interface_init();
+
+    static ecu_sim_t sim;
+    static ecu_can_standin_t standin;
+    static ecu_can_socketcan_t sc = { .fd = -1 };
+    ecu_can_bus_t bus;
+    ecu_can_bus_t command_bus = {
+        .send = sim_command_send,
+        .receive = NULL,
+        .max_len = ECU_CAN_CLASSIC_MAX_LEN,
+        .name = "sim",
+        .ctx = &sim,
+    };
+
+    if (ifname) {
+        if (!ecu_can_socketcan_open(&bus, &sc, ifname, fd_frames)) {
+            fprintf(stderr, "%s: %s\n", ifname, strerror(errno));
+            return 1;
+        }
+        can_set_tx_bus(&bus);
+    } else {
+        ecu_can_standin_init(&bus, &standin, false);
+        ecu_sim_init(&sim, seed, lv_tick_get());
+        sim.rate_scale = (uint8_t)rate_scale;
+        can_set_tx_bus(&command_bus);
+    }
+
+    if (!ecu_ws_server_start(&ws, (uint16_t)port, HOST_WS_PATH, on_message, NULL)) {
+        fprintf(stderr, "port %lu: %s\n", port, strerror(errno));
+        return 1;
+    }
+    printf("%s -> ws://0.0.0.0:%lu%s\n", ifname ? ifname : "simulator", port, HOST_WS_PATH);
+
+    uint32_t start_ms = lv_tick_get();
+    uint32_t report_ms = start_ms;
+
+    while (!stop_requested) {
+        uint32_t now = lv_tick_get();
+
+        if (ifname) {
+            // Wake on CAN traffic or WebSocket activity
+            if (ecu_ws_server_poll(&ws, sc.fd, 10)) pump(&bus, ecu_bus_stats_now_us());
+        } else {
+            ecu_ws_server_poll(&ws, -1, 1);
+            now = lv_tick_get();
+            // The stand-in bus holds ECU_CAN_STANDIN_DEPTH frames; the model waits while it is drained
+            uint16_t sent;
+            do {
+                uint32_t batch_start_us = ecu_bus_stats_now_us();
+                sent = ecu_sim_run(&sim, &bus, now);
+                pump(&bus, batch_start_us);
+            } while (sent && sim.now_ms != now);
+        }
+
+        now = lv_tick_get();
+        if (now - report_ms >= HOST_REPORT_MS) {
+            report(now - report_ms, quiet);
+            report_ms = now;
+        }
+        if (duration_s && now - start_ms >= duration_s * 1000u) break;
+    }
+
+    summary(lv_tick_get() - start_ms);
+    ecu_ws_server_stop(&ws);
+    if (ifname) ecu_can_socketcan_close(&sc);
+    return 0;
+}
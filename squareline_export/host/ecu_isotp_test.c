@@ -0,0 +1,292 @@
+/**
+ * Host test for the ISO-TP receiver (ecu_isotp.h) and the DTC channel
+ * Reassembly: the documented 0x3A0 example, a full 256-byte message with
+ * sequence-number wrap and block-size flow control, the CAN FD escapes,
+ * sequence errors, overflow and N_Cr expiry. End to end: DTC frames go
+ * through can_frame_handler(), flow control comes back on the tx bus, the
+ * list is read with ecu_get_dtcs(), and can_interface_task() alone expires
+ * a message whose consecutive frames stopped.
+ * Throughput: 256-byte reassemblies per second, printed, not gated.
+ * Exits non-zero on any failure.
+ *
+ * Build and run (from squareline_export/, host/ first so its lvgl.h is used):
+ *   cc -std=gnu99 -O2 -I host -I . -o ecu_isotp_test host/ecu_isotp_test.c \
+ *      ecu_can_integration.c ecu_can_bus.c ecu_can_spec.c ecu_can_filter.c \
+ *      ecu_can_supervisor.c ecu_can_tx.c ecu_isotp.c ecu_sim.c ecu_history.c \
+ *      ecu_stats.c ecu_bus_stats.c ecu_latency.c ecu_decimate.c -lm && ./ecu_isotp_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "ecu_can_bus.h"
+#include "ecu_can_integration.h"
+#include "ecu_isotp.h"
+
+#define THROUGHPUT_MESSAGES     200000
+
+static uint32_t test_now_ms = 1000;
+static int failures = 0;
+
+// Simulated tick for the decode path
+uint32_t lv_tick_get(void)
+{
+    return test_now_ms;
+}
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { printf("FAIL %s:%d: ", __func__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+    } while (0)
+
+// Capture of the last delivered message and flow control frame
+typedef struct {
+    uint8_t data[ECU_ISOTP_MAX_PAYLOAD];
+    uint16_t len;
+    uint32_t delivered;
+    uint8_t fc[8];
+    uint8_t fc_len;
+    uint32_t fc_id;
+    uint32_t fc_count;
+} capture_t;
+
+static void capture_deliver(void* ctx, const uint8_t* data, uint16_t len)
+{
+    capture_t* cap = (capture_t*)ctx;
+    memcpy(cap->data, data, len);
+    cap->len = len;
+    cap->delivered++;
+}
+
+static bool capture_send(void* ctx, uint32_t can_id, const uint8_t* data, uint8_t len)
+{
+    capture_t* cap = (capture_t*)ctx;
+    memcpy(cap->fc, data, len);
+    cap->fc_len = len;
+    cap->fc_id = can_id;
+    cap->fc_count++;
+    return true;
+}
+
+static void setup(ecu_isotp_rx_t* rx, capture_t* cap)
+{
+    memset(cap, 0, sizeof(*cap));
+    ecu_isotp_rx_init(rx, 0x3A0, 0x3A1, capture_deliver, capture_send, cap);
+}
+
+// Send a payload as FF + CFs with classic 8-byte frames; returns frames fed
+static int feed_segmented(ecu_isotp_rx_t* rx, const uint8_t* payload, uint16_t len, uint32_t now_ms)
+{
+    uint8_t frame[8];
+    uint16_t sent = 6;
+    uint8_t sn = 1;
+    int frames = 1;
+
+    frame[0] = (uint8_t)(0x10 | (len >> 8));
+    frame[1] = (uint8_t)len;
+    memcpy(frame + 2, payload, 6);
+    ecu_isotp_rx_frame(rx, frame, 8, now_ms);
+
+    while (sent < len) {
+        uint16_t take = (uint16_t)(len - sent > 7 ? 7 : len - sent);
+        memset(frame, 0xCC, sizeof(frame));
+        frame[0] = (uint8_t)(0x20 | sn);
+        memcpy(frame + 1, payload + sent, take);
+        ecu_isotp_rx_frame(rx, frame, 8, now_ms);
+        sent = (uint16_t)(sent + take);
+        sn = (uint8_t)((sn + 1) & 0x0F);
+        frames++;
+    }
+    return frames;
+}
+
+// CAN_PROTOCOL_SPECIFICATION.md section 5: three DTCs in FF + one CF
+static void test_document_example(void)
+{
+    static const uint8_t ff[8] = { 0x10, 0x0A, 0x03, 0x03, 0x01, 0x08, 0x43, 0x00 };
+    static const uint8_t cf[8] = { 0x21, 0x09, 0xC1, 0x23, 0x2F, 0xCC, 0xCC, 0xCC };
+    static const uint8_t fc[8] = { 0x30, 0x00, 0x00, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC };
+    static const uint8_t payload[10] = { 0x03, 0x03, 0x01, 0x08, 0x43, 0x00, 0x09, 0xC1, 0x23, 0x2F };
+    ecu_isotp_rx_t rx;
+    capture_t cap;
+
+    setup(&rx, &cap);
+    CHECK(!ecu_isotp_rx_frame(&rx, ff, 8, 0), "first frame completed a message");
+    CHECK(cap.fc_count == 1 && cap.fc_id == 0x3A1 && cap.fc_len == 8 && memcmp(cap.fc, fc, 8) == 0,
+          "flow control %u frames, id 0x%03lX", (unsigned)cap.fc_count, (unsigned long)cap.fc_id);
+    CHECK(ecu_isotp_rx_frame(&rx, cf, 8, 5), "consecutive frame did not complete the message");
+    CHECK(cap.delivered == 1 && cap.len == sizeof(payload) && memcmp(cap.data, payload, sizeof(payload)) == 0,
+          "delivered %u messages, %u bytes", (unsigned)cap.delivered, cap.len);
+}
+
+// 256 bytes: 36 CFs, SN wraps 15 -> 0 twice, BS 4 asks for a new FC every 4 CFs
+static void test_max_payload_block_size(void)
+{
+    uint8_t payload[ECU_ISOTP_MAX_PAYLOAD];
+    ecu_isotp_rx_t rx;
+    capture_t cap;
+
+    for (int i = 0; i < ECU_ISOTP_MAX_PAYLOAD; i++) payload[i] = (uint8_t)(i * 7 + 3);
+    setup(&rx, &cap);
+    rx.block_size = 4;
+    int frames = feed_segmented(&rx, payload, ECU_ISOTP_MAX_PAYLOAD, 0);
+
+    CHECK(frames == 37, "%d frames for 256 bytes", frames);
+    CHECK(cap.delivered == 1 && cap.len == ECU_ISOTP_MAX_PAYLOAD && memcmp(cap.data, payload, sizeof(payload)) == 0,
+          "256-byte message not reassembled");
+    // FC after the FF and after CF 4, 8, ... 32 (the 36th completes the message)
+    CHECK(cap.fc_count == 9, "%u flow control frames, expected 9", (unsigned)cap.fc_count);
+    CHECK(cap.fc[1] == 4, "BS %u advertised", cap.fc[1]);
+    CHECK(rx.stats.sequence_errors == 0, "%u sequence errors", (unsigned)rx.stats.sequence_errors);
+}
+
+// FD single frame (length in byte 1) and FF_DL 32-bit escape
+static void test_fd_escapes(void)
+{
+    uint8_t sf[64];
+    uint8_t ff[64];
+    ecu_isotp_rx_t rx;
+    capture_t cap;
+
+    setup(&rx, &cap);
+    memset(sf, 0xAA, sizeof(sf));
+    sf[0] = 0x00;
+    sf[1] = 40;
+    CHECK(ecu_isotp_rx_frame(&rx, sf, 64, 0), "FD single frame not delivered");
+    CHECK(cap.len == 40 && cap.data[39] == 0xAA, "FD single frame %u bytes", cap.len);
+
+    // 100 bytes announced through the escape: 58 in the FF, 42 in one FD CF
+    memset(ff, 0x55, sizeof(ff));
+    ff[0] = 0x10; ff[1] = 0x00; ff[2] = 0; ff[3] = 0; ff[4] = 0; ff[5] = 100;
+    CHECK(!ecu_isotp_rx_frame(&rx, ff, 64, 0), "escaped first frame completed a message");
+    memset(sf, 0x55, sizeof(sf));
+    sf[0] = 0x21;
+    CHECK(ecu_isotp_rx_frame(&rx, sf, 48, 1), "FD consecutive frame did not complete the message");
+    CHECK(cap.delivered == 2 && cap.len == 100, "escaped message %u bytes", cap.len);
+}
+
+// Wrong SN drops the message, longer than the buffer answers FS overflow
+static void test_errors(void)
+{
+    static const uint8_t ff[8] = { 0x10, 0x14, 1, 2, 3, 4, 5, 6 };
+    static const uint8_t cf_bad[8] = { 0x22, 7, 8, 9, 10, 11, 12, 13 };
+    static const uint8_t ff_big[8] = { 0x11, 0x2C, 0, 0, 0, 0, 0, 0 };    // 300 bytes
+    ecu_isotp_rx_t rx;
+    capture_t cap;
+
+    setup(&rx, &cap);
+    ecu_isotp_rx_frame(&rx, ff, 8, 0);
+    CHECK(!ecu_isotp_rx_frame(&rx, cf_bad, 8, 1), "out-of-sequence CF completed a message");
+    CHECK(rx.stats.sequence_errors == 1 && !rx.receiving, "sequence error not counted");
+
+    ecu_isotp_rx_frame(&rx, ff_big, 8, 2);
+    CHECK(rx.stats.overflows == 1 && (cap.fc[0] & 0x0F) == ECU_ISOTP_FS_OVERFLOW, "overflow FC not sent");
+    CHECK(cap.delivered == 0, "%u messages delivered", (unsigned)cap.delivered);
+}
+
+// N_Cr: a message whose CFs stop is dropped by the poll alone
+static void test_timeout_poll(void)
+{
+    static const uint8_t ff[8] = { 0x10, 0x14, 1, 2, 3, 4, 5, 6 };
+    ecu_isotp_rx_t rx;
+    capture_t cap;
+
+    setup(&rx, &cap);
+    ecu_isotp_rx_frame(&rx, ff, 8, 100);
+    ecu_isotp_rx_poll(&rx, 100 + ECU_ISOTP_TIMEOUT_CR_MS);
+    CHECK(rx.receiving, "expired at exactly N_Cr");
+    ecu_isotp_rx_poll(&rx, 100 + ECU_ISOTP_TIMEOUT_CR_MS + 1);
+    CHECK(!rx.receiving && rx.stats.timeouts == 1, "not expired after N_Cr");
+}
+
+static void send_dtc_frame(const uint8_t* data)
+{
+    ecu_can_frame_t frame;
+    ecu_can_frame_set(&frame, CAN_DTC_ID, data, 8, 0);
+    can_frame_handler(&frame);
+}
+
+// Through the decoder table: FC on the tx bus, list via ecu_get_dtcs(),
+// N_Cr noticed by can_interface_task() with no further frames
+static void test_dtc_channel(void)
+{
+    static const uint8_t ff[8] = { 0x10, 0x0A, 0x03, 0x03, 0x01, 0x08, 0x43, 0x00 };
+    static const uint8_t cf[8] = { 0x21, 0x09, 0xC1, 0x23, 0x2F, 0xCC, 0xCC, 0xCC };
+    ecu_can_bus_t bus;
+    ecu_can_standin_t standin;
+    ecu_can_frame_t fc;
+    ecu_dtc_t dtcs[4];
+    char code[6];
+
+    can_interface_init();
+    ecu_can_standin_init(&bus, &standin, false);
+    can_set_tx_bus(&bus);
+
+    send_dtc_frame(ff);
+    CHECK(ecu_can_bus_receive(&bus, &fc, 0) && fc.id == CAN_DTC_FC_ID && fc.data[0] == 0x30,
+          "no flow control on 0x%03X", CAN_DTC_FC_ID);
+    send_dtc_frame(cf);
+    size_t count = ecu_get_dtcs(dtcs, 4);
+    CHECK(count == 3, "%u DTCs", (unsigned)count);
+    ecu_dtc_format(dtcs[0].code, code);
+    CHECK(strcmp(code, "P0301") == 0 && dtcs[0].status == 0x08, "first DTC %s/%02X", code, dtcs[0].status);
+    ecu_dtc_format(dtcs[2].code, code);
+    CHECK(strcmp(code, "U0123") == 0 && dtcs[2].status == 0x2F, "last DTC %s/%02X", code, dtcs[2].status);
+
+    // Second list stalls after its first frame; the bus goes silent
+    uint32_t timeouts = can_get_isotp_stats()->timeouts;
+    send_dtc_frame(ff);
+    test_now_ms += ECU_ISOTP_TIMEOUT_CR_MS + 1;
+    can_interface_task();
+    CHECK(can_get_isotp_stats()->timeouts == timeouts + 1, "N_Cr not noticed on a silent bus");
+    CHECK(ecu_get_dtcs(dtcs, 4) == 3, "stalled message replaced the list");
+
+    can_set_tx_bus(NULL);
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Reassembly cost of full-size messages, flow control included
+static void test_throughput(void)
+{
+    uint8_t payload[ECU_ISOTP_MAX_PAYLOAD];
+    ecu_isotp_rx_t rx;
+    capture_t cap;
+    long frames = 0;
+
+    for (int i = 0; i < ECU_ISOTP_MAX_PAYLOAD; i++) payload[i] = (uint8_t)i;
+    setup(&rx, &cap);
+
+    double start = now_sec();
+    for (uint32_t i = 0; i < THROUGHPUT_MESSAGES; i++) {
+        frames += feed_segmented(&rx, payload, ECU_ISOTP_MAX_PAYLOAD, i);
+    }
+    double elapsed = now_sec() - start;
+
+    CHECK(cap.delivered == THROUGHPUT_MESSAGES, "%u of %u messages delivered", (unsigned)cap.delivered,
+          (unsigned)THROUGHPUT_MESSAGES);
+    if (elapsed > 0) {
+        printf("throughput: %.0f messages/s, %.1f Mframes/s, %.0f MB/s (256-byte payload)\n",
+               THROUGHPUT_MESSAGES / elapsed, frames / elapsed / 1e6,
+               THROUGHPUT_MESSAGES * (double)ECU_ISOTP_MAX_PAYLOAD / elapsed / 1e6);
+    }
+}
+
+int main(void)
+{
+    test_document_example();
+    test_max_payload_block_size();
+    test_fd_escapes();
+    test_errors();
+    test_timeout_poll();
+    test_dtc_channel();
+    test_throughput();
+
+    printf("%s: %d failures\n", failures ? "FAIL" : "OK", failures);
+    return failures ? 1 : 0;
+}
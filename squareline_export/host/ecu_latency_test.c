@@ -0,0 +1,133 @@
+/**
+ * Host test for the end-to-end latency tracer (ecu_latency.h)
+ * Drives the stage stamps by hand: a redraw that starts before the sample
+ * reached the UI must not complete the trace, skipping VSYNC is allowed,
+ * skipping any other stage is not, and a stalled trace is replaced once it
+ * times out. Exits non-zero on any failure.
+ *
+ * Build and run (from squareline_export/):
+ *   cc -std=gnu99 -O2 -I . -o ecu_latency_test host/ecu_latency_test.c ecu_latency.c && ./ecu_latency_test
+ */
+
+#include <stdio.h>
+#include "ecu_latency.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { printf("FAIL %s:%d: ", __func__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+    } while (0)
+
+static uint32_t hist_count(ecu_latency_stage_t slot)
+{
+    ecu_latency_hist_t h;
+    ecu_latency_get(slot, &h);
+    return h.count;
+}
+
+static uint32_t hist_max(ecu_latency_stage_t slot)
+{
+    ecu_latency_hist_t h;
+    ecu_latency_get(slot, &h);
+    return h.max_us;
+}
+
+// Every stage in order, VSYNC included
+static void test_full_trace(void)
+{
+    ecu_latency_reset();
+    CHECK(ecu_latency_begin(1000) != 0, "begin refused");
+    ecu_latency_mark(ECU_LAT_DECODE, 1010);
+    ecu_latency_mark(ECU_LAT_PUBLISH, 1030);
+    ecu_latency_mark(ECU_LAT_UI_UPDATE, 1100);
+    ecu_latency_mark(ECU_LAT_RENDER, 1500);
+    ecu_latency_mark(ECU_LAT_VSYNC, 1800);
+    ecu_latency_mark(ECU_LAT_FLUSH, 2000);
+
+    CHECK(hist_count(ECU_LAT_TOTAL) == 1 && hist_max(ECU_LAT_TOTAL) == 1000, "total n=%lu max=%lu",
+          (unsigned long)hist_count(ECU_LAT_TOTAL), (unsigned long)hist_max(ECU_LAT_TOTAL));
+    CHECK(hist_max(ECU_LAT_DECODE) == 10 && hist_max(ECU_LAT_PUBLISH) == 20 && hist_max(ECU_LAT_UI_UPDATE) == 70 &&
+          hist_max(ECU_LAT_RENDER) == 400 && hist_max(ECU_LAT_VSYNC) == 300 && hist_max(ECU_LAT_FLUSH) == 200,
+          "stage deltas differ");
+}
+
+// A redraw in progress before the sample was published must not end the trace
+static void test_early_redraw_ignored(void)
+{
+    ecu_latency_reset();
+    CHECK(ecu_latency_begin(1000) != 0, "begin refused");
+    ecu_latency_mark(ECU_LAT_DECODE, 1010);
+    ecu_latency_mark(ECU_LAT_RENDER, 1500);
+    ecu_latency_mark(ECU_LAT_FLUSH, 2000);
+    CHECK(hist_count(ECU_LAT_TOTAL) == 0, "early FLUSH completed the trace");
+    CHECK(ecu_latency_begin(2100) == 0, "trace not kept in flight");
+
+    ecu_latency_mark(ECU_LAT_PUBLISH, 2200);
+    ecu_latency_mark(ECU_LAT_UI_UPDATE, 2300);
+    ecu_latency_mark(ECU_LAT_RENDER, 2800);
+    ecu_latency_mark(ECU_LAT_FLUSH, 3000);
+
+    CHECK(hist_count(ECU_LAT_TOTAL) == 1 && hist_max(ECU_LAT_TOTAL) == 2000, "total n=%lu max=%lu",
+          (unsigned long)hist_count(ECU_LAT_TOTAL), (unsigned long)hist_max(ECU_LAT_TOTAL));
+    CHECK(hist_count(ECU_LAT_PUBLISH) == 1 && hist_count(ECU_LAT_UI_UPDATE) == 1, "publish n=%lu ui n=%lu",
+          (unsigned long)hist_count(ECU_LAT_PUBLISH), (unsigned long)hist_count(ECU_LAT_UI_UPDATE));
+    CHECK(hist_max(ECU_LAT_RENDER) == 500 && hist_count(ECU_LAT_VSYNC) == 0, "render %lu, vsync n=%lu",
+          (unsigned long)hist_max(ECU_LAT_RENDER), (unsigned long)hist_count(ECU_LAT_VSYNC));
+}
+
+// Only VSYNC may be skipped
+static void test_skipped_stage(void)
+{
+    ecu_latency_reset();
+    CHECK(ecu_latency_begin(1000) != 0, "begin refused");
+    ecu_latency_mark(ECU_LAT_DECODE, 1010);
+    ecu_latency_mark(ECU_LAT_UI_UPDATE, 1100);      // PUBLISH missing
+    ecu_latency_mark(ECU_LAT_RENDER, 1200);
+    ecu_latency_mark(ECU_LAT_FLUSH, 1300);
+    CHECK(hist_count(ECU_LAT_TOTAL) == 0, "trace completed without PUBLISH");
+
+    ecu_latency_mark(ECU_LAT_PUBLISH, 1400);
+    ecu_latency_mark(ECU_LAT_UI_UPDATE, 1500);
+    ecu_latency_mark(ECU_LAT_FLUSH, 1600);          // RENDER missing
+    CHECK(hist_count(ECU_LAT_TOTAL) == 0, "trace completed without RENDER");
+
+    ecu_latency_mark(ECU_LAT_RENDER, 1700);
+    ecu_latency_mark(ECU_LAT_FLUSH, 1900);
+    CHECK(hist_count(ECU_LAT_TOTAL) == 1 && hist_max(ECU_LAT_FLUSH) == 200, "total n=%lu flush %lu",
+          (unsigned long)hist_count(ECU_LAT_TOTAL), (unsigned long)hist_max(ECU_LAT_FLUSH));
+
+    // Stamps after completion are dropped until the next begin
+    ecu_latency_mark(ECU_LAT_RENDER, 2000);
+    ecu_latency_mark(ECU_LAT_FLUSH, 2100);
+    CHECK(hist_count(ECU_LAT_TOTAL) == 1, "idle stamps counted");
+}
+
+// A sample that never reaches the screen is abandoned after the timeout
+static void test_timeout(void)
+{
+    ecu_latency_reset();
+    CHECK(ecu_latency_begin(1000) != 0, "begin refused");
+    ecu_latency_mark(ECU_LAT_DECODE, 1010);
+    CHECK(ecu_latency_begin(1000 + ECU_LATENCY_TIMEOUT_US - 1) == 0, "stalled trace replaced early");
+    CHECK(ecu_latency_begin(1000 + ECU_LATENCY_TIMEOUT_US) != 0, "stalled trace not replaced");
+
+    uint32_t t = 1000 + ECU_LATENCY_TIMEOUT_US;
+    ecu_latency_mark(ECU_LAT_DECODE, t + 10);
+    ecu_latency_mark(ECU_LAT_PUBLISH, t + 20);
+    ecu_latency_mark(ECU_LAT_UI_UPDATE, t + 30);
+    ecu_latency_mark(ECU_LAT_RENDER, t + 40);
+    ecu_latency_mark(ECU_LAT_FLUSH, t + 50);
+    CHECK(hist_count(ECU_LAT_TOTAL) == 1 && hist_max(ECU_LAT_TOTAL) == 50, "total n=%lu max=%lu",
+          (unsigned long)hist_count(ECU_LAT_TOTAL), (unsigned long)hist_max(ECU_LAT_TOTAL));
+}
+
+int main(void)
+{
+    test_full_trace();
+    test_early_redraw_ignored();
+    test_skipped_stage();
+    test_timeout();
+
+    printf("%s: %d failures\n", failures ? "FAIL" : "OK", failures);
+    return failures ? 1 : 0;
+}
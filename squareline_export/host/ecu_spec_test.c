@@ -0,0 +1,148 @@
+/**
+ * Conformance test for the CAN message tables (ecu_can_spec.h)
+ * Golden frames are written out by hand from
+ * esp_idf_s3_working/CAN_PROTOCOL_SPECIFICATION.md - the documented example
+ * frames plus edge frames (offsets, multiplexer pages, flag bits, full
+ * scale) - with the physical values the document gives for them. They do
+ * not come from ECU_CAN_SPEC_EXAMPLES / ECU_CAN_SPEC_EXPECTED, so a layout
+ * edited in both the tables and their self-check still fails here.
+ *
+ * Every frame must decode to its listed values, every signal the frame
+ * carries must be listed, and encoding the listed values into an empty
+ * frame must reproduce the golden bytes. Exits non-zero on any mismatch.
+ *
+ * Build and run (from squareline_export/):
+ *   cc -std=gnu99 -O2 -I . -o ecu_spec_test host/ecu_spec_test.c ecu_can_spec.c && ./ecu_spec_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ecu_can_spec.h"
+
+#define GOLDEN_MAX_SIGS     12
+
+typedef struct {
+    ecu_can_sig_id_t sig;
+    int32_t tenths;                     // Physical value in 0.1 units
+} golden_sig_t;
+
+typedef struct {
+    const char* what;
+    uint32_t can_id;
+    uint8_t data[8];
+    golden_sig_t sigs[GOLDEN_MAX_SIGS];
+    int count;
+} golden_frame_t;
+
+#define G(name, tenths) { ECU_SIG_##name, tenths }
+
+static const golden_frame_t golden[] = {
+    // Document examples
+    { "boost example", 0x200, { 0x2D, 0x7D, 0x00, 0x6E, 0x00, 0xFB, 0x2C, 0x01 },
+      { G(WASTEGATE_POSITION, 450), G(TARGET_BOOST, 125), G(ACTUAL_BOOST, 110),
+        G(BOOST_ERROR, -50), G(WASTEGATE_DUTY, 300) }, 5 },
+    { "engine example", 0x380, { 0x10, 0x0E, 0xFA, 0x00, 0x54, 0x6E, 0x90, 0x01 },
+      { G(ENGINE_RPM, 36000), G(MAP_PRESSURE, 250), G(TPS_POSITION, 840),
+        G(ENGINE_TEMP, 700), G(FUEL_PRESSURE, 400) }, 5 },
+    { "temps example, page 1", 0x381, { 0x01, 0x2C, 0x03, 0x36, 0x03, 0x40, 0x03, 0x00 },
+      { G(TEMP_PAGE, 10), G(EGT_CYL1, 8120), G(EGT_CYL2, 8220), G(EGT_CYL3, 8320) }, 4 },
+    { "tcu example, limp", 0x440, { 0xF4, 0x01, 0x20, 0x03, 0x64, 0x00, 0x5A, 0x02 },
+      { G(TORQUE_REQUEST, 5000), G(TCU_PROTECTION, 0), G(TCU_LAUNCH, 0), G(TCU_LIMP, 10),
+        G(TCU_DIAGNOSTIC, 0), G(TCU_SYSTEM_ERROR, 0), G(GEAR, 30), G(CLUTCH_PRESSURE, 100),
+        G(TCU_TEMP, 500), G(SHIFT_STRATEGY, 20) }, 10 },
+
+    // Edge frames
+    { "boost, positive error", 0x200, { 0x00, 0xD0, 0x07, 0x53, 0x07, 0x0C, 0xE8, 0x03 },
+      { G(WASTEGATE_POSITION, 0), G(TARGET_BOOST, 2000), G(ACTUAL_BOOST, 1875),
+        G(BOOST_ERROR, 120), G(WASTEGATE_DUTY, 1000) }, 5 },
+    { "engine, full scale / -40 C", 0x380, { 0x40, 0x1F, 0xB8, 0x0B, 0x64, 0x00, 0x40, 0x1F },
+      { G(ENGINE_RPM, 80000), G(MAP_PRESSURE, 3000), G(TPS_POSITION, 1000),
+        G(ENGINE_TEMP, -400), G(FUEL_PRESSURE, 8000) }, 5 },
+    { "temps, page 0", 0x381, { 0x00, 0x82, 0x91, 0x00, 0x00, 0x00, 0x00, 0x00 },
+      { G(TEMP_PAGE, 0), G(COOLANT_TEMP, 900), G(OIL_TEMP, 1050) }, 3 },
+    { "temps, page 2", 0x381, { 0x02, 0x16, 0x03, 0x21, 0x03, 0x4C, 0x04, 0x00 },
+      { G(TEMP_PAGE, 20), G(EGT_CYL4, 7900), G(EGT_CYL5, 8010), G(EGT_CYL6, 11000) }, 4 },
+    { "tcu, flags 0x1B, reverse", 0x440, { 0x00, 0x00, 0x1B, 0x07, 0xA0, 0x00, 0x00, 0x00 },
+      { G(TORQUE_REQUEST, 0), G(TCU_PROTECTION, 110), G(TCU_LAUNCH, 10), G(TCU_LIMP, 0),
+        G(TCU_DIAGNOSTIC, 0), G(TCU_SYSTEM_ERROR, 0), G(GEAR, 70), G(CLUTCH_PRESSURE, 160),
+        G(TCU_TEMP, -400), G(SHIFT_STRATEGY, 0) }, 10 },
+    { "tcu, diag + error", 0x440, { 0x00, 0x00, 0xC0, 0x08, 0x00, 0x00, 0x28, 0x07 },
+      { G(TORQUE_REQUEST, 0), G(TCU_PROTECTION, 0), G(TCU_LAUNCH, 0), G(TCU_LIMP, 0),
+        G(TCU_DIAGNOSTIC, 10), G(TCU_SYSTEM_ERROR, 10), G(GEAR, 80), G(CLUTCH_PRESSURE, 0),
+        G(TCU_TEMP, 0), G(SHIFT_STRATEGY, 70) }, 10 },
+};
+
+#define GOLDEN_COUNT    (sizeof(golden) / sizeof(golden[0]))
+
+static int failures = 0;
+
+#define FAIL(...) do { printf("FAIL %s: ", g->what); printf(__VA_ARGS__); printf("\n"); failures++; } while (0)
+
+static const golden_sig_t* find_listed(const golden_frame_t* g, ecu_can_sig_id_t sig)
+{
+    for (int i = 0; i < g->count; i++) {
+        if (g->sigs[i].sig == sig) return &g->sigs[i];
+    }
+    return NULL;
+}
+
+static void check_frame(const golden_frame_t* g)
+{
+    const ecu_can_msg_spec_t* m = ecu_can_spec_find(g->can_id);
+    if (m == NULL) {
+        FAIL("0x%03lX not in the specification", (unsigned long)g->can_id);
+        return;
+    }
+    if (m->dlc != 8) FAIL("%s DLC %u, documented 8", m->name, m->dlc);
+
+    // Decode: listed signals match, unlisted ones are absent from this frame
+    for (int i = 0; i < ECU_SIG_COUNT; i++) {
+        const ecu_can_sig_spec_t* s = &ecu_can_sigs[i];
+        if (&ecu_can_msgs[s->msg] != m) continue;
+        const golden_sig_t* want = find_listed(g, (ecu_can_sig_id_t)i);
+        bool present = ecu_can_sig_present((ecu_can_sig_id_t)i, g->data);
+        if (want == NULL) {
+            if (present) FAIL("%s present but not in the document", s->name);
+            continue;
+        }
+        if (!present) {
+            FAIL("%s missing (mux page)", s->name);
+            continue;
+        }
+        int32_t got = ecu_can_sig_get_tenths((ecu_can_sig_id_t)i, g->data);
+        if (got != want->tenths) FAIL("%s decoded %ld, documented %ld", s->name, (long)got, (long)want->tenths);
+    }
+    for (int i = 0; i < g->count; i++) {
+        if (&ecu_can_msgs[ecu_can_sigs[g->sigs[i].sig].msg] != m) {
+            FAIL("%s is not a %s signal", ecu_can_sigs[g->sigs[i].sig].name, m->name);
+        }
+    }
+
+    // Encode: the listed values alone rebuild the golden bytes
+    uint8_t frame[8];
+    memset(frame, 0, sizeof(frame));
+    for (int i = 0; i < g->count; i++) {
+        ecu_can_sig_set_tenths(g->sigs[i].sig, frame, g->sigs[i].tenths);
+    }
+    if (memcmp(frame, g->data, sizeof(frame)) != 0) {
+        FAIL("encoded %02X %02X %02X %02X %02X %02X %02X %02X", frame[0], frame[1], frame[2], frame[3],
+             frame[4], frame[5], frame[6], frame[7]);
+    }
+}
+
+int main(void)
+{
+    char report[512];
+    int table_failures = ecu_can_spec_check(report, sizeof(report));
+    if (table_failures) {
+        printf("FAIL ecu_can_spec_check: %d\n%s", table_failures, report);
+        failures += table_failures;
+    }
+
+    for (size_t i = 0; i < GOLDEN_COUNT; i++) {
+        check_frame(&golden[i]);
+    }
+
+    printf("%s: %u golden frames, %d failures\n", failures ? "FAIL" : "OK", (unsigned)GOLDEN_COUNT, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,233 @@
+/**
+ * Decoder for the ECU Dashboard binary serial telemetry (ecu_telemetry.h)
+ * Reads the dashboard's USB serial port, or a capture of it, splits the
+ * stream on 0x00 and prints one line per record. Bytes that are not a valid
+ * record - the plain-text Serial reports written between records - are
+ * printed as "# " comment lines, so nothing on the link is hidden.
+ *
+ * Build (from squareline_export/):
+ *   cc -std=gnu99 -O2 -I . -o ecu_tlm_decode host/ecu_tlm_decode.c ecu_telemetry.c
+ *
+ * Run:
+ *   ./ecu_tlm_decode /dev/ttyACM0            live, 115200 baud
+ *   ./ecu_tlm_decode -v 3 /dev/ttyACM0       also switch the dashboard to frame level
+ *   ./ecu_tlm_decode -c capture.bin > a.csv  CSV, one row per record
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "ecu_telemetry.h"
+
+#define DECODE_BAUD         B115200
+#define DECODE_CHUNK_MAX    512         // Longer runs without 0x00 are text or noise
+
+typedef struct {
+    unsigned long records;
+    unsigned long crc_errors;           // Chunks that looked binary but failed decoding
+    unsigned long seq_gaps;
+    unsigned long lost;                 // Records missing according to seq
+    unsigned long dropped;              // Reported by the dashboard (ring full)
+    bool have_seq;
+    uint8_t last_seq;
+} decode_stats_t;
+
+static bool csv = false;
+
+static const char* const type_names[] = { "?", "frame", "snapshot", "text", "dropped" };
+
+static bool is_text(const uint8_t* p, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if ((p[i] < 0x20 || p[i] > 0x7E) && p[i] != '\r' && p[i] != '\n' && p[i] != '\t') return false;
+    }
+    return true;
+}
+
+static void print_comment(const uint8_t* p, size_t len)
+{
+    size_t start = 0;
+
+    // One "# " line per text line; blank lines are dropped
+    for (size_t i = 0; i <= len; i++) {
+        if (i == len || p[i] == '\n' || p[i] == '\r') {
+            if (i > start) printf("# %.*s\n", (int)(i - start), (const char*)p + start);
+            start = i + 1;
+        }
+    }
+}
+
+static void print_record(const ecu_tlm_record_t* r)
+{
+    const char* name = r->type < sizeof(type_names) / sizeof(type_names[0]) ? type_names[r->type] : "?";
+
+    switch (r->type) {
+        case ECU_TLM_REC_FRAME: {
+            const ecu_can_frame_t* f = &r->u.frame.frame;
+            if (csv) {
+                printf("%u,%s,%lu,%lX,%u,", r->seq, name, (unsigned long)r->u.frame.rx_us,
+                       (unsigned long)f->id, f->flags);
+            } else {
+                printf("%10.6f  %03lX%s [%2u]", r->u.frame.rx_us / 1e6, (unsigned long)f->id,
+                       (f->flags & ECU_CAN_FRAME_FD) ? " FD" : "   ", f->len);
+            }
+            for (uint8_t i = 0; i < f->len; i++) printf(csv ? "%02X" : " %02X", f->data[i]);
+            printf("\n");
+            break;
+        }
+        case ECU_TLM_REC_SNAPSHOT: {
+            const ecu_data_fx_t* d = &r->u.snapshot.data;
+            if (csv) {
+                printf("%u,%s,%lu,%.1f,%.1f,%u,%u,%u,%u,%u,%lu\n", r->seq, name,
+                       (unsigned long)r->u.snapshot.time_ms, d->map_pressure / 10.0, d->target_boost / 10.0,
+                       d->engine_rpm, d->torque_request, d->wastegate_position, d->tps_position,
+                       d->flags, (unsigned long)r->u.snapshot.stale);
+            } else {
+                printf("%10.3f  MAP %.1f/%.1f kPa  RPM %u  torque %u Nm  WG %u%%  TPS %u%%%s%s",
+                       r->u.snapshot.time_ms / 1e3, d->map_pressure / 10.0, d->target_boost / 10.0,
+                       d->engine_rpm, d->torque_request, d->wastegate_position, d->tps_position,
+                       (d->flags & ECU_FX_FLAG_TCU_PROTECTION) ? "  PROTECT" : "",
+                       (d->flags & ECU_FX_FLAG_TCU_LIMP) ? "  LIMP" : "");
+                if (r->u.snapshot.stale) printf("  stale 0x%02lX", (unsigned long)r->u.snapshot.stale);
+                printf("\n");
+            }
+            break;
+        }
+        case ECU_TLM_REC_TEXT:
+            if (csv) printf("%u,%s,\"%s\"\n", r->seq, name, r->u.text);
+            else printf("            %s\n", r->u.text);
+            break;
+        case ECU_TLM_REC_DROPPED:
+            if (csv) printf("%u,%s,%lu\n", r->seq, name, (unsigned long)r->u.dropped);
+            else printf("            -- %lu records dropped on the dashboard (ring full)\n",
+                        (unsigned long)r->u.dropped);
+            break;
+    }
+}
+
+static void handle_chunk(const uint8_t* p, size_t len, decode_stats_t* s)
+{
+    ecu_tlm_record_t r;
+
+    if (len == 0) return;
+
+    if (len <= ECU_TLM_MAX_ENCODED && ecu_tlm_decode(p, len, &r)) {
+        if (s->have_seq && r.seq != (uint8_t)(s->last_seq + 1)) {
+            s->seq_gaps++;
+            s->lost += (uint8_t)(r.seq - s->last_seq - 1);
+            if (!csv) printf("            -- seq %u after %u, records lost on the link\n", r.seq, s->last_seq);
+        }
+        s->have_seq = true;
+        s->last_seq = r.seq;
+        s->records++;
+        if (r.type == ECU_TLM_REC_DROPPED) s->dropped += r.u.dropped;
+        print_record(&r);
+    } else if (is_text(p, len)) {
+        if (!csv) print_comment(p, len);
+    } else {
+        s->crc_errors++;
+    }
+}
+
+static int open_input(const char* path, bool* is_tty)
+{
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    *is_tty = isatty(fd);
+    if (*is_tty) {
+        struct termios tio;
+        if (tcgetattr(fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            cfsetispeed(&tio, DECODE_BAUD);
+            cfsetospeed(&tio, DECODE_BAUD);
+            tio.c_cc[VMIN] = 1;
+            tio.c_cc[VTIME] = 0;
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+    }
+    return fd;
+}
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [-c] [-v LEVEL] [FILE|TTY]\n"
+            "  -c         CSV output: seq,type,fields...\n"
+            "  -v LEVEL   send the verbosity digit to the dashboard first\n"
+            "             (0 off, 1 text, 2 snapshots, 3 CAN frames)\n"
+            "  FILE|TTY   capture file or serial port (default: stdin)\n",
+            prog);
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = NULL;
+    int level = -1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "cv:h")) != -1) {
+        switch (opt) {
+            case 'c': csv = true; break;
+            case 'v': level = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (optind < argc) path = argv[optind];
+    if (level >= ECU_TLM_LEVEL_COUNT) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int fd = STDIN_FILENO;
+    bool is_tty = false;
+    if (path) {
+        fd = open_input(path, &is_tty);
+        if (fd < 0) {
+            fprintf(stderr, "%s: %s\n", path, strerror(errno));
+            return 1;
+        }
+    }
+    if (level >= 0) {
+        char cmd = (char)('0' + level);
+        if (write(fd, &cmd, 1) != 1) {
+            fprintf(stderr, "%s: cannot send level: %s\n", path ? path : "stdin", strerror(errno));
+        }
+    }
+
+    static uint8_t chunk[DECODE_CHUNK_MAX];
+    size_t chunk_len = 0;
+    decode_stats_t stats = { 0 };
+    uint8_t buf[4096];
+    ssize_t n;
+
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        for (ssize_t i = 0; i < n; i++) {
+            if (buf[i] == 0) {
+                handle_chunk(chunk, chunk_len, &stats);
+                chunk_len = 0;
+            } else if (chunk_len < sizeof(chunk)) {
+                chunk[chunk_len++] = buf[i];
+            } else {
+                // Plain text between records can be long; flush it as it comes
+                if (!csv && is_text(chunk, chunk_len)) print_comment(chunk, chunk_len);
+                chunk[0] = buf[i];
+                chunk_len = 1;
+            }
+        }
+        if (is_tty) fflush(stdout);
+    }
+    handle_chunk(chunk, chunk_len, &stats);
+
+    fprintf(stderr, "%lu records, %lu bad chunks, %lu seq gaps (%lu lost on the link), %lu dropped on the dashboard\n",
+            stats.records, stats.crc_errors, stats.seq_gaps, stats.lost, stats.dropped);
+    return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * Host test for the binary serial telemetry (ecu_telemetry.h)
+ * Round trips through ecu_tlm_read() and ecu_tlm_decode(): a TEXT record of
+ * ECU_TLM_TEXT_MAX characters (and a longer one that is cut), a FRAME with
+ * 64 CAN FD data bytes, a SNAPSHOT, and the DROPPED record after the ring
+ * filled up. Two producer threads then append concurrently while the main
+ * thread drains; every record must decode and seq must have no gaps.
+ * Exits non-zero on any failure. Build it with -fsanitize=address to catch
+ * stack or ring overruns.
+ *
+ * Build and run (from squareline_export/):
+ *   cc -std=gnu99 -O1 -g -fsanitize=address,undefined -I . -o ecu_tlm_test \
+ *      host/ecu_tlm_test.c ecu_telemetry.c -lpthread && ./ecu_tlm_test
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include "ecu_telemetry.h"
+
+#define THREAD_RECORDS      20000
+
+static int failures = 0;
+static volatile int producers_done = 0;
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { printf("FAIL %s:%d: ", __func__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+    } while (0)
+
+// Decoded records of one drain, in order
+typedef struct {
+    ecu_tlm_record_t rec[64];
+    int count;
+    int bad;                     // Chunks that failed to decode
+    int seq_gaps;
+    bool have_seq;
+    uint8_t last_seq;
+} drain_t;
+
+// Split ecu_tlm_read() output on 0x00 and decode every chunk
+static void drain_chunk(drain_t* d, const uint8_t* buf, size_t n, bool keep)
+{
+    size_t start = 0;
+
+    for (size_t i = 0; i <= n; i++) {
+        if (i < n && buf[i] != 0) continue;
+        if (i > start) {
+            ecu_tlm_record_t r;
+            if (i - start > ECU_TLM_MAX_ENCODED || !ecu_tlm_decode(buf + start, i - start, &r)) {
+                d->bad++;
+            } else {
+                if (d->have_seq && r.seq != (uint8_t)(d->last_seq + 1)) d->seq_gaps++;
+                d->have_seq = true;
+                d->last_seq = r.seq;
+                if (keep && d->count < (int)(sizeof(d->rec) / sizeof(d->rec[0]))) d->rec[d->count] = r;
+                d->count++;
+            }
+        }
+        start = i + 1;
+    }
+}
+
+static void drain(drain_t* d, bool keep)
+{
+    uint8_t buf[ECU_TLM_WRITE_CHUNK];
+    size_t n;
+
+    while ((n = ecu_tlm_read(buf, sizeof(buf))) > 0) {
+        drain_chunk(d, buf, n, keep);
+    }
+}
+
+// Longest TEXT record: the encoder once overran a FRAME-sized stack buffer here
+static void test_max_text(void)
+{
+    char text[ECU_TLM_TEXT_MAX + 41];
+    drain_t d;
+
+    // Every non-zero byte value, including 0xFF runs that stress COBS
+    for (size_t i = 0; i < sizeof(text) - 1; i++) text[i] = (char)(1 + (i * 37) % 255);
+    text[sizeof(text) - 1] = '\0';
+
+    ecu_tlm_init(ECU_TLM_LEVEL_TEXT);
+    memset(&d, 0, sizeof(d));
+    CHECK(ecu_tlm_text(text), "text record not appended");
+    text[ECU_TLM_TEXT_MAX] = '\0';
+    CHECK(ecu_tlm_text(text), "max-length text record not appended");
+    drain(&d, true);
+
+    CHECK(d.count == 2 && d.bad == 0, "%d records, %d bad", d.count, d.bad);
+    for (int i = 0; i < d.count; i++) {
+        CHECK(d.rec[i].type == ECU_TLM_REC_TEXT && strlen(d.rec[i].u.text) == ECU_TLM_TEXT_MAX &&
+              memcmp(d.rec[i].u.text, text, ECU_TLM_TEXT_MAX) == 0, "record %d: text differs", i);
+    }
+}
+
+static void test_frame_and_snapshot(void)
+{
+    ecu_can_frame_t frame;
+    ecu_data_fx_t fx;
+    uint8_t data[ECU_CAN_FD_MAX_LEN];
+    drain_t d;
+
+    for (int i = 0; i < ECU_CAN_FD_MAX_LEN; i++) data[i] = (uint8_t)(i & 3 ? i : 0);
+    ecu_can_frame_set(&frame, 0x18DAF110, data, ECU_CAN_FD_MAX_LEN, ECU_CAN_FRAME_EXTENDED);
+    memset(&fx, 0, sizeof(fx));
+    fx.map_pressure = 1875;
+    fx.engine_rpm = 6500;
+    fx.tps_position = 100;
+
+    ecu_tlm_init(ECU_TLM_LEVEL_FRAMES);
+    memset(&d, 0, sizeof(d));
+    CHECK(ecu_tlm_frame(&frame, 123456789u), "frame record not appended");
+    CHECK(ecu_tlm_snapshot(&fx, 0x05, 4242), "snapshot record not appended");
+    drain(&d, true);
+
+    CHECK(d.count == 2 && d.bad == 0, "%d records, %d bad", d.count, d.bad);
+    CHECK(d.rec[0].type == ECU_TLM_REC_FRAME && d.rec[0].u.frame.rx_us == 123456789u &&
+          d.rec[0].u.frame.frame.id == 0x18DAF110 && d.rec[0].u.frame.frame.len == ECU_CAN_FD_MAX_LEN &&
+          memcmp(d.rec[0].u.frame.frame.data, data, ECU_CAN_FD_MAX_LEN) == 0, "frame record differs");
+    CHECK(d.rec[1].type == ECU_TLM_REC_SNAPSHOT && d.rec[1].u.snapshot.time_ms == 4242 &&
+          d.rec[1].u.snapshot.data.map_pressure == 1875 && d.rec[1].u.snapshot.data.engine_rpm == 6500 &&
+          d.rec[1].u.snapshot.stale == 0x05, "snapshot record differs");
+}
+
+// Fill the ring, drop some, drain: a DROPPED record with the count leads the next record
+static void test_dropped(void)
+{
+    char text[ECU_TLM_TEXT_MAX + 1];
+    ecu_tlm_stats_t stats;
+    drain_t d;
+    int appended = 0;
+    int refused = 0;
+
+    memset(text, 'x', ECU_TLM_TEXT_MAX);
+    text[ECU_TLM_TEXT_MAX] = '\0';
+    ecu_tlm_init(ECU_TLM_LEVEL_TEXT);
+    memset(&d, 0, sizeof(d));
+    for (int i = 0; i < ECU_TLM_RING_SIZE / 64; i++) {
+        if (ecu_tlm_text(text)) appended++;
+        else refused++;
+    }
+    CHECK(refused > 0, "ring never filled");
+    drain(&d, false);
+    CHECK(ecu_tlm_text("after"), "record after drain not appended");
+    memset(&d.rec, 0, sizeof(d.rec));
+    int before = d.count;
+    d.count = 0;
+    drain(&d, true);
+
+    ecu_tlm_get_stats(&stats);
+    CHECK(before == appended && d.bad == 0 && d.seq_gaps == 0, "%d/%d drained, %d bad, %d gaps", before, appended,
+          d.bad, d.seq_gaps);
+    CHECK(d.count == 2 && d.rec[0].type == ECU_TLM_REC_DROPPED && d.rec[0].u.dropped == (uint32_t)refused &&
+          d.rec[1].type == ECU_TLM_REC_TEXT && strcmp(d.rec[1].u.text, "after") == 0,
+          "expected DROPPED %d then TEXT", refused);
+    CHECK(stats.dropped == (uint32_t)refused, "stats.dropped %lu", (unsigned long)stats.dropped);
+}
+
+static void* producer(void* arg)
+{
+    char text[ECU_TLM_TEXT_MAX + 1];
+    int id = (int)(size_t)arg;
+
+    for (int i = 0; i < THREAD_RECORDS; i++) {
+        int len = snprintf(text, sizeof(text), "producer %d record %d ", id, i);
+        memset(text + len, 'a' + id, (size_t)(i % (ECU_TLM_TEXT_MAX - len)));
+        text[len + i % (ECU_TLM_TEXT_MAX - len)] = '\0';
+        ecu_tlm_text(text);
+        if (i % 4 == 0) sched_yield();      // Let the reader keep the ring from filling up
+    }
+    __sync_fetch_and_add(&producers_done, 1);
+    return NULL;
+}
+
+// Concurrent producers: records are encoded outside the lock, seq must stay gap-free
+static void test_concurrent(void)
+{
+    pthread_t threads[2];
+    ecu_tlm_stats_t stats;
+    drain_t d;
+
+    ecu_tlm_init(ECU_TLM_LEVEL_TEXT);
+    memset(&d, 0, sizeof(d));
+    for (int t = 0; t < 2; t++) pthread_create(&threads[t], NULL, producer, (void*)(size_t)t);
+
+    while (producers_done < 2) {
+        uint8_t buf[ECU_TLM_WRITE_CHUNK];
+        size_t n = ecu_tlm_read(buf, sizeof(buf));
+        if (n) drain_chunk(&d, buf, n, false);
+        else sched_yield();
+    }
+    for (int t = 0; t < 2; t++) pthread_join(threads[t], NULL);
+    ecu_tlm_text("end");      // Flushes a pending DROPPED record
+    drain(&d, false);
+
+    ecu_tlm_get_stats(&stats);
+    CHECK(d.bad == 0, "%d records failed to decode", d.bad);
+    CHECK(d.seq_gaps == 0, "%d seq gaps", d.seq_gaps);
+    CHECK((uint32_t)d.count == stats.records, "%d records drained, %lu appended", d.count,
+          (unsigned long)stats.records);
+    printf("concurrent: %lu records, %lu dropped (ring full)\n", (unsigned long)stats.records,
+           (unsigned long)stats.dropped);
+}
+
+int main(void)
+{
+    test_max_text();
+    test_frame_and_snapshot();
+    test_dropped();
+    test_concurrent();
+
+    printf("%s: %d failures\n", failures ? "FAIL" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,479 @@
+/**
+ * POSIX WebSocket server for the ECU Dashboard host build
+ * RFC 6455 subset: text frames out, unfragmented text/ping/close frames in
+ * (messages up to ECU_WS_IN_BUF), no extensions. SHA-1 is only used for the
+ * handshake accept key.
+ */
+
+#include "ecu_ws_server.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#define WS_GUID             "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_OPCODE_CONT      0x0
+#define WS_OPCODE_TEXT      0x1
+#define WS_OPCODE_BINARY    0x2
+#define WS_OPCODE_CLOSE     0x8
+#define WS_OPCODE_PING      0x9
+#define WS_OPCODE_PONG      0xA
+#define WS_HEADER_MAX       10      // Server frames are not masked
+
+// SHA-1 (FIPS 180-1) of a short message, for Sec-WebSocket-Accept
+static uint32_t rol(uint32_t x, int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+static void sha1_block(uint32_t h[5], const uint8_t* p)
+{
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)p[4 * i] << 24) | ((uint32_t)p[4 * i + 1] << 16) | ((uint32_t)p[4 * i + 2] << 8) | p[4 * i + 3];
+    }
+    for (int i = 16; i < 80; i++) {
+        w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t t = rol(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rol(b, 30);
+        b = a;
+        a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+static void sha1(const uint8_t* msg, size_t len, uint8_t digest[20])
+{
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    uint8_t block[64];
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        sha1_block(h, msg + i);
+    }
+    size_t rest = len - i;
+    memset(block, 0, sizeof(block));
+    memcpy(block, msg + i, rest);
+    block[rest] = 0x80;
+    if (rest >= 56) {
+        sha1_block(h, block);
+        memset(block, 0, sizeof(block));
+    }
+    uint64_t bits = (uint64_t)len * 8u;
+    for (int b = 0; b < 8; b++) {
+        block[63 - b] = (uint8_t)(bits >> (8 * b));
+    }
+    sha1_block(h, block);
+
+    for (int j = 0; j < 5; j++) {
+        digest[4 * j] = (uint8_t)(h[j] >> 24);
+        digest[4 * j + 1] = (uint8_t)(h[j] >> 16);
+        digest[4 * j + 2] = (uint8_t)(h[j] >> 8);
+        digest[4 * j + 3] = (uint8_t)h[j];
+    }
+}
+
+static void base64(const uint8_t* in, size_t len, char* out)
+{
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < len) v |= in[i + 2];
+        out[o++] = table[(v >> 18) & 63];
+        out[o++] = table[(v >> 12) & 63];
+        out[o++] = i + 1 < len ? table[(v >> 6) & 63] : '=';
+        out[o++] = i + 2 < len ? table[v & 63] : '=';
+    }
+    out[o] = '\0';
+}
+
+static void client_close(ecu_ws_server_t* srv, ecu_ws_client_t* c)
+{
+    if (c->fd < 0) return;
+    if (c->upgraded) srv->stats.disconnects++;
+    close(c->fd);
+    c->fd = -1;
+    c->upgraded = false;
+    c->in_len = 0;
+    c->out_len = 0;
+}
+
+// Write what the socket takes now
+static bool client_flush(ecu_ws_server_t* srv, ecu_ws_client_t* c)
+{
+    while (c->out_len) {
+        ssize_t n = send(c->fd, c->out, c->out_len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            client_close(srv, c);
+            return false;
+        }
+        memmove(c->out, c->out + n, c->out_len - (size_t)n);
+        c->out_len -= (size_t)n;
+    }
+    return true;
+}
+
+// Append raw bytes; a full buffer means the client stopped reading
+static bool client_queue(ecu_ws_server_t* srv, ecu_ws_client_t* c, const void* data, size_t len)
+{
+    if (c->out_len + len > sizeof(c->out)) {
+        srv->stats.slow_clients++;
+        client_close(srv, c);
+        return false;
+    }
+    memcpy(c->out + c->out_len, data, len);
+    c->out_len += len;
+    return true;
+}
+
+static size_t frame_header(uint8_t* hdr, uint8_t opcode, size_t len)
+{
+    hdr[0] = (uint8_t)(0x80 | opcode);
+    if (len < 126) {
+        hdr[1] = (uint8_t)len;
+        return 2;
+    }
+    if (len <= 0xFFFF) {
+        hdr[1] = 126;
+        hdr[2] = (uint8_t)(len >> 8);
+        hdr[3] = (uint8_t)len;
+        return 4;
+    }
+    hdr[1] = 127;
+    for (int i = 0; i < 8; i++) {
+        hdr[2 + i] = (uint8_t)((uint64_t)len >> (56 - 8 * i));
+    }
+    return 10;
+}
+
+static bool client_send_frame(ecu_ws_server_t* srv, ecu_ws_client_t* c, uint8_t opcode, const void* data, size_t len)
+{
+    uint8_t hdr[WS_HEADER_MAX];
+    size_t hlen = frame_header(hdr, opcode, len);
+
+    if (!client_queue(srv, c, hdr, hlen) || !client_queue(srv, c, data, len)) return false;
+    srv->stats.frames_out++;
+    srv->stats.bytes_out += hlen + len;
+    return client_flush(srv, c);
+}
+
+static void http_reply(ecu_ws_server_t* srv, ecu_ws_client_t* c, const char* status)
+{
+    char reply[128];
+    int n = snprintf(reply, sizeof(reply), "HTTP/1.1 %s\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", status);
+    send(c->fd, reply, (size_t)n, MSG_NOSIGNAL);
+    srv->stats.rejected++;
+    client_close(srv, c);
+}
+
+// Value of a header in a NUL-terminated request, copied into out
+static bool http_header(const char* req, const char* name, char* out, size_t len)
+{
+    size_t name_len = strlen(name);
+    const char* line = strstr(req, "\r\n");
+
+    while (line && line[2] != '\r') {
+        line += 2;
+        if (strncasecmp(line, name, name_len) == 0 && line[name_len] == ':') {
+            const char* v = line + name_len + 1;
+            while (*v == ' ') v++;
+            size_t n = strcspn(v, "\r");
+            if (n >= len) return false;
+            memcpy(out, v, n);
+            out[n] = '\0';
+            return true;
+        }
+        line = strstr(line, "\r\n");
+    }
+    return false;
+}
+
+static void client_handshake(ecu_ws_server_t* srv, ecu_ws_client_t* c)
+{
+    char key[64];
+    char upgrade[32];
+    char accept[32];
+    char reply[256];
+    uint8_t digest[20];
+    size_t path_len = strlen(srv->path);
+
+    c->in[c->in_len] = '\0';
+    char* end = strstr((char*)c->in, "\r\n\r\n");
+    if (end == NULL) {
+        if (c->in_len >= sizeof(c->in) - 1) http_reply(srv, c, "431 Request Header Fields Too Large");
+        return;
+    }
+
+    const char* req = (const char*)c->in;
+    if (strncmp(req, "GET ", 4) != 0 || strncmp(req + 4, srv->path, path_len) != 0 ||
+        (req[4 + path_len] != ' ' && req[4 + path_len] != '?')) {
+        http_reply(srv, c, "404 Not Found");
+        return;
+    }
+    if (!http_header(req, "Upgrade", upgrade, sizeof(upgrade)) || strcasecmp(upgrade, "websocket") != 0 ||
+        !http_header(req, "Sec-WebSocket-Key", key, sizeof(key) - sizeof(WS_GUID))) {
+        http_reply(srv, c, "400 Bad Request");
+        return;
+    }
+
+    strcat(key, WS_GUID);
+    sha1((const uint8_t*)key, strlen(key), digest);
+    base64(digest, sizeof(digest), accept);
+    int n = snprintf(reply, sizeof(reply),
+                     "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                     "Sec-WebSocket-Accept: %s\r\n\r\n", accept);
+
+    size_t used = (size_t)(end + 4 - (char*)c->in);
+    memmove(c->in, c->in + used, c->in_len - used);
+    c->in_len -= used;
+    c->upgraded = true;
+    srv->stats.connections++;
+    if (client_queue(srv, c, reply, (size_t)n)) client_flush(srv, c);
+}
+
+// Handle every complete frame in the input buffer
+static void client_frames(ecu_ws_server_t* srv, int index)
+{
+    ecu_ws_client_t* c = &srv->clients[index];
+
+    while (c->fd >= 0 && c->in_len >= 2) {
+        uint8_t opcode = c->in[0] & 0x0F;
+        bool masked = (c->in[1] & 0x80) != 0;
+        size_t len = c->in[1] & 0x7F;
+        size_t hlen = 2;
+
+        if (len == 126) {
+            if (c->in_len < 4) return;
+            len = ((size_t)c->in[2] << 8) | c->in[3];
+            hlen = 4;
+        } else if (len == 127) {
+            len = sizeof(c->in);            // Never fits: closed below
+        }
+        // Client frames must be masked; one message has to fit the buffer (plus a NUL)
+        if (!masked || hlen + 4 + len >= sizeof(c->in)) {
+            client_close(srv, c);
+            return;
+        }
+        if (c->in_len < hlen + 4 + len) return;
+
+        uint8_t* mask = c->in + hlen;
+        uint8_t* payload = mask + 4;
+        for (size_t i = 0; i < len; i++) {
+            payload[i] ^= mask[i & 3];
+        }
+
+        switch (opcode) {
+            case WS_OPCODE_TEXT: {
+                uint8_t saved = payload[len];
+                payload[len] = '\0';
+                srv->stats.messages_in++;
+                if (srv->on_message) srv->on_message(srv, index, (const char*)payload, len, srv->ctx);
+                if (c->fd < 0) return;
+                payload[len] = saved;
+                break;
+            }
+            case WS_OPCODE_PING:
+                client_send_frame(srv, c, WS_OPCODE_PONG, payload, len);
+                break;
+            case WS_OPCODE_CLOSE:
+                client_send_frame(srv, c, WS_OPCODE_CLOSE, payload, len < 2 ? len : 2);
+                client_close(srv, c);
+                return;
+            default:
+                break;                      // Binary, pong and fragments are ignored
+        }
+        if (c->fd < 0) return;
+
+        size_t used = hlen + 4 + len;
+        memmove(c->in, c->in + used, c->in_len - used);
+        c->in_len -= used;
+    }
+}
+
+static void client_read(ecu_ws_server_t* srv, int index)
+{
+    ecu_ws_client_t* c = &srv->clients[index];
+    ssize_t n = recv(c->fd, c->in + c->in_len, sizeof(c->in) - 1 - c->in_len, 0);
+
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        client_close(srv, c);
+        return;
+    }
+    if (n < 0) return;
+    c->in_len += (size_t)n;
+
+    if (!c->upgraded) client_handshake(srv, c);
+    if (c->fd >= 0 && c->upgraded) client_frames(srv, index);
+}
+
+static void accept_clients(ecu_ws_server_t* srv)
+{
+    for (;;) {
+        int fd = accept(srv->listen_fd, NULL, NULL);
+        if (fd < 0) return;
+
+        ecu_ws_client_t* c = NULL;
+        for (int i = 0; i < ECU_WS_MAX_CLIENTS && c == NULL; i++) {
+            if (srv->clients[i].fd < 0) c = &srv->clients[i];
+        }
+        if (c == NULL) {
+            srv->stats.rejected++;
+            close(fd);
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        c->fd = fd;
+        c->upgraded = false;
+        c->in_len = 0;
+        c->out_len = 0;
+    }
+}
+
+bool ecu_ws_server_start(ecu_ws_server_t* srv, uint16_t port, const char* path,
+                         ecu_ws_message_fn on_message, void* ctx)
+{
+    struct sockaddr_in addr;
+    int one = 1;
+
+    memset(&srv->stats, 0, sizeof(srv->stats));
+    for (int i = 0; i < ECU_WS_MAX_CLIENTS; i++) {
+        srv->clients[i].fd = -1;
+        srv->clients[i].upgraded = false;
+    }
+    srv->path = path;
+    srv->on_message = on_message;
+    srv->ctx = ctx;
+
+    srv->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (srv->listen_fd < 0) return false;
+    setsockopt(srv->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(srv->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(srv->listen_fd, 64) < 0) {
+        close(srv->listen_fd);
+        srv->listen_fd = -1;
+        return false;
+    }
+    fcntl(srv->listen_fd, F_SETFL, fcntl(srv->listen_fd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+bool ecu_ws_server_poll(ecu_ws_server_t* srv, int extra_fd, int timeout_ms)
+{
+    struct pollfd fds[ECU_WS_MAX_CLIENTS + 2];
+    int slot[ECU_WS_MAX_CLIENTS + 2];
+    nfds_t count = 0;
+    bool extra_ready = false;
+
+    fds[count].fd = srv->listen_fd;
+    fds[count].events = POLLIN;
+    slot[count++] = -1;
+    if (extra_fd >= 0) {
+        fds[count].fd = extra_fd;
+        fds[count].events = POLLIN;
+        slot[count++] = -2;
+    }
+    for (int i = 0; i < ECU_WS_MAX_CLIENTS; i++) {
+        ecu_ws_client_t* c = &srv->clients[i];
+        if (c->fd < 0) continue;
+        fds[count].fd = c->fd;
+        fds[count].events = (short)(POLLIN | (c->out_len ? POLLOUT : 0));
+        slot[count++] = i;
+    }
+
+    if (poll(fds, count, timeout_ms) <= 0) return false;
+
+    for (nfds_t k = 0; k < count; k++) {
+        if (fds[k].revents == 0) continue;
+        if (slot[k] == -1) {
+            accept_clients(srv);
+        } else if (slot[k] == -2) {
+            extra_ready = true;
+        } else {
+            ecu_ws_client_t* c = &srv->clients[slot[k]];
+            if (fds[k].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                client_close(srv, c);
+                continue;
+            }
+            if (fds[k].revents & POLLOUT) client_flush(srv, c);
+            if (c->fd >= 0 && (fds[k].revents & POLLIN)) client_read(srv, slot[k]);
+        }
+    }
+    return extra_ready;
+}
+
+bool ecu_ws_server_send(ecu_ws_server_t* srv, int client, const char* text, size_t len)
+{
+    if (client < 0 || client >= ECU_WS_MAX_CLIENTS) return false;
+    ecu_ws_client_t* c = &srv->clients[client];
+    if (c->fd < 0 || !c->upgraded) return false;
+    return client_send_frame(srv, c, WS_OPCODE_TEXT, text, len);
+}
+
+uint32_t ecu_ws_server_broadcast(ecu_ws_server_t* srv, const char* text, size_t len)
+{
+    uint32_t sent = 0;
+
+    for (int i = 0; i < ECU_WS_MAX_CLIENTS; i++) {
+        if (ecu_ws_server_send(srv, i, text, len)) sent++;
+    }
+    return sent;
+}
+
+uint32_t ecu_ws_server_clients(const ecu_ws_server_t* srv)
+{
+    uint32_t clients = 0;
+
+    for (int i = 0; i < ECU_WS_MAX_CLIENTS; i++) {
+        if (srv->clients[i].fd >= 0 && srv->clients[i].upgraded) clients++;
+    }
+    return clients;
+}
+
+void ecu_ws_server_stop(ecu_ws_server_t* srv)
+{
+    for (int i = 0; i < ECU_WS_MAX_CLIENTS; i++) {
+        client_close(srv, &srv->clients[i]);
+    }
+    if (srv->listen_fd >= 0) close(srv->listen_fd);
+    srv->listen_fd = -1;
+}
@@ -0,0 +1,121 @@
+/**
+ * POSIX WebSocket server for the ECU Dashboard host build
+ * Same contract as the ESP32 httpd server in can_websocket.c: clients
+ * connect to /ws, receive text frames, and may send text requests. One
+ * thread, poll() driven, non-blocking sockets; a client that stops reading
+ * is disconnected once its send buffer is full instead of stalling the
+ * broadcast to everyone else.
+ */
+
+#ifndef ECU_WS_SERVER_H
+#define ECU_WS_SERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ECU_WS_MAX_CLIENTS      128
+#define ECU_WS_IN_BUF           2048    // Handshake or one client message
+#define ECU_WS_OUT_BUF          32768   // Unsent frames per client
+
+typedef struct ecu_ws_server ecu_ws_server_t;
+
+/**
+ * Text message from a client
+ * @param srv Server
+ * @param client Client slot, for ecu_ws_server_send()
+ * @param text Payload, NUL-terminated
+ * @param len Payload bytes
+ * @param ctx Callback context
+ */
+typedef void (*ecu_ws_message_fn)(ecu_ws_server_t* srv, int client, const char* text, size_t len, void* ctx);
+
+typedef struct {
+    uint32_t connections;        // Completed handshakes
+    uint32_t disconnects;
+    uint32_t rejected;           // Bad handshake, wrong path or no free slot
+    uint32_t slow_clients;       // Disconnected because the send buffer filled up
+    uint32_t messages_in;
+    uint64_t frames_out;
+    uint64_t bytes_out;
+} ecu_ws_stats_t;
+
+typedef struct {
+    int fd;                      // -1 if the slot is free
+    bool upgraded;               // Handshake done
+    size_t in_len;
+    size_t out_len;
+    uint8_t in[ECU_WS_IN_BUF];
+    uint8_t out[ECU_WS_OUT_BUF];
+} ecu_ws_client_t;
+
+struct ecu_ws_server {
+    int listen_fd;
+    const char* path;
+    ecu_ws_message_fn on_message;
+    void* ctx;
+    ecu_ws_stats_t stats;
+    ecu_ws_client_t clients[ECU_WS_MAX_CLIENTS];
+};
+
+/**
+ * Listen for WebSocket clients
+ * @param srv Server storage (large: keep it static)
+ * @param port TCP port, all interfaces
+ * @param path Upgrade path, e.g. "/ws"
+ * @param on_message Called for every text message, may be NULL
+ * @param ctx Passed to on_message
+ * @return false if the port could not be bound, errno is set
+ */
+bool ecu_ws_server_start(ecu_ws_server_t* srv, uint16_t port, const char* path,
+                         ecu_ws_message_fn on_message, void* ctx);
+
+/**
+ * Accept clients, run handshakes, read messages and flush send buffers
+ * @param srv Server
+ * @param extra_fd Another descriptor to wait on (CAN socket), -1 for none
+ * @param timeout_ms Wait for activity, 0 to only do what is ready
+ * @return true if extra_fd is readable
+ */
+bool ecu_ws_server_poll(ecu_ws_server_t* srv, int extra_fd, int timeout_ms);
+
+/**
+ * Queue a text frame for one client
+ * @param srv Server
+ * @param client Client slot
+ * @param text Payload
+ * @param len Payload bytes
+ * @return false if the client is gone or was too slow
+ */
+bool ecu_ws_server_send(ecu_ws_server_t* srv, int client, const char* text, size_t len);
+
+/**
+ * Queue a text frame for every connected client
+ * @param srv Server
+ * @param text Payload
+ * @param len Payload bytes
+ * @return Clients the frame was queued for
+ */
+uint32_t ecu_ws_server_broadcast(ecu_ws_server_t* srv, const char* text, size_t len);
+
+/**
+ * @param srv Server
+ * @return Connected WebSocket clients
+ */
+uint32_t ecu_ws_server_clients(const ecu_ws_server_t* srv);
+
+/**
+ * Close every client and the listening socket
+ * @param srv Server
+ */
+void ecu_ws_server_stop(ecu_ws_server_t* srv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_WS_SERVER_H
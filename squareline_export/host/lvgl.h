@@ -0,0 +1,22 @@
+/**
+ * LVGL stand-in for the headless host build
+ * The CAN pipeline only needs the millisecond tick; ecu_host.c provides it
+ * from CLOCK_MONOTONIC. UI sources are not part of this build.
+ */
+
+#ifndef ECU_HOST_LVGL_H
+#define ECU_HOST_LVGL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t lv_tick_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_HOST_LVGL_H
@@ -198,6 +198,7 @@
 #define LV_USE_BTN        1
 #define LV_USE_BTNMATRIX  0
 #define LV_USE_CANVAS     0
+#define LV_USE_CHART      1   /* Boost history chart */
 #define LV_USE_CHECKBOX   0
 #define LV_USE_DROPDOWN   0
 #define LV_USE_IMG        1
@@ -6,6 +6,7 @@
 #include "ui.h"
 #include "ecu_can_integration.h"
 #include "ecu_data_structures.h"
+#include "ecu_can_supervisor.h"
 #include "lvgl.h"
 
 // Application configuration
@@ -84,15 +85,16 @@ static void main_update_task(lv_timer_t *timer)
  */
 static void update_ui_with_ecu_data(void)
 {
-    ecu_data_t *ecu_data = ecu_get_current_data();
-    
     if (ecu_data_is_fresh(DATA_TIMEOUT_MS)) {
-        // Data is fresh - update UI
-        ui_set_ecu_data(ecu_data);
+        // Data is fresh - hand the raw snapshot to the UI, no float conversion
+        ui_set_ecu_data_fx(ecu_get_current_data_fx());
         ui_set_connection_status(true, "Connected");
+        // A single dead message only ghosts the gauges it feeds
+        ui_set_stale_channels(ecu_stale_channels());
     } else {
-        // Data is stale - show disconnected
-        ui_set_connection_status(false, "No Data");
+        // Data is stale - keep the last values on screen, ghosted, and say why
+        ui_set_connection_status(false, ecu_can_supervisor_bus_usable() ? "No Data" : "CAN bus off - recovering");
+        ui_set_stale_channels((1u << ECU_CH_COUNT) - 1u);
     }
 }
 
@@ -107,8 +109,8 @@ static void handle_system_alerts(void)
         return; // No valid data
     }
     
-    // Check for over-boost condition
-    if (ecu_data->map_pressure > system_settings.max_boost_limit) {
+    // Check for over-boost condition (never on a value that stopped updating)
+    if (ecu_channel_is_fresh(ECU_CH_MAP_PRESSURE) && ecu_data->map_pressure > system_settings.max_boost_limit) {
         // Trigger over-boost alert
         #ifdef AUDIO_ALERTS_ENABLED
         if (system_settings.audio_alerts_enabled) {
@@ -121,7 +123,7 @@ static void handle_system_alerts(void)
     }
     
     // Check for over-rev condition
-    if (ecu_data->engine_rpm > system_settings.max_rpm_limit) {
+    if (ecu_channel_is_fresh(ECU_CH_ENGINE_RPM) && ecu_data->engine_rpm > system_settings.max_rpm_limit) {
         // Trigger over-rev alert
         #ifdef AUDIO_ALERTS_ENABLED
         if (system_settings.audio_alerts_enabled) {
@@ -232,8 +234,8 @@ void resume_operation(void)
  */
 void button_settings_pressed(void)
 {
-    // Switch to settings screen
-    lv_scr_load_anim(ui_SettingsScreen, LV_SCR_LOAD_ANIM_SLIDE_LEFT, 300, 0, false);
+    // Switch to settings screen (built on demand, freed again when left)
+    ui_screen_load_lazy(&ui_SettingsScreen, ui_SettingsScreen_screen_init, LV_SCR_LOAD_ANIM_SLIDE_LEFT, 300);
 }
 
 void button_back_pressed(void)
@@ -334,8 +336,8 @@ void handle_system_error(uint32_t error_code)
 {
     switch (error_code) {
         case CAN_ERROR_BUS_OFF:
-            // Attempt to restart CAN interface
-            can_interface_init();
+            // Reinstall the controller driver; decoded data and statistics are kept
+            ecu_can_supervisor_request_restart();
             break;
             
         case CAN_ERROR_TIMEOUT:
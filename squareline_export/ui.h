@@ -12,6 +12,9 @@ extern "C" {
 
 #include "lvgl.h"
 #include "ecu_data_structures.h"
+#include "ui_gauges.h"
+#include "ui_history.h"
+#include "ui_diagnostics.h"
 
 // Screen declarations
 extern lv_obj_t *ui_MainScreen;
@@ -25,12 +28,7 @@ extern lv_obj_t *ui_GaugeGrid;
 extern lv_obj_t *ui_StatusBanner;
 extern lv_obj_t *ui_ControlPanel;
 
-// Gauge objects
-extern lv_obj_t *ui_MapPressureGauge;
-extern lv_obj_t *ui_WastegateGauge;
-extern lv_obj_t *ui_TpsGauge;
-extern lv_obj_t *ui_RpmGauge;
-extern lv_obj_t *ui_TargetBoostGauge;
+// TCU status panel (numeric gauges are in ui_gauges[])
 extern lv_obj_t *ui_TcuStatusPanel;
 
 // Settings screen components
@@ -39,23 +37,25 @@ extern lv_obj_t *ui_SizeSlider;
 extern lv_obj_t *ui_ColumnsSlider;
 extern lv_obj_t *ui_StyleDropdown;
 
-// Value labels
-extern lv_obj_t *ui_MapValueLabel;
-extern lv_obj_t *ui_WastegateValueLabel;
-extern lv_obj_t *ui_TpsValueLabel;
-extern lv_obj_t *ui_RpmValueLabel;
-extern lv_obj_t *ui_TargetValueLabel;
-
 // Screen initialization functions
 void ui_MainScreen_screen_init(void);
 void ui_SettingsScreen_screen_init(void);
 
+/**
+ * Load a screen, creating it with screen_init if *screen is NULL.
+ * The screen is deleted (and *screen cleared) after it is unloaded,
+ * so it only occupies LVGL heap while it is shown.
+ */
+void ui_screen_load_lazy(lv_obj_t **screen, void (*screen_init)(void),
+                         lv_scr_load_anim_t anim, uint32_t time);
+
+/**
+ * @return Bytes currently allocated from the LVGL heap
+ */
+uint32_t ui_lvgl_heap_used(void);
+
 // Component creation functions
-void ui_create_map_pressure_gauge(void);
-void ui_create_wastegate_gauge(void);
-void ui_create_tps_gauge(void);
-void ui_create_rpm_gauge(void);
-void ui_create_target_boost_gauge(void);
+void ui_create_gauge(ui_gauge_t *gauge);
 void ui_create_tcu_status_panel(void);
 
 // Event handler functions
@@ -63,12 +63,15 @@ void ui_events_init(void);
 void ui_update_timer_callback(lv_timer_t *timer);
 void ui_settings_button_event_handler(lv_event_t *e);
 void ui_back_button_event_handler(lv_event_t *e);
+void ui_diagnostics_button_event_handler(lv_event_t *e);
 void ui_size_slider_event_handler(lv_event_t *e);
 void ui_columns_slider_event_handler(lv_event_t *e);
 
 // Data update functions
 void ui_set_ecu_data(const ecu_data_t *data);
+void ui_set_ecu_data_fx(const ecu_data_fx_t *data);
 void ui_set_connection_status(bool connected, const char *message);
+void ui_set_stale_channels(uint32_t stale_channels);   // (1 << ECU_CH_*) bits shown ghosted
 void ui_set_display_settings(const display_settings_t *settings);
 display_settings_t* ui_get_display_settings(void);
 
@@ -11,6 +11,7 @@ extern "C" {
 #endif
 
 #include "lvgl.h"
+#include "ui_gauges.h"
 
 // Screen objects
 extern lv_obj_t *ui_MainScreen;
@@ -19,20 +20,8 @@ extern lv_obj_t *ui_TitleLabel;
 extern lv_obj_t *ui_ConnectionStatus;
 extern lv_obj_t *ui_GaugeGrid;
 
-// Gauge objects
-extern lv_obj_t *ui_MapGauge;
-extern lv_obj_t *ui_WastegateGauge;
-extern lv_obj_t *ui_TpsGauge;
-extern lv_obj_t *ui_RpmGauge;
-extern lv_obj_t *ui_TargetGauge;
+// TCU panel (numeric gauges are in ui_gauges[])
 extern lv_obj_t *ui_TcuPanel;
-
-// Value labels
-extern lv_obj_t *ui_MapValueLabel;
-extern lv_obj_t *ui_WastegateValueLabel;
-extern lv_obj_t *ui_TpsValueLabel;
-extern lv_obj_t *ui_RpmValueLabel;
-extern lv_obj_t *ui_TargetValueLabel;
 extern lv_obj_t *ui_TcuStatusLabel;
 
 // Color definitions for SquareLine Studio
@@ -84,11 +73,7 @@ void ui_init(void);
 void ui_MainScreen_screen_init(void);
 
 // Gauge creation functions
-void ui_create_map_gauge(void);
-void ui_create_wastegate_gauge(void);
-void ui_create_tps_gauge(void);
-void ui_create_rpm_gauge(void);
-void ui_create_target_gauge(void);
+void ui_create_gauges(void);
 void ui_create_tcu_panel(void);
 
 // Real-time update functions
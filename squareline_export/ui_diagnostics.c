@@ -0,0 +1,263 @@
+/**
+ * CAN bus diagnostics screen for the ECU Dashboard
+ * Reads ecu_bus_stats snapshots, the ecu_latency histograms, the 0x381
+ * temperatures and the ISO-TP DTC list on a 2 Hz timer while the screen
+ * is shown
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ui.h"
+#include "ui_diagnostics.h"
+#include "ecu_bus_stats.h"
+#include "ecu_can_integration.h"
+#include "ecu_can_supervisor.h"
+#include "ecu_latency.h"
+
+lv_obj_t *ui_DiagnosticsScreen;
+
+static lv_obj_t *diag_summary_label;
+static lv_obj_t *diag_error_label;
+static lv_obj_t *diag_controller_label;
+static lv_obj_t *diag_id_labels[ECU_BUS_STATS_MAX_IDS];
+static lv_obj_t *diag_latency_labels[ECU_LAT_STAGE_COUNT];
+static lv_obj_t *diag_temps_label;
+static lv_obj_t *diag_dtc_label;
+static lv_timer_t *diag_timer;
+
+// Integer "x.y ms" parts of a microsecond value
+#define US_TO_MS_INT(us)    ((int)((us) / 1000u))
+#define US_TO_MS_FRAC(us)   ((int)(((us) % 1000u) / 100u))
+
+static void diagnostics_refresh(void)
+{
+    ecu_bus_snapshot_t snap;
+    ecu_bus_stats_get(&snap, ecu_bus_stats_now_us());
+
+    lv_label_set_text_fmt(diag_summary_label, "%s   %u frames/s   load %u.%u %%   unregistered %u/s   rejected %lu",
+                          snap.stale ? "NO TRAFFIC" : "Bus active",
+                          snap.frames_per_sec, snap.load_permille / 10u, snap.load_permille % 10u,
+                          snap.other_per_sec, (unsigned long)can_get_rejected_frames());
+    lv_obj_set_style_text_color(diag_summary_label,
+                                lv_color_hex(snap.stale ? COLOR_DANGER : COLOR_SUCCESS),
+                                LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    lv_label_set_text_fmt(diag_error_label, "Errors: bus-off %lu   passive %lu   timeout %lu   overrun %lu",
+                          (unsigned long)snap.errors[CAN_ERROR_BUS_OFF], (unsigned long)snap.errors[CAN_ERROR_PASSIVE],
+                          (unsigned long)snap.errors[CAN_ERROR_TIMEOUT], (unsigned long)snap.errors[CAN_ERROR_OVERRUN]);
+
+    // Controller state and recovery timing from the supervisor
+    ecu_can_sup_status_t sup;
+    char sup_text[200];
+    ecu_can_supervisor_get(&sup, ecu_can_supervisor_now_ms());
+    ecu_can_supervisor_format_text(&sup, sup_text, sizeof(sup_text));
+    lv_label_set_text(diag_controller_label, sup_text);
+    lv_obj_set_style_text_color(diag_controller_label,
+                                lv_color_hex(ecu_can_supervisor_bus_usable() ?
+                                             (sup.state == ECU_CAN_SUP_RUNNING ? COLOR_TEXT_SECONDARY : COLOR_WARNING) :
+                                             COLOR_DANGER),
+                                LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    for (uint8_t i = 0; i < ECU_BUS_STATS_MAX_IDS; i++) {
+        if (i >= snap.id_count) {
+            lv_obj_add_flag(diag_id_labels[i], LV_OBJ_FLAG_HIDDEN);
+            continue;
+        }
+
+        const ecu_bus_id_stats_t *id = &snap.ids[i];
+        lv_label_set_text_fmt(diag_id_labels[i],
+                              "0x%03lX   %3u / %3u Hz   interval %d.%d / %d.%d / %d.%d ms   jitter %d.%d ms   missed %lu",
+                              (unsigned long)id->can_id, id->frames_per_sec, id->expected_hz,
+                              US_TO_MS_INT(id->interval_min_us), US_TO_MS_FRAC(id->interval_min_us),
+                              US_TO_MS_INT(id->interval_avg_us), US_TO_MS_FRAC(id->interval_avg_us),
+                              US_TO_MS_INT(id->interval_max_us), US_TO_MS_FRAC(id->interval_max_us),
+                              US_TO_MS_INT(id->jitter_us), US_TO_MS_FRAC(id->jitter_us),
+                              (unsigned long)id->missed_deadlines);
+
+        // Below 90 % of the expected rate or any missed frame in this session
+        bool late = (id->expected_hz && id->frames_per_sec * 10u < id->expected_hz * 9u);
+        uint32_t color = late ? COLOR_DANGER : (id->missed_deadlines ? COLOR_WARNING : COLOR_TEXT_PRIMARY);
+        lv_obj_set_style_text_color(diag_id_labels[i], lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_clear_flag(diag_id_labels[i], LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+// CAN RX to pixel, one line per stage; total first
+static void diagnostics_refresh_latency(void)
+{
+    ecu_latency_hist_t hist;
+
+    for (int slot = 0; slot < ECU_LAT_STAGE_COUNT; slot++) {
+        if (!ecu_latency_get((ecu_latency_stage_t)slot, &hist)) {
+            lv_label_set_text_fmt(diag_latency_labels[slot], "%-8s  --", ecu_latency_stage_name((ecu_latency_stage_t)slot));
+            continue;
+        }
+
+        uint32_t p50 = ecu_latency_percentile_us(&hist, 50);
+        uint32_t p99 = ecu_latency_percentile_us(&hist, 99);
+        lv_label_set_text_fmt(diag_latency_labels[slot],
+                              "%-8s  p50 %d.%d ms   p99 %d.%d ms   max %d.%d ms   n %lu",
+                              ecu_latency_stage_name((ecu_latency_stage_t)slot),
+                              US_TO_MS_INT(p50), US_TO_MS_FRAC(p50),
+                              US_TO_MS_INT(p99), US_TO_MS_FRAC(p99),
+                              US_TO_MS_INT(hist.max_us), US_TO_MS_FRAC(hist.max_us),
+                              (unsigned long)hist.count);
+    }
+}
+
+// Advance pos by an snprintf() result, clamped to the buffer
+static size_t diag_append(size_t len, size_t pos, int n)
+{
+    if (n < 0) return pos;
+    pos += (size_t)n;
+    return pos < len ? pos : len - 1;
+}
+
+// Multiplexed 0x381 pages and the DTC list received over ISO-TP
+static void diagnostics_refresh_ecu(void)
+{
+    ecu_engine_temps_t temps;
+    char text[160];
+    size_t pos = 0;
+
+    ecu_get_engine_temps(&temps);
+    if (temps.valid & ECU_TEMPS_VALID_COOLANT) {
+        pos = diag_append(sizeof(text), pos, snprintf(text + pos, sizeof(text) - pos, "Coolant %s%d.%d C   ",
+                                                      temps.coolant < 0 ? "-" : "", abs(temps.coolant) / 10,
+                                                      abs(temps.coolant) % 10));
+    } else {
+        pos = diag_append(sizeof(text), pos, snprintf(text + pos, sizeof(text) - pos, "Coolant --   "));
+    }
+    if (temps.valid & ECU_TEMPS_VALID_OIL) {
+        pos = diag_append(sizeof(text), pos, snprintf(text + pos, sizeof(text) - pos, "Oil %s%d.%d C   EGT",
+                                                      temps.oil < 0 ? "-" : "", abs(temps.oil) / 10,
+                                                      abs(temps.oil) % 10));
+    } else {
+        pos = diag_append(sizeof(text), pos, snprintf(text + pos, sizeof(text) - pos, "Oil --   EGT"));
+    }
+    for (int cyl = 0; cyl < ECU_CYLINDERS; cyl++) {
+        if (temps.valid & (ECU_TEMPS_VALID_EGT1 << cyl)) {
+            pos = diag_append(sizeof(text), pos, snprintf(text + pos, sizeof(text) - pos, " %d", temps.egt[cyl] / 10));
+        } else {
+            pos = diag_append(sizeof(text), pos, snprintf(text + pos, sizeof(text) - pos, " --"));
+        }
+    }
+    snprintf(text + pos, sizeof(text) - pos, " C");
+    lv_label_set_text(diag_temps_label, text);
+
+    ecu_dtc_t dtcs[UI_DIAGNOSTICS_DTC_SHOWN];
+    size_t count = ecu_get_dtcs(dtcs, UI_DIAGNOSTICS_DTC_SHOWN);
+    pos = 0;
+    if (count == 0) {
+        pos = diag_append(sizeof(text), pos, snprintf(text + pos, sizeof(text) - pos, "DTC: none"));
+    } else {
+        pos = diag_append(sizeof(text), pos, snprintf(text + pos, sizeof(text) - pos, "DTC (%u):", (unsigned)count));
+        for (size_t i = 0; i < count && i < UI_DIAGNOSTICS_DTC_SHOWN; i++) {
+            char code[6];
+            ecu_dtc_format(dtcs[i].code, code);
+            pos = diag_append(sizeof(text), pos, snprintf(text + pos, sizeof(text) - pos, " %s/%02X", code, dtcs[i].status));
+        }
+        if (count > UI_DIAGNOSTICS_DTC_SHOWN) {
+            snprintf(text + pos, sizeof(text) - pos, " +%u", (unsigned)(count - UI_DIAGNOSTICS_DTC_SHOWN));
+        }
+    }
+    lv_label_set_text(diag_dtc_label, text);
+    lv_obj_set_style_text_color(diag_dtc_label, lv_color_hex(count ? COLOR_WARNING : COLOR_TEXT_PRIMARY),
+                                LV_PART_MAIN | LV_STATE_DEFAULT);
+}
+
+static void diagnostics_timer_cb(lv_timer_t *timer)
+{
+    LV_UNUSED(timer);
+    diagnostics_refresh();
+    diagnostics_refresh_latency();
+    diagnostics_refresh_ecu();
+}
+
+// Stop the refresh timer and clear handles when the screen goes away
+static void ui_DiagnosticsScreen_delete_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+    if (diag_timer) {
+        lv_timer_del(diag_timer);
+        diag_timer = NULL;
+    }
+    diag_summary_label = NULL;
+    diag_error_label = NULL;
+    diag_controller_label = NULL;
+    for (int i = 0; i < ECU_BUS_STATS_MAX_IDS; i++) {
+        diag_id_labels[i] = NULL;
+    }
+    for (int i = 0; i < ECU_LAT_STAGE_COUNT; i++) {
+        diag_latency_labels[i] = NULL;
+    }
+    diag_temps_label = NULL;
+    diag_dtc_label = NULL;
+}
+
+static lv_obj_t *diagnostics_label(lv_obj_t *parent, uint32_t color)
+{
+    lv_obj_t *label = lv_label_create(parent);
+    lv_obj_set_width(label, lv_pct(100));
+    lv_obj_set_height(label, LV_SIZE_CONTENT);
+    lv_label_set_text_static(label, "");
+    lv_obj_set_style_text_color(label, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+    return label;
+}
+
+void ui_DiagnosticsScreen_screen_init(void)
+{
+    ui_DiagnosticsScreen = lv_obj_create(NULL);
+    lv_obj_clear_flag(ui_DiagnosticsScreen, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_bg_color(ui_DiagnosticsScreen, lv_color_hex(COLOR_BACKGROUND), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(ui_DiagnosticsScreen, ui_DiagnosticsScreen_delete_cb, LV_EVENT_DELETE, NULL);
+
+    lv_obj_t *title = lv_label_create(ui_DiagnosticsScreen);
+    lv_obj_set_pos(title, 20, 15);
+    lv_label_set_text_static(title, "CAN Bus Diagnostics");
+    lv_obj_set_style_text_color(title, lv_color_hex(COLOR_TEXT_PRIMARY), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_24, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    lv_obj_t *back = lv_btn_create(ui_DiagnosticsScreen);
+    lv_obj_set_size(back, 100, 40);
+    lv_obj_set_align(back, LV_ALIGN_TOP_RIGHT);
+    lv_obj_set_pos(back, -20, 10);
+    lv_obj_add_event_cb(back, ui_back_button_event_handler, LV_EVENT_CLICKED, NULL);
+    lv_obj_t *back_label = lv_label_create(back);
+    lv_label_set_text_static(back_label, "Back");
+    lv_obj_center(back_label);
+
+    lv_obj_t *panel = lv_obj_create(ui_DiagnosticsScreen);
+    lv_obj_set_width(panel, lv_pct(95));
+    lv_obj_set_height(panel, lv_pct(80));
+    lv_obj_set_align(panel, LV_ALIGN_BOTTOM_MID);
+    lv_obj_set_y(panel, -15);
+    lv_obj_set_flex_flow(panel, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_scroll_dir(panel, LV_DIR_VER);
+    lv_obj_set_style_pad_row(panel, 8, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(panel, lv_color_hex(COLOR_CARD), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    diag_summary_label = diagnostics_label(panel, COLOR_TEXT_PRIMARY);
+    diag_error_label = diagnostics_label(panel, COLOR_TEXT_SECONDARY);
+    diag_controller_label = diagnostics_label(panel, COLOR_TEXT_SECONDARY);
+    for (int i = 0; i < ECU_BUS_STATS_MAX_IDS; i++) {
+        diag_id_labels[i] = diagnostics_label(panel, COLOR_TEXT_PRIMARY);
+    }
+
+    lv_obj_t *latency_title = diagnostics_label(panel, COLOR_TEXT_SECONDARY);
+    lv_label_set_text_static(latency_title, "Latency, MAP change to glass");
+    for (int i = 0; i < ECU_LAT_STAGE_COUNT; i++) {
+        diag_latency_labels[i] = diagnostics_label(panel, COLOR_TEXT_PRIMARY);
+    }
+
+    lv_obj_t *ecu_title = diagnostics_label(panel, COLOR_TEXT_SECONDARY);
+    lv_label_set_text_static(ecu_title, "ECU temperatures (0x381) and trouble codes (0x3A0)");
+    diag_temps_label = diagnostics_label(panel, COLOR_TEXT_PRIMARY);
+    diag_dtc_label = diagnostics_label(panel, COLOR_TEXT_PRIMARY);
+
+    diagnostics_refresh();
+    diagnostics_refresh_latency();
+    diagnostics_refresh_ecu();
+    diag_timer = lv_timer_create(diagnostics_timer_cb, UI_DIAGNOSTICS_PERIOD_MS, NULL);
+}
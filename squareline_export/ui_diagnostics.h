@@ -0,0 +1,33 @@
+/**
+ * CAN bus diagnostics screen for the ECU Dashboard
+ * Per-ID rate, inter-arrival jitter, missed deadlines, bus load, errors,
+ * the CAN-to-display latency histograms, engine temperatures and DTCs
+ */
+
+#ifndef UI_DIAGNOSTICS_H
+#define UI_DIAGNOSTICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+// Refresh period of the diagnostics screen
+#define UI_DIAGNOSTICS_PERIOD_MS    500
+// DTCs listed by code; the rest are counted
+#define UI_DIAGNOSTICS_DTC_SHOWN    8
+
+extern lv_obj_t *ui_DiagnosticsScreen;
+
+/**
+ * Create the diagnostics screen (load it with ui_screen_load_lazy).
+ * Its refresh timer lives and dies with the screen.
+ */
+void ui_DiagnosticsScreen_screen_init(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // UI_DIAGNOSTICS_H
@@ -5,11 +5,14 @@
 
 #include "ui.h"
 #include "ecu_data_structures.h"
+#include "ecu_bus_stats.h"
+#include "ecu_latency.h"
 
 // Global variables for current data
-static ecu_data_t current_ecu_data = {0};
+static ecu_data_fx_t current_ecu_data = {0};
 static display_settings_t current_display_settings = {0};
 static connection_status_t current_connection_status = {0};
+static uint32_t current_stale_channels = 0;
 
 // Timer for periodic updates
 static lv_timer_t *update_timer;
@@ -44,6 +47,9 @@ void ui_update_timer_callback(lv_timer_t *timer)
     
     // Update all gauges with current data
     ui_update_gauges();
+
+    // Redraw the history chart when its tier has new buckets
+    ui_history_refresh();
     
     // Update connection status
     ui_update_connection_status();
@@ -52,86 +58,25 @@ void ui_update_timer_callback(lv_timer_t *timer)
 // Update all gauge values and colors
 void ui_update_gauges(void)
 {
-    // Update MAP pressure gauge
-    if (current_display_settings.visible_gauges & GAUGE_MAP_VISIBLE) {
-        ui_animate_gauge_transition(ui_MapPressureGauge, (int32_t)current_ecu_data.map_pressure);
-        
-        // Update value label
-        char value_str[16];
-        snprintf(value_str, sizeof(value_str), "%.1f", current_ecu_data.map_pressure);
-        lv_label_set_text(ui_MapValueLabel, value_str);
-        
-        // Check thresholds and update color
-        if (current_ecu_data.map_pressure >= 245.0f) {
-            lv_obj_set_style_arc_color(ui_MapPressureGauge, lv_color_hex(COLOR_DANGER), LV_PART_INDICATOR);
-            lv_obj_set_style_text_color(ui_MapValueLabel, lv_color_hex(COLOR_DANGER), LV_PART_MAIN);
-        } else if (current_ecu_data.map_pressure >= 230.0f) {
-            lv_obj_set_style_arc_color(ui_MapPressureGauge, lv_color_hex(COLOR_WARNING), LV_PART_INDICATOR);
-            lv_obj_set_style_text_color(ui_MapValueLabel, lv_color_hex(COLOR_WARNING), LV_PART_MAIN);
-        } else {
-            lv_obj_set_style_arc_color(ui_MapPressureGauge, lv_color_hex(COLOR_ACCENT), LV_PART_INDICATOR);
-            lv_obj_set_style_text_color(ui_MapValueLabel, lv_color_hex(COLOR_ACCENT), LV_PART_MAIN);
-        }
-    }
-
-    // Update Wastegate gauge
-    if (current_display_settings.visible_gauges & GAUGE_WASTEGATE_VISIBLE) {
-        ui_animate_gauge_transition(ui_WastegateGauge, (int32_t)current_ecu_data.wastegate_position);
-        
-        char value_str[16];
-        snprintf(value_str, sizeof(value_str), "%.1f", current_ecu_data.wastegate_position);
-        lv_label_set_text(ui_WastegateValueLabel, value_str);
-    }
-
-    // Update TPS gauge
-    if (current_display_settings.visible_gauges & GAUGE_TPS_VISIBLE) {
-        ui_animate_gauge_transition(ui_TpsGauge, (int32_t)current_ecu_data.tps_position);
-        
-        char value_str[16];
-        snprintf(value_str, sizeof(value_str), "%.1f", current_ecu_data.tps_position);
-        lv_label_set_text(ui_TpsValueLabel, value_str);
-    }
-
-    // Update RPM gauge
-    if (current_display_settings.visible_gauges & GAUGE_RPM_VISIBLE) {
-        ui_animate_gauge_transition(ui_RpmGauge, (int32_t)current_ecu_data.engine_rpm);
-        
-        char value_str[16];
-        snprintf(value_str, sizeof(value_str), "%.0f", current_ecu_data.engine_rpm);
-        lv_label_set_text(ui_RpmValueLabel, value_str);
-        
-        // RPM threshold colors
-        if (current_ecu_data.engine_rpm >= 6500.0f) {
-            lv_obj_set_style_arc_color(ui_RpmGauge, lv_color_hex(COLOR_DANGER), LV_PART_INDICATOR);
-            lv_obj_set_style_text_color(ui_RpmValueLabel, lv_color_hex(COLOR_DANGER), LV_PART_MAIN);
-        } else if (current_ecu_data.engine_rpm >= 6000.0f) {
-            lv_obj_set_style_arc_color(ui_RpmGauge, lv_color_hex(COLOR_WARNING), LV_PART_INDICATOR);
-            lv_obj_set_style_text_color(ui_RpmValueLabel, lv_color_hex(COLOR_WARNING), LV_PART_MAIN);
-        } else {
-            lv_obj_set_style_arc_color(ui_RpmGauge, lv_color_hex(COLOR_WARNING), LV_PART_INDICATOR);
-            lv_obj_set_style_text_color(ui_RpmValueLabel, lv_color_hex(COLOR_WARNING), LV_PART_MAIN);
-        }
-    }
+    // Numeric gauges: one loop over the registry, ghosted where the channel is stale
+    ui_gauges_update(&current_ecu_data, current_display_settings.visible_gauges, true);
+    ui_gauges_set_stale_mask(current_stale_channels);
 
-    // Update Target Boost gauge
-    if (current_display_settings.visible_gauges & GAUGE_TARGET_VISIBLE) {
-        ui_animate_gauge_transition(ui_TargetBoostGauge, (int32_t)current_ecu_data.target_boost);
-        
-        char value_str[16];
-        snprintf(value_str, sizeof(value_str), "%.1f", current_ecu_data.target_boost);
-        lv_label_set_text(ui_TargetValueLabel, value_str);
-    }
-
-    // Update TCU Status
+    // Update TCU Status (same message as the torque request)
     if (current_display_settings.visible_gauges & GAUGE_TCU_VISIBLE) {
-        if (current_ecu_data.tcu_limp_mode) {
+        if (current_stale_channels & (1u << ECU_CH_TORQUE_REQUEST)) {
+            lv_obj_set_style_border_color(ui_TcuStatusPanel, lv_color_hex(COLOR_TEXT_SECONDARY), LV_PART_MAIN);
+        } else if (current_ecu_data.flags & ECU_FX_FLAG_TCU_LIMP) {
             lv_obj_set_style_border_color(ui_TcuStatusPanel, lv_color_hex(COLOR_DANGER), LV_PART_MAIN);
-        } else if (current_ecu_data.tcu_protection_active) {
+        } else if (current_ecu_data.flags & ECU_FX_FLAG_TCU_PROTECTION) {
             lv_obj_set_style_border_color(ui_TcuStatusPanel, lv_color_hex(COLOR_WARNING), LV_PART_MAIN);
         } else {
             lv_obj_set_style_border_color(ui_TcuStatusPanel, lv_color_hex(COLOR_SUCCESS), LV_PART_MAIN);
         }
     }
+
+    // Widgets are invalidated; the next refresh renders the traced sample
+    ecu_latency_mark(ECU_LAT_UI_UPDATE, ecu_bus_stats_now_us());
 }
 
 // Smooth gauge animation
@@ -153,11 +98,32 @@ void ui_animate_gauge_transition(lv_obj_t *gauge, int32_t new_value)
 // Update connection status display
 void ui_update_connection_status(void)
 {
+    ecu_bus_snapshot_t bus;
+    ecu_bus_stats_get(&bus, ecu_bus_stats_now_us());
+    
+    // Decoded frames per second; only relabel when the rate or state changes
+    uint16_t data_rate = 0;
+    for (uint8_t i = 0; i < bus.id_count; i++) {
+        data_rate += bus.ids[i].frames_per_sec;
+    }
+    
+    static int8_t shown_connected = -1;
+    static const char *shown_message = NULL;
+    if (current_connection_status.connected == shown_connected &&
+        current_connection_status.data_rate == data_rate &&
+        current_connection_status.message == shown_message) {
+        return;
+    }
+    current_connection_status.data_rate = data_rate;
+    shown_connected = current_connection_status.connected;
+    shown_message = current_connection_status.message;
+    
     if (current_connection_status.connected) {
-        lv_label_set_text(ui_ConnectionStatus, "Connected");
+        lv_label_set_text_fmt(ui_ConnectionStatus, "Connected  %u Hz", data_rate);
         lv_obj_set_style_text_color(ui_ConnectionStatus, lv_color_hex(COLOR_SUCCESS), LV_PART_MAIN);
     } else {
-        lv_label_set_text(ui_ConnectionStatus, "Disconnected");
+        lv_label_set_text(ui_ConnectionStatus, current_connection_status.message ? current_connection_status.message
+                                                                                  : "Disconnected");
         lv_obj_set_style_text_color(ui_ConnectionStatus, lv_color_hex(COLOR_DANGER), LV_PART_MAIN);
     }
 }
@@ -168,7 +134,17 @@ void ui_settings_button_event_handler(lv_event_t *e)
     lv_event_code_t code = lv_event_get_code(e);
     
     if (code == LV_EVENT_CLICKED) {
-        lv_scr_load_anim(ui_SettingsScreen, LV_SCR_LOAD_ANIM_SLIDE_LEFT, 300, 0, false);
+        ui_screen_load_lazy(&ui_SettingsScreen, ui_SettingsScreen_screen_init, LV_SCR_LOAD_ANIM_SLIDE_LEFT, 300);
+    }
+}
+
+// Event handler for diagnostics button
+void ui_diagnostics_button_event_handler(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    
+    if (code == LV_EVENT_CLICKED) {
+        ui_screen_load_lazy(&ui_DiagnosticsScreen, ui_DiagnosticsScreen_screen_init, LV_SCR_LOAD_ANIM_SLIDE_LEFT, 300);
     }
 }
 
@@ -218,47 +194,43 @@ void ui_apply_display_settings(void)
         case 3: gauge_size = 300; break;  // XLarge
     }
     
-    // Apply size to all gauges
-    lv_obj_set_size(ui_MapPressureGauge, gauge_size, gauge_size);
-    lv_obj_set_size(ui_WastegateGauge, gauge_size, gauge_size);
-    lv_obj_set_size(ui_TpsGauge, gauge_size, gauge_size);
-    lv_obj_set_size(ui_RpmGauge, gauge_size, gauge_size);
-    lv_obj_set_size(ui_TargetBoostGauge, gauge_size, gauge_size);
+    // Apply size and visibility to all registry gauges
+    ui_gauges_apply_layout(gauge_size, current_display_settings.visible_gauges);
+
     lv_obj_set_size(ui_TcuStatusPanel, gauge_size, gauge_size);
-    
-    // Update grid layout based on columns
-    lv_obj_set_flex_flow(ui_GaugeGrid, LV_FLEX_FLOW_ROW_WRAP);
-    
-    // Hide/show gauges based on visibility settings
-    lv_obj_add_flag(ui_MapPressureGauge, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(ui_WastegateGauge, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(ui_TpsGauge, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(ui_RpmGauge, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(ui_TargetBoostGauge, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(ui_TcuStatusPanel, LV_OBJ_FLAG_HIDDEN);
-    
-    if (current_display_settings.visible_gauges & GAUGE_MAP_VISIBLE)
-        lv_obj_clear_flag(ui_MapPressureGauge, LV_OBJ_FLAG_HIDDEN);
-    if (current_display_settings.visible_gauges & GAUGE_WASTEGATE_VISIBLE)
-        lv_obj_clear_flag(ui_WastegateGauge, LV_OBJ_FLAG_HIDDEN);
-    if (current_display_settings.visible_gauges & GAUGE_TPS_VISIBLE)
-        lv_obj_clear_flag(ui_TpsGauge, LV_OBJ_FLAG_HIDDEN);
-    if (current_display_settings.visible_gauges & GAUGE_RPM_VISIBLE)
-        lv_obj_clear_flag(ui_RpmGauge, LV_OBJ_FLAG_HIDDEN);
-    if (current_display_settings.visible_gauges & GAUGE_TARGET_VISIBLE)
-        lv_obj_clear_flag(ui_TargetBoostGauge, LV_OBJ_FLAG_HIDDEN);
     if (current_display_settings.visible_gauges & GAUGE_TCU_VISIBLE)
         lv_obj_clear_flag(ui_TcuStatusPanel, LV_OBJ_FLAG_HIDDEN);
+    else
+        lv_obj_add_flag(ui_TcuStatusPanel, LV_OBJ_FLAG_HIDDEN);
+
+    // History chart spans two gauge cells
+    ui_history_set_size(gauge_size * 2 + 10, gauge_size);
+
+    // Update grid layout based on columns
+    lv_obj_set_flex_flow(ui_GaugeGrid, LV_FLEX_FLOW_ROW_WRAP);
 }
 
 // Public API functions for updating data
 void ui_set_ecu_data(const ecu_data_t *data)
+{
+    if (data) {
+        ecu_fx_from_float(data, &current_ecu_data);
+    }
+}
+
+void ui_set_ecu_data_fx(const ecu_data_fx_t *data)
 {
     if (data) {
         current_ecu_data = *data;
+        ecu_latency_mark(ECU_LAT_PUBLISH, ecu_bus_stats_now_us());
     }
 }
 
+void ui_set_stale_channels(uint32_t stale_channels)
+{
+    current_stale_channels = stale_channels;
+}
+
 void ui_set_connection_status(bool connected, const char *message)
 {
     current_connection_status.connected = connected;
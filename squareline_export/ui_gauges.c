@@ -0,0 +1,220 @@
+/**
+ * Data-driven gauge registry for the ECU Dashboard
+ * Update, hide/show and resize are loops over one contiguous table
+ */
+
+#include "ui_gauges.h"
+
+// Gauge configurations (24-bit RGB colors for lv_color_hex)
+static const gauge_config_t gauge_configs[UI_GAUGE_COUNT] = {
+    [UI_GAUGE_MAP] = {
+        .title = "MAP", .subtitle = "Manifold Pressure", .unit = "kPa",
+        .min_value = 100.0f, .max_value = 250.0f,
+        .warning_threshold = 230.0f, .danger_threshold = 245.0f,
+        .color = 0x00D4FF, .warning_color = 0xFF6B35, .danger_color = 0xFF3366
+    },
+    [UI_GAUGE_WASTEGATE] = {
+        .title = "Wastegate", .subtitle = "Wastegate Position", .unit = "%",
+        .min_value = 0.0f, .max_value = 100.0f,
+        .warning_threshold = GAUGE_THRESHOLD_NONE, .danger_threshold = GAUGE_THRESHOLD_NONE,
+        .color = 0x00FF88, .warning_color = 0xFF6B35, .danger_color = 0xFF3366
+    },
+    [UI_GAUGE_TPS] = {
+        .title = "TPS", .subtitle = "Throttle Position", .unit = "%",
+        .min_value = 0.0f, .max_value = 100.0f,
+        .warning_threshold = GAUGE_THRESHOLD_NONE, .danger_threshold = GAUGE_THRESHOLD_NONE,
+        .color = 0xFFD700, .warning_color = 0xFF6B35, .danger_color = 0xFF3366
+    },
+    [UI_GAUGE_RPM] = {
+        .title = "RPM", .subtitle = "Engine Speed", .unit = "RPM",
+        .min_value = 0.0f, .max_value = 7000.0f,
+        .warning_threshold = 6000.0f, .danger_threshold = 6500.0f,
+        .color = 0xFF6B35, .warning_color = 0xFF6B35, .danger_color = 0xFF3366
+    },
+    [UI_GAUGE_TARGET_BOOST] = {
+        .title = "Target", .subtitle = "Target Boost", .unit = "kPa",
+        .min_value = 100.0f, .max_value = 250.0f,
+        .warning_threshold = GAUGE_THRESHOLD_NONE, .danger_threshold = GAUGE_THRESHOLD_NONE,
+        .color = 0xFFD700, .warning_color = 0xFF6B35, .danger_color = 0xFF3366
+    },
+};
+
+ui_gauge_t ui_gauges[UI_GAUGE_COUNT] = {
+    [UI_GAUGE_MAP] = {
+        .channel = ECU_CH_MAP_PRESSURE, .config = &gauge_configs[UI_GAUGE_MAP],
+        .visible_bit = GAUGE_MAP_VISIBLE, .decimals = 1
+    },
+    [UI_GAUGE_WASTEGATE] = {
+        .channel = ECU_CH_WASTEGATE_POSITION, .config = &gauge_configs[UI_GAUGE_WASTEGATE],
+        .visible_bit = GAUGE_WASTEGATE_VISIBLE, .decimals = 1
+    },
+    [UI_GAUGE_TPS] = {
+        .channel = ECU_CH_TPS_POSITION, .config = &gauge_configs[UI_GAUGE_TPS],
+        .visible_bit = GAUGE_TPS_VISIBLE, .decimals = 1
+    },
+    [UI_GAUGE_RPM] = {
+        .channel = ECU_CH_ENGINE_RPM, .config = &gauge_configs[UI_GAUGE_RPM],
+        .visible_bit = GAUGE_RPM_VISIBLE, .decimals = 0
+    },
+    [UI_GAUGE_TARGET_BOOST] = {
+        .channel = ECU_CH_TARGET_BOOST, .config = &gauge_configs[UI_GAUGE_TARGET_BOOST],
+        .visible_bit = GAUGE_TARGET_VISIBLE, .decimals = 1
+    },
+};
+
+// Level that was never rendered, forces a restyle
+#define UI_GAUGE_LEVEL_UNSET    0xFF
+
+// Opacity of indicator and value while the data is stale
+#define UI_GAUGE_STALE_OPA      LV_OPA_40
+
+// Engineering units to 0.1 units; GAUGE_THRESHOLD_NONE maps to INT32_MAX
+static int32_t to_tenths(float value)
+{
+    if (value >= (float)(INT32_MAX / 10)) return INT32_MAX;
+    return (int32_t)(value * 10.0f + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+void ui_gauges_invalidate(void)
+{
+    for (int i = 0; i < UI_GAUGE_COUNT; i++) {
+        ui_gauges[i].last_value = INT32_MIN;
+        ui_gauges[i].last_level = UI_GAUGE_LEVEL_UNSET;
+        ui_gauges[i].stale = false;     // Freshly created objects are fully opaque
+        ui_gauges[i].warning_tenths = to_tenths(ui_gauges[i].config->warning_threshold);
+        ui_gauges[i].danger_tenths = to_tenths(ui_gauges[i].config->danger_threshold);
+    }
+}
+
+// Round to the label precision, in 0.1 units
+static int32_t round_to_precision(int32_t tenths, uint8_t decimals)
+{
+    if (decimals == 0) {
+        int32_t whole = (tenths + (tenths >= 0 ? 5 : -5)) / 10;
+        tenths = whole * 10;
+    }
+    return tenths;
+}
+
+static void arc_anim_exec_cb(void* var, int32_t value)
+{
+    lv_arc_set_value((lv_obj_t*)var, value);
+}
+
+static void set_arc_value(lv_obj_t* arc, int32_t value, bool animate)
+{
+    if (!animate) {
+        lv_anim_del(arc, arc_anim_exec_cb);
+        lv_arc_set_value(arc, value);
+        return;
+    }
+
+    lv_anim_t anim;
+    lv_anim_init(&anim);
+    lv_anim_set_var(&anim, arc);
+    lv_anim_set_values(&anim, lv_arc_get_value(arc), value);
+    lv_anim_set_time(&anim, 200);  // 200ms animation
+    lv_anim_set_exec_cb(&anim, arc_anim_exec_cb);
+    lv_anim_set_path_cb(&anim, lv_anim_path_ease_out);
+    lv_anim_start(&anim);
+}
+
+void ui_gauge_set_tenths(ui_gauge_t* gauge, int32_t tenths, bool animate)
+{
+    const gauge_config_t* config = gauge->config;
+
+    int32_t scaled = round_to_precision(tenths, gauge->decimals);
+    if (scaled != gauge->last_value) {
+        gauge->last_value = scaled;
+
+        if (gauge->arc) {
+            set_arc_value(gauge->arc, scaled / 10, animate);
+        }
+        if (gauge->value_label) {
+            if (gauge->decimals == 0) {
+                lv_label_set_text_fmt(gauge->value_label, "%d", (int)(scaled / 10));
+            } else {
+                int32_t mag = scaled < 0 ? -scaled : scaled;
+                lv_label_set_text_fmt(gauge->value_label, "%s%d.%d", scaled < 0 ? "-" : "",
+                                      (int)(mag / 10), (int)(mag % 10));
+            }
+        }
+    }
+
+    uint8_t level = UI_GAUGE_LEVEL_NORMAL;
+    if (tenths >= gauge->danger_tenths) {
+        level = UI_GAUGE_LEVEL_DANGER;
+    } else if (tenths >= gauge->warning_tenths) {
+        level = UI_GAUGE_LEVEL_WARNING;
+    }
+
+    if (level != gauge->last_level) {
+        gauge->last_level = level;
+
+        uint32_t color = config->color;
+        if (level == UI_GAUGE_LEVEL_DANGER) {
+            color = config->danger_color;
+        } else if (level == UI_GAUGE_LEVEL_WARNING) {
+            color = config->warning_color;
+        }
+        if (gauge->arc) {
+            lv_obj_set_style_arc_color(gauge->arc, lv_color_hex(color), LV_PART_INDICATOR | LV_STATE_DEFAULT);
+        }
+        if (gauge->value_label) {
+            lv_obj_set_style_text_color(gauge->value_label, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+        }
+    }
+}
+
+void ui_gauge_set_value(ui_gauge_t* gauge, float value, bool animate)
+{
+    ui_gauge_set_tenths(gauge, to_tenths(value), animate);
+}
+
+void ui_gauges_update(const ecu_data_fx_t* data, uint8_t visible_gauges, bool animate)
+{
+    for (int i = 0; i < UI_GAUGE_COUNT; i++) {
+        ui_gauge_t* gauge = &ui_gauges[i];
+        if (visible_gauges & gauge->visible_bit) {
+            ui_gauge_set_tenths(gauge, ecu_fx_get_tenths(data, gauge->channel), animate);
+        }
+    }
+}
+
+void ui_gauges_set_stale_mask(uint32_t stale_channels)
+{
+    for (int i = 0; i < UI_GAUGE_COUNT; i++) {
+        ui_gauge_t* gauge = &ui_gauges[i];
+        bool stale = (stale_channels & (1u << gauge->channel)) != 0;
+        if (stale == gauge->stale) continue;
+        gauge->stale = stale;
+
+        lv_opa_t opa = stale ? UI_GAUGE_STALE_OPA : LV_OPA_COVER;
+        if (gauge->arc) {
+            lv_obj_set_style_arc_opa(gauge->arc, opa, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+        }
+        if (gauge->value_label) {
+            lv_obj_set_style_text_opa(gauge->value_label, opa, LV_PART_MAIN | LV_STATE_DEFAULT);
+        }
+    }
+}
+
+void ui_gauges_set_stale(bool stale)
+{
+    ui_gauges_set_stale_mask(stale ? (1u << ECU_CH_COUNT) - 1u : 0);
+}
+
+void ui_gauges_apply_layout(lv_coord_t size, uint8_t visible_gauges)
+{
+    for (int i = 0; i < UI_GAUGE_COUNT; i++) {
+        lv_obj_t* arc = ui_gauges[i].arc;
+        if (arc == NULL) continue;
+
+        lv_obj_set_size(arc, size, size);
+        if (visible_gauges & ui_gauges[i].visible_bit) {
+            lv_obj_clear_flag(arc, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(arc, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * Data-driven gauge registry for the ECU Dashboard
+ * One entry per numeric gauge: channel, configuration, LVGL handles and last rendered state
+ */
+
+#ifndef UI_GAUGES_H
+#define UI_GAUGES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+#include "ecu_data_structures.h"
+
+// Gauge indices into ui_gauges[]
+typedef enum {
+    UI_GAUGE_MAP = 0,
+    UI_GAUGE_WASTEGATE,
+    UI_GAUGE_TPS,
+    UI_GAUGE_RPM,
+    UI_GAUGE_TARGET_BOOST,
+    UI_GAUGE_COUNT
+} ui_gauge_id_t;
+
+// Gauge alert levels
+#define UI_GAUGE_LEVEL_NORMAL   0
+#define UI_GAUGE_LEVEL_WARNING  1
+#define UI_GAUGE_LEVEL_DANGER   2
+
+// Registry entry
+typedef struct {
+    ecu_channel_t channel;           // Source channel in ecu_data_t
+    const gauge_config_t* config;    // Static configuration (flash)
+    lv_obj_t* arc;                   // Arc object, created by the screen
+    lv_obj_t* value_label;           // Value label, created by the screen
+    int32_t last_value;              // Last rendered value in 0.1 units
+    int32_t warning_tenths;          // config->warning_threshold in 0.1 units
+    int32_t danger_tenths;           // config->danger_threshold in 0.1 units
+    uint8_t visible_bit;             // GAUGE_*_VISIBLE bit in display_settings_t.visible_gauges
+    uint8_t decimals;                // Value label precision (0 or 1)
+    uint8_t last_level;              // Last rendered UI_GAUGE_LEVEL_*
+    bool stale;                      // Rendered ghosted (channel not live)
+} ui_gauge_t;
+
+extern ui_gauge_t ui_gauges[UI_GAUGE_COUNT];
+
+/**
+ * Forget the last rendered state so the next update redraws every gauge
+ * Call after (re)creating the gauge objects
+ */
+void ui_gauges_invalidate(void);
+
+/**
+ * Render a value on one gauge; does nothing if the rounded value is unchanged
+ * @param gauge Registry entry
+ * @param tenths Value in 0.1 engineering units
+ * @param animate Animate the arc to the new value
+ */
+void ui_gauge_set_tenths(ui_gauge_t* gauge, int32_t tenths, bool animate);
+
+/**
+ * Float convenience wrapper for ui_gauge_set_tenths()
+ * @param gauge Registry entry
+ * @param value Value in engineering units
+ * @param animate Animate the arc to the new value
+ */
+void ui_gauge_set_value(ui_gauge_t* gauge, float value, bool animate);
+
+/**
+ * Render all visible gauges from a fixed-point ECU snapshot (integer only)
+ * @param data ECU data in raw CAN units
+ * @param visible_gauges GAUGE_*_VISIBLE bitmask
+ * @param animate Animate the arcs to the new values
+ */
+void ui_gauges_update(const ecu_data_fx_t* data, uint8_t visible_gauges, bool animate);
+
+/**
+ * Ghost the gauges whose channel is not live; the last values stay
+ * visible but dimmed instead of looking current. Only gauges whose state
+ * changes are restyled.
+ * @param stale_channels Bitmask of (1 << ECU_CH_*), e.g. ecu_stale_channels()
+ */
+void ui_gauges_set_stale_mask(uint32_t stale_channels);
+
+/**
+ * Ghost or restore all gauges at once (bus down, no data)
+ * @param stale true to dim, false to restore
+ */
+void ui_gauges_set_stale(bool stale);
+
+/**
+ * Apply size and visibility to all gauges
+ * @param size Gauge width and height in pixels
+ * @param visible_gauges GAUGE_*_VISIBLE bitmask
+ */
+void ui_gauges_apply_layout(lv_coord_t size, uint8_t visible_gauges);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // UI_GAUGES_H
@@ -0,0 +1,197 @@
+/**
+ * Boost history chart for the ECU Dashboard
+ * Series data lives in static buffers (not the LVGL heap) and is rebuilt from
+ * ecu_history only when the displayed tier commits a new bucket
+ */
+
+#include "ui_history.h"
+#include "ui_gauges.h"
+#include "ecu_stats.h"
+
+lv_obj_t *ui_HistoryPanel;
+lv_obj_t *ui_HistoryChart;
+
+static lv_obj_t *history_tier_label;
+static lv_obj_t *history_peak_label;
+
+// External series buffers, one point per pixel column at most
+static lv_coord_t boost_max_points[UI_HISTORY_MAX_POINTS];
+static lv_coord_t boost_min_points[UI_HISTORY_MAX_POINTS];
+static lv_coord_t target_points[UI_HISTORY_MAX_POINTS];
+static lv_coord_t wastegate_points[UI_HISTORY_MAX_POINTS];
+static int16_t scratch_min[UI_HISTORY_MAX_POINTS];
+static int16_t scratch_max[UI_HISTORY_MAX_POINTS];
+
+static ecu_history_tier_t history_tier = ECU_HISTORY_TIER_10S;
+static uint32_t history_drawn_revision;
+static uint16_t history_points;
+static int32_t history_peak_shown = INT32_MIN;   // Peak boost on screen, 0.1 kPa
+
+static const char *const tier_names[ECU_HISTORY_TIER_COUNT] = {
+    [ECU_HISTORY_TIER_10S]   = "10 s",
+    [ECU_HISTORY_TIER_1MIN]  = "1 min",
+    [ECU_HISTORY_TIER_10MIN] = "10 min",
+};
+
+// Copy one reduced channel into a series buffer
+static void copy_points(lv_coord_t *dst, const int16_t *src, uint16_t points)
+{
+    for (uint16_t i = 0; i < points; i++) {
+        dst[i] = (src[i] == ECU_HISTORY_NO_DATA) ? LV_CHART_POINT_NONE : src[i];
+    }
+}
+
+// Match the point count to the chart content width
+static void history_update_point_count(void)
+{
+    lv_coord_t width = lv_obj_get_content_width(ui_HistoryChart);
+    uint16_t points = (width > UI_HISTORY_MAX_POINTS) ? UI_HISTORY_MAX_POINTS : (width < 2 ? 2 : width);
+
+    if (points != history_points) {
+        history_points = points;
+        lv_chart_set_point_count(ui_HistoryChart, points);
+    }
+}
+
+// Peak boost since the last reset, read lazily with each redraw
+static void history_update_peak(void)
+{
+    ecu_channel_stats_t stats;
+
+    if (ecu_stats_pull(ECU_CH_MAP_PRESSURE, &stats, false)) {
+        int32_t tenths = (int32_t)(stats.max * 10.0f + 0.5f);
+        if (tenths != history_peak_shown) {
+            history_peak_shown = tenths;
+            lv_label_set_text_fmt(history_peak_label, "Peak %d.%d", (int)(tenths / 10), (int)(tenths % 10));
+        }
+    } else if (history_peak_shown != INT32_MIN) {
+        history_peak_shown = INT32_MIN;
+        lv_label_set_text_static(history_peak_label, "Peak --");
+    }
+}
+
+static void history_redraw(void)
+{
+    history_update_point_count();
+
+    ecu_history_read(history_tier, ECU_HISTORY_BOOST, scratch_min, scratch_max, history_points);
+    copy_points(boost_min_points, scratch_min, history_points);
+    copy_points(boost_max_points, scratch_max, history_points);
+
+    ecu_history_read(history_tier, ECU_HISTORY_TARGET, scratch_min, scratch_max, history_points);
+    copy_points(target_points, scratch_max, history_points);
+
+    ecu_history_read(history_tier, ECU_HISTORY_WASTEGATE, scratch_min, scratch_max, history_points);
+    copy_points(wastegate_points, scratch_max, history_points);
+
+    lv_chart_refresh(ui_HistoryChart);
+    history_update_peak();
+    history_drawn_revision = ecu_history_revision(history_tier);
+}
+
+// Tap cycles through the tiers, long press clears the peak hold
+static void history_panel_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_SHORT_CLICKED) {
+        ui_history_set_tier((ecu_history_tier_t)((history_tier + 1) % ECU_HISTORY_TIER_COUNT));
+    } else if (code == LV_EVENT_LONG_PRESSED) {
+        ecu_channel_stats_t stats;
+        ecu_stats_pull(ECU_CH_MAP_PRESSURE, &stats, true);
+        history_update_peak();
+    }
+}
+
+static void add_series(uint32_t color, lv_chart_axis_t axis, lv_coord_t *buffer)
+{
+    lv_chart_series_t *ser = lv_chart_add_series(ui_HistoryChart, lv_color_hex(color), axis);
+    lv_chart_set_ext_y_array(ui_HistoryChart, ser, buffer);
+}
+
+void ui_create_history_chart(lv_obj_t *parent)
+{
+    const gauge_config_t *map_config = ui_gauges[UI_GAUGE_MAP].config;
+    const gauge_config_t *target_config = ui_gauges[UI_GAUGE_TARGET_BOOST].config;
+    const gauge_config_t *wastegate_config = ui_gauges[UI_GAUGE_WASTEGATE].config;
+
+    ui_HistoryPanel = lv_obj_create(parent);
+    lv_obj_set_width(ui_HistoryPanel, 370);
+    lv_obj_set_height(ui_HistoryPanel, 180);
+    lv_obj_clear_flag(ui_HistoryPanel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(ui_HistoryPanel, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_style_bg_color(ui_HistoryPanel, lv_color_hex(COLOR_CARD), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_all(ui_HistoryPanel, 6, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(ui_HistoryPanel, history_panel_event_cb, LV_EVENT_ALL, NULL);
+
+    lv_obj_t *title = lv_label_create(ui_HistoryPanel);
+    lv_obj_set_align(title, LV_ALIGN_TOP_LEFT);
+    lv_label_set_text_static(title, "Boost / Target / WG");
+    lv_obj_set_style_text_color(title, lv_color_hex(COLOR_TEXT_SECONDARY), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    history_tier_label = lv_label_create(ui_HistoryPanel);
+    lv_obj_set_align(history_tier_label, LV_ALIGN_TOP_RIGHT);
+    lv_label_set_text_static(history_tier_label, tier_names[history_tier]);
+    lv_obj_set_style_text_color(history_tier_label, lv_color_hex(COLOR_TEXT_SECONDARY), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    history_peak_label = lv_label_create(ui_HistoryPanel);
+    lv_obj_set_align(history_peak_label, LV_ALIGN_TOP_MID);
+    lv_obj_set_x(history_peak_label, 40);
+    lv_label_set_text_static(history_peak_label, "Peak --");
+    lv_obj_set_style_text_color(history_peak_label, lv_color_hex(map_config->color), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_HistoryChart = lv_chart_create(ui_HistoryPanel);
+    lv_obj_set_width(ui_HistoryChart, lv_pct(100));
+    lv_obj_set_height(ui_HistoryChart, lv_pct(85));
+    lv_obj_set_align(ui_HistoryChart, LV_ALIGN_BOTTOM_MID);
+    lv_obj_clear_flag(ui_HistoryChart, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(ui_HistoryChart, LV_OBJ_FLAG_EVENT_BUBBLE);
+    lv_chart_set_type(ui_HistoryChart, LV_CHART_TYPE_LINE);
+    lv_chart_set_div_line_count(ui_HistoryChart, 4, 0);
+    lv_chart_set_range(ui_HistoryChart, LV_CHART_AXIS_PRIMARY_Y,
+                       (lv_coord_t)(map_config->min_value * 10.0f), (lv_coord_t)(map_config->max_value * 10.0f));
+    lv_chart_set_range(ui_HistoryChart, LV_CHART_AXIS_SECONDARY_Y,
+                       (lv_coord_t)(wastegate_config->min_value * 10.0f), (lv_coord_t)(wastegate_config->max_value * 10.0f));
+    lv_obj_set_style_bg_opa(ui_HistoryChart, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(ui_HistoryChart, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_all(ui_HistoryChart, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_line_width(ui_HistoryChart, 2, LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_size(ui_HistoryChart, 0, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+
+    // Boost is drawn as a min/max envelope so decimated tiers keep their spikes
+    add_series(map_config->color, LV_CHART_AXIS_PRIMARY_Y, boost_max_points);
+    add_series(map_config->color, LV_CHART_AXIS_PRIMARY_Y, boost_min_points);
+    add_series(target_config->color, LV_CHART_AXIS_PRIMARY_Y, target_points);
+    add_series(wastegate_config->color, LV_CHART_AXIS_SECONDARY_Y, wastegate_points);
+
+    history_points = 0;
+    history_peak_shown = INT32_MIN;
+    lv_obj_update_layout(ui_HistoryPanel);
+    history_redraw();
+}
+
+void ui_history_set_tier(ecu_history_tier_t tier)
+{
+    history_tier = tier;
+    if (ui_HistoryChart == NULL) return;
+
+    lv_label_set_text_static(history_tier_label, tier_names[tier]);
+    history_redraw();
+}
+
+void ui_history_refresh(void)
+{
+    if (ui_HistoryChart == NULL || lv_obj_has_flag(ui_HistoryPanel, LV_OBJ_FLAG_HIDDEN)) return;
+    if (ecu_history_revision(history_tier) == history_drawn_revision) return;
+
+    history_redraw();
+}
+
+void ui_history_set_size(lv_coord_t width, lv_coord_t height)
+{
+    if (ui_HistoryPanel == NULL) return;
+
+    lv_obj_set_size(ui_HistoryPanel, width, height);
+    lv_obj_update_layout(ui_HistoryPanel);
+    history_redraw();
+}
@@ -0,0 +1,52 @@
+/**
+ * Boost history chart for the ECU Dashboard
+ * Plots boost (min/max envelope), target boost and wastegate from ecu_history
+ */
+
+#ifndef UI_HISTORY_H
+#define UI_HISTORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+#include "ecu_history.h"
+
+// Upper bound for plotted points; the chart uses min(content width, this)
+#define UI_HISTORY_MAX_POINTS   ECU_HISTORY_LEN
+
+extern lv_obj_t *ui_HistoryPanel;
+extern lv_obj_t *ui_HistoryChart;
+
+/**
+ * Create the history panel; tapping it cycles 10 s / 1 min / 10 min,
+ * a long press clears the peak boost hold
+ * @param parent Parent object (gauge grid)
+ */
+void ui_create_history_chart(lv_obj_t *parent);
+
+/**
+ * Select the displayed tier and redraw
+ * @param tier History tier
+ */
+void ui_history_set_tier(ecu_history_tier_t tier);
+
+/**
+ * Redraw the chart if the displayed tier has new buckets.
+ * Plots at most one point per pixel column, independent of history depth.
+ */
+void ui_history_refresh(void);
+
+/**
+ * Resize the history panel
+ * @param width Panel width in pixels
+ * @param height Panel height in pixels
+ */
+void ui_history_set_size(lv_coord_t width, lv_coord_t height);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // UI_HISTORY_H
@@ -15,12 +15,7 @@ lv_obj_t *ui_GaugeGrid;
 lv_obj_t *ui_StatusBanner;
 lv_obj_t *ui_ControlPanel;
 
-// Gauge objects
-lv_obj_t *ui_MapPressureGauge;
-lv_obj_t *ui_WastegateGauge;
-lv_obj_t *ui_TpsGauge;
-lv_obj_t *ui_RpmGauge;
-lv_obj_t *ui_TargetBoostGauge;
+// TCU status panel (numeric gauges live in the ui_gauges registry)
 lv_obj_t *ui_TcuStatusPanel;
 
 // Settings screen
@@ -30,13 +25,6 @@ lv_obj_t *ui_SizeSlider;
 lv_obj_t *ui_ColumnsSlider;
 lv_obj_t *ui_StyleDropdown;
 
-// Data display labels
-lv_obj_t *ui_MapValueLabel;
-lv_obj_t *ui_WastegateValueLabel;
-lv_obj_t *ui_TpsValueLabel;
-lv_obj_t *ui_RpmValueLabel;
-lv_obj_t *ui_TargetValueLabel;
-
 // Create main dashboard screen
 void ui_MainScreen_screen_init(void)
 {
@@ -93,13 +81,15 @@ void ui_MainScreen_screen_init(void)
     lv_obj_set_style_border_width(ui_GaugeGrid, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_pad_all(ui_GaugeGrid, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
 
-    // Create individual gauges
-    ui_create_map_pressure_gauge();
-    ui_create_wastegate_gauge();
-    ui_create_tps_gauge();
-    ui_create_rpm_gauge();
-    ui_create_target_boost_gauge();
+    // Create gauges from the registry
+    for (int i = 0; i < UI_GAUGE_COUNT; i++) {
+        ui_create_gauge(&ui_gauges[i]);
+    }
     ui_create_tcu_status_panel();
+    ui_gauges_invalidate();
+
+    // Boost / target / wastegate history
+    ui_create_history_chart(ui_GaugeGrid);
 
     // Control panel
     ui_ControlPanel = lv_obj_create(ui_MainScreen);
@@ -107,141 +97,114 @@ void ui_MainScreen_screen_init(void)
     lv_obj_set_height(ui_ControlPanel, 80);
     lv_obj_set_align(ui_ControlPanel, LV_ALIGN_BOTTOM_MID);
     lv_obj_set_style_bg_color(ui_ControlPanel, lv_color_hex(COLOR_CARD), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    // Bus diagnostics
+    lv_obj_t *diag_button = lv_btn_create(ui_ControlPanel);
+    lv_obj_set_size(diag_button, 140, 44);
+    lv_obj_set_align(diag_button, LV_ALIGN_RIGHT_MID);
+    lv_obj_add_event_cb(diag_button, ui_diagnostics_button_event_handler, LV_EVENT_CLICKED, NULL);
+    lv_obj_t *diag_label = lv_label_create(diag_button);
+    lv_label_set_text_static(diag_label, "Diagnostics");
+    lv_obj_center(diag_label);
 }
 
-// Create MAP pressure gauge
-void ui_create_map_pressure_gauge(void)
+// Create one registry gauge in the grid
+void ui_create_gauge(ui_gauge_t *gauge)
 {
-    ui_MapPressureGauge = lv_arc_create(ui_GaugeGrid);
-    lv_obj_set_width(ui_MapPressureGauge, 180);
-    lv_obj_set_height(ui_MapPressureGauge, 180);
-    lv_arc_set_range(ui_MapPressureGauge, 100, 250);
-    lv_arc_set_value(ui_MapPressureGauge, 100);
-    lv_arc_set_bg_angles(ui_MapPressureGauge, 135, 45);
-    lv_obj_set_style_arc_color(ui_MapPressureGauge, lv_color_hex(COLOR_ACCENT), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_arc_width(ui_MapPressureGauge, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_arc_width(ui_MapPressureGauge, 8, LV_PART_MAIN | LV_STATE_DEFAULT);
+    const gauge_config_t *config = gauge->config;
+
+    gauge->arc = lv_arc_create(ui_GaugeGrid);
+    lv_obj_set_width(gauge->arc, 180);
+    lv_obj_set_height(gauge->arc, 180);
+    lv_arc_set_range(gauge->arc, (int32_t)config->min_value, (int32_t)config->max_value);
+    lv_arc_set_value(gauge->arc, (int32_t)config->min_value);
+    lv_arc_set_bg_angles(gauge->arc, 135, 45);
+    lv_obj_set_style_arc_color(gauge->arc, lv_color_hex(config->color), LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    lv_obj_set_style_arc_width(gauge->arc, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    lv_obj_set_style_arc_width(gauge->arc, 8, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     // Value label
-    ui_MapValueLabel = lv_label_create(ui_MapPressureGauge);
-    lv_obj_set_width(ui_MapValueLabel, LV_SIZE_CONTENT);
-    lv_obj_set_height(ui_MapValueLabel, LV_SIZE_CONTENT);
-    lv_obj_set_align(ui_MapValueLabel, LV_ALIGN_CENTER);
-    lv_label_set_text(ui_MapValueLabel, "100.0");
-    lv_obj_set_style_text_color(ui_MapValueLabel, lv_color_hex(COLOR_ACCENT), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui_MapValueLabel, &lv_font_montserrat_32, LV_PART_MAIN | LV_STATE_DEFAULT);
+    gauge->value_label = lv_label_create(gauge->arc);
+    lv_obj_set_width(gauge->value_label, LV_SIZE_CONTENT);
+    lv_obj_set_height(gauge->value_label, LV_SIZE_CONTENT);
+    lv_obj_set_align(gauge->value_label, LV_ALIGN_CENTER);
+    lv_label_set_text(gauge->value_label, "");
+    lv_obj_set_style_text_color(gauge->value_label, lv_color_hex(config->color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(gauge->value_label, &lv_font_montserrat_32, LV_PART_MAIN | LV_STATE_DEFAULT);
 }
 
-// Create wastegate position gauge
-void ui_create_wastegate_gauge(void)
+// Create TCU status panel
+void ui_create_tcu_status_panel(void)
 {
-    ui_WastegateGauge = lv_arc_create(ui_GaugeGrid);
-    lv_obj_set_width(ui_WastegateGauge, 180);
-    lv_obj_set_height(ui_WastegateGauge, 180);
-    lv_arc_set_range(ui_WastegateGauge, 0, 100);
-    lv_arc_set_value(ui_WastegateGauge, 50);
-    lv_arc_set_bg_angles(ui_WastegateGauge, 135, 45);
-    lv_obj_set_style_arc_color(ui_WastegateGauge, lv_color_hex(COLOR_SUCCESS), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_arc_width(ui_WastegateGauge, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_arc_width(ui_WastegateGauge, 8, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-    // Value label
-    ui_WastegateValueLabel = lv_label_create(ui_WastegateGauge);
-    lv_obj_set_width(ui_WastegateValueLabel, LV_SIZE_CONTENT);
-    lv_obj_set_height(ui_WastegateValueLabel, LV_SIZE_CONTENT);
-    lv_obj_set_align(ui_WastegateValueLabel, LV_ALIGN_CENTER);
-    lv_label_set_text(ui_WastegateValueLabel, "50.0");
-    lv_obj_set_style_text_color(ui_WastegateValueLabel, lv_color_hex(COLOR_SUCCESS), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui_WastegateValueLabel, &lv_font_montserrat_32, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_TcuStatusPanel = lv_obj_create(ui_GaugeGrid);
+    lv_obj_set_width(ui_TcuStatusPanel, 180);
+    lv_obj_set_height(ui_TcuStatusPanel, 180);
+    lv_obj_set_style_bg_color(ui_TcuStatusPanel, lv_color_hex(COLOR_CARD), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(ui_TcuStatusPanel, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_color(ui_TcuStatusPanel, lv_color_hex(COLOR_SUCCESS), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_radius(ui_TcuStatusPanel, 90, LV_PART_MAIN | LV_STATE_DEFAULT);
 }
 
-// Create TPS gauge
-void ui_create_tps_gauge(void)
+// Bytes currently allocated from the LVGL heap (LV_MEM_SIZE)
+uint32_t ui_lvgl_heap_used(void)
 {
-    ui_TpsGauge = lv_arc_create(ui_GaugeGrid);
-    lv_obj_set_width(ui_TpsGauge, 180);
-    lv_obj_set_height(ui_TpsGauge, 180);
-    lv_arc_set_range(ui_TpsGauge, 0, 100);
-    lv_arc_set_value(ui_TpsGauge, 0);
-    lv_arc_set_bg_angles(ui_TpsGauge, 135, 45);
-    lv_obj_set_style_arc_color(ui_TpsGauge, lv_color_hex(COLOR_YELLOW), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_arc_width(ui_TpsGauge, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_arc_width(ui_TpsGauge, 8, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-    // Value label
-    ui_TpsValueLabel = lv_label_create(ui_TpsGauge);
-    lv_obj_set_width(ui_TpsValueLabel, LV_SIZE_CONTENT);
-    lv_obj_set_height(ui_TpsValueLabel, LV_SIZE_CONTENT);
-    lv_obj_set_align(ui_TpsValueLabel, LV_ALIGN_CENTER);
-    lv_label_set_text(ui_TpsValueLabel, "0.0");
-    lv_obj_set_style_text_color(ui_TpsValueLabel, lv_color_hex(COLOR_YELLOW), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui_TpsValueLabel, &lv_font_montserrat_32, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
 }
 
-// Create RPM gauge
-void ui_create_rpm_gauge(void)
+// Deferred delete of an unloaded screen; runs outside the screen's own event
+static void ui_screen_delete_async_cb(void *screen)
 {
-    ui_RpmGauge = lv_arc_create(ui_GaugeGrid);
-    lv_obj_set_width(ui_RpmGauge, 180);
-    lv_obj_set_height(ui_RpmGauge, 180);
-    lv_arc_set_range(ui_RpmGauge, 0, 7000);
-    lv_arc_set_value(ui_RpmGauge, 800);
-    lv_arc_set_bg_angles(ui_RpmGauge, 135, 45);
-    lv_obj_set_style_arc_color(ui_RpmGauge, lv_color_hex(COLOR_WARNING), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_arc_width(ui_RpmGauge, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_arc_width(ui_RpmGauge, 8, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-    // Value label
-    ui_RpmValueLabel = lv_label_create(ui_RpmGauge);
-    lv_obj_set_width(ui_RpmValueLabel, LV_SIZE_CONTENT);
-    lv_obj_set_height(ui_RpmValueLabel, LV_SIZE_CONTENT);
-    lv_obj_set_align(ui_RpmValueLabel, LV_ALIGN_CENTER);
-    lv_label_set_text(ui_RpmValueLabel, "800");
-    lv_obj_set_style_text_color(ui_RpmValueLabel, lv_color_hex(COLOR_WARNING), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui_RpmValueLabel, &lv_font_montserrat_32, LV_PART_MAIN | LV_STATE_DEFAULT);
+    uint32_t used_before = ui_lvgl_heap_used();
+    lv_obj_del((lv_obj_t *)screen);
+    LV_LOG_USER("screen deleted, LVGL heap used %u -> %u bytes",
+                (unsigned)used_before, (unsigned)ui_lvgl_heap_used());
 }
 
-// Create target boost gauge
-void ui_create_target_boost_gauge(void)
+// LV_EVENT_SCREEN_UNLOADED: drop the handle now, free the objects on the next timer run
+static void ui_screen_unloaded_delete_cb(lv_event_t *e)
 {
-    ui_TargetBoostGauge = lv_arc_create(ui_GaugeGrid);
-    lv_obj_set_width(ui_TargetBoostGauge, 180);
-    lv_obj_set_height(ui_TargetBoostGauge, 180);
-    lv_arc_set_range(ui_TargetBoostGauge, 100, 250);
-    lv_arc_set_value(ui_TargetBoostGauge, 120);
-    lv_arc_set_bg_angles(ui_TargetBoostGauge, 135, 45);
-    lv_obj_set_style_arc_color(ui_TargetBoostGauge, lv_color_hex(COLOR_YELLOW), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_arc_width(ui_TargetBoostGauge, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_arc_width(ui_TargetBoostGauge, 8, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_t **screen = lv_event_get_user_data(e);
+    if (*screen == NULL) {
+        return;
+    }
+    lv_async_call(ui_screen_delete_async_cb, *screen);
+    *screen = NULL;
+}
 
-    // Value label
-    ui_TargetValueLabel = lv_label_create(ui_TargetBoostGauge);
-    lv_obj_set_width(ui_TargetValueLabel, LV_SIZE_CONTENT);
-    lv_obj_set_height(ui_TargetValueLabel, LV_SIZE_CONTENT);
-    lv_obj_set_align(ui_TargetValueLabel, LV_ALIGN_CENTER);
-    lv_label_set_text(ui_TargetValueLabel, "120.0");
-    lv_obj_set_style_text_color(ui_TargetValueLabel, lv_color_hex(COLOR_YELLOW), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui_TargetValueLabel, &lv_font_montserrat_32, LV_PART_MAIN | LV_STATE_DEFAULT);
+// Load a secondary screen, creating it first if it is not resident.
+// Screens created this way delete themselves once they are unloaded.
+void ui_screen_load_lazy(lv_obj_t **screen, void (*screen_init)(void),
+                         lv_scr_load_anim_t anim, uint32_t time)
+{
+    if (*screen == NULL) {
+        uint32_t used_before = ui_lvgl_heap_used();
+        screen_init();
+        lv_obj_add_event_cb(*screen, ui_screen_unloaded_delete_cb, LV_EVENT_SCREEN_UNLOADED, screen);
+        LV_LOG_USER("screen created, LVGL heap used %u -> %u bytes",
+                    (unsigned)used_before, (unsigned)ui_lvgl_heap_used());
+    }
+    lv_scr_load_anim(*screen, anim, time, 0, false);
 }
 
-// Create TCU status panel
-void ui_create_tcu_status_panel(void)
+// Clear settings widget handles when the screen goes away
+static void ui_SettingsScreen_delete_cb(lv_event_t *e)
 {
-    ui_TcuStatusPanel = lv_obj_create(ui_GaugeGrid);
-    lv_obj_set_width(ui_TcuStatusPanel, 180);
-    lv_obj_set_height(ui_TcuStatusPanel, 180);
-    lv_obj_set_style_bg_color(ui_TcuStatusPanel, lv_color_hex(COLOR_CARD), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_width(ui_TcuStatusPanel, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_TcuStatusPanel, lv_color_hex(COLOR_SUCCESS), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui_TcuStatusPanel, 90, LV_PART_MAIN | LV_STATE_DEFAULT);
+    LV_UNUSED(e);
+    ui_SettingsPanel = NULL;
+    ui_SizeSlider = NULL;
+    ui_ColumnsSlider = NULL;
+    ui_StyleDropdown = NULL;
 }
 
-// Settings screen initialization
+// Settings screen initialization (created on demand via ui_screen_load_lazy)
 void ui_SettingsScreen_screen_init(void)
 {
     ui_SettingsScreen = lv_obj_create(NULL);
     lv_obj_clear_flag(ui_SettingsScreen, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_set_style_bg_color(ui_SettingsScreen, lv_color_hex(COLOR_BACKGROUND), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(ui_SettingsScreen, ui_SettingsScreen_delete_cb, LV_EVENT_DELETE, NULL);
 
     ui_SettingsPanel = lv_obj_create(ui_SettingsScreen);
     lv_obj_set_width(ui_SettingsPanel, lv_pct(90));
@@ -250,10 +213,10 @@ void ui_SettingsScreen_screen_init(void)
     lv_obj_set_style_bg_color(ui_SettingsPanel, lv_color_hex(COLOR_CARD), LV_PART_MAIN | LV_STATE_DEFAULT);
 }
 
-// Initialize all screens
+// Initialize the main screen; secondary screens are created when first shown
 void ui_init(void)
 {
     ui_MainScreen_screen_init();
-    ui_SettingsScreen_screen_init();
     lv_disp_load_scr(ui_MainScreen);
+    LV_LOG_USER("main screen ready, LVGL heap used %u bytes", (unsigned)ui_lvgl_heap_used());
 }
\ No newline at end of file